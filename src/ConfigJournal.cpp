@@ -0,0 +1,494 @@
+#include "ConfigJournal.h"
+#include <LittleFS.h>
+#include "SlaveTable.h"
+#include "RegisterMap.h"
+#include "ReadPlanner.h"
+#include "ResultPublisher.h"
+#include "Logger.h"
+
+#define JOURNAL_HEADER_SIZE 8
+#define JOURNAL_RECORD_OVERHEAD 5    // type, length, CRC
+
+#define RECORD_BUS 1
+#define RECORD_PUBLISH 2
+#define RECORD_SLAVE 3
+#define RECORD_DELETE 4
+
+JournalStats journalStats;
+
+static const uint8_t journalHeader[JOURNAL_HEADER_SIZE] = {'M', 'B', 'C', 'J', JOURNAL_VERSION, 0, 0, 0};
+
+// What the journal on flash currently says, to find what a save must append.
+// Records are compared by a 32-bit hash of their bytes, not their CRC-16,
+// so an edit is only missed if it collides in 32 bits.
+static bool busSaved = false;
+static uint32_t busHash = 0;
+static bool publishSaved = false;
+static uint32_t publishHash = 0;
+static uint8_t savedIds[(SLAVE_ID_MAX + 8) / 8];  // slaves with a live record; their hash is in journalHash
+
+static bool idSaved(uint8_t id) {
+  return savedIds[id >> 3] & (1 << (id & 7));
+}
+
+static void markSaved(uint8_t id, bool saved) {
+  if (saved) savedIds[id >> 3] |= 1 << (id & 7);
+  else savedIds[id >> 3] &= ~(1 << (id & 7));
+}
+
+// ----------------- Record writer -----------------
+
+// One record at a time: type and length up front, CRC appended by finishRecord()
+static uint8_t record[JOURNAL_MAX_RECORD];
+static uint16_t recordLen = 0;
+static bool recordOverflow = false;
+
+static void put8(uint8_t v) {
+  if (recordLen < JOURNAL_MAX_RECORD - 2) record[recordLen++] = v;
+  else recordOverflow = true;
+}
+
+static void put16(uint16_t v) {
+  put8(v & 0xFF);
+  put8(v >> 8);
+}
+
+static void put32(uint32_t v) {
+  put16(v & 0xFFFF);
+  put16(v >> 16);
+}
+
+static void putString(const char* s) {
+  uint8_t len = min(strlen(s), (size_t)255);
+  put8(len);
+  for (uint8_t i = 0; i < len; i++) put8(s[i]);
+}
+
+static void startRecord(uint8_t type) {
+  recordLen = 0;
+  recordOverflow = false;
+  put8(type);
+  put16(0);  // length, filled in by finishRecord()
+}
+
+// FNV-1a over a record without its CRC: what journalSave() compares
+static uint32_t recordHash(const uint8_t* p, uint16_t len) {
+  uint32_t hash = 2166136261UL;
+  while (len--) hash = (hash ^ *p++) * 16777619UL;
+  return hash;
+}
+
+// Returns the record's hash; recordLen then covers the whole record
+static uint32_t finishRecord() {
+  uint16_t payload = recordLen - 3;
+  record[1] = payload & 0xFF;
+  record[2] = payload >> 8;
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < recordLen; i++) crc = crc16Update(crc, record[i]);
+  uint32_t hash = recordHash(record, recordLen);
+  record[recordLen++] = crc & 0xFF;
+  record[recordLen++] = crc >> 8;
+  return hash;
+}
+
+static uint32_t encodeBus() {
+  startRecord(RECORD_BUS);
+  put32(busConfig.baud);
+  put8(busConfig.parity);
+  put8(busConfig.stopBits);
+  put16(busConfig.turnaroundMs);
+  return finishRecord();
+}
+
+static uint32_t encodePublish() {
+  startRecord(RECORD_PUBLISH);
+  put8(publishConfig.perSlave);
+  put8(publishConfig.format);
+  put32(publishConfig.heartbeatMs);
+  put8(publishConfig.batchCount);
+  put32(publishConfig.batchMs);
+  put16(publishConfig.batchBytes);
+  putString(publishConfig.prefix);
+  put32(publishConfig.statsMs);
+  return finishRecord();
+}
+
+static uint32_t encodeSlave(const ModbusSlave& slave) {
+  startRecord(RECORD_SLAVE);
+  put8(slave.id);
+  putString(slaveName(slave));
+  put16(slave.startReg);
+  put16(slave.numRegs);
+  put8(slave.maxGap);
+  put32(slave.pollMs);
+  put16(slave.deadband);
+  put8(slave.deadbandPct);
+
+  put8(slave.extraRangeCount);
+  for (uint8_t r = 0; r < slave.extraRangeCount; r++) {
+    put16(slave.extraRanges[r].start);
+    put16(slave.extraRanges[r].count);
+  }
+  const RegDeadband* overrides = slaveDeadbands(slave);
+  put8(slave.regDeadbandCount);
+  for (uint8_t i = 0; i < slave.regDeadbandCount; i++) {
+    put16(overrides[i].reg);
+    put16(overrides[i].absolute);
+    put8(overrides[i].percent);
+  }
+  const RegField* fields = slaveFields(slave);
+  put8(slave.fieldCount);
+  for (uint8_t i = 0; i < slave.fieldCount; i++) {
+    uint32_t offset;
+    uint64_t scale;
+    memcpy(&offset, &fields[i].offset, sizeof(offset));
+    memcpy(&scale, &fields[i].scale, sizeof(scale));
+    put16(fields[i].reg);
+    put8(fields[i].type);
+    put8(fields[i].decimals);
+    put32(offset);
+    put32(scale & 0xFFFFFFFF);
+    put32(scale >> 32);
+    putString(fieldName(fields[i].name));
+  }
+  put32(slave.cacheMs);
+  put8(slave.fixedRate);
+  put32(slave.windowMs);
+  put8(slave.windowRaw);
+  return finishRecord();
+}
+
+static uint32_t encodeDelete(uint8_t id) {
+  startRecord(RECORD_DELETE);
+  put8(id);
+  return finishRecord();
+}
+
+// ----------------- Record reader -----------------
+
+static const uint8_t* readPos = nullptr;
+static uint16_t readLeft = 0;
+static bool readOk = true;
+
+static uint8_t get8() {
+  if (!readLeft) {
+    readOk = false;
+    return 0;
+  }
+  readLeft--;
+  return *readPos++;
+}
+
+static uint16_t get16() {
+  uint16_t lo = get8();
+  return lo | get8() << 8;
+}
+
+static uint32_t get32() {
+  uint32_t lo = get16();
+  return lo | (uint32_t)get16() << 16;
+}
+
+static void getString(char* out, uint8_t size) {
+  uint8_t len = get8();
+  for (uint8_t i = 0; i < len; i++) {
+    char c = get8();
+    if (i < size - 1) out[i] = c;
+  }
+  out[min(len, (uint8_t)(size - 1))] = '\0';
+}
+
+static bool applyBus() {
+  BusConfig bus;
+  bus.baud = get32();
+  bus.parity = get8();
+  bus.stopBits = get8();
+  bus.turnaroundMs = get16();
+  return readOk && applyBusConfig(bus);
+}
+
+static bool applyPublish() {
+  PublishConfig pub;
+  pub.perSlave = get8();
+  pub.format = get8();
+  pub.heartbeatMs = get32();
+  pub.batchCount = get8();
+  pub.batchMs = get32();
+  pub.batchBytes = get16();
+  getString(pub.prefix, sizeof(pub.prefix));
+  if (readLeft) pub.statsMs = get32();  // newer fields go last, older records just lack them
+  if (!readOk) return false;
+  publishConfig = pub;
+  return true;
+}
+
+// Replaces any slave with the same ID; returns the slave, nullptr if the
+// record doesn't fit this build's limits
+static ModbusSlave* applySlave() {
+  uint8_t id = get8();
+  char name[SLAVE_NAME_MAX + 1];
+  getString(name, sizeof(name));
+  if (!readOk) return nullptr;
+  removeSlave(id);
+  ModbusSlave* slave = nullptr;
+  if (addSlave(id, name, slave) != SLAVE_OK) return nullptr;
+
+  slave->startReg = get16();
+  slave->numRegs = get16();
+  slave->maxGap = get8();
+  slave->pollMs = max(get32(), (uint32_t)MIN_POLL_MS);
+  slaveSchedule(*slave).nextPollDue = millis();
+  slave->deadband = get16();
+  slave->deadbandPct = get8();
+
+  bool ok = true;
+  uint8_t ranges = get8();
+  for (uint8_t r = 0; r < ranges; r++) {
+    RegRange range = {get16(), get16()};
+    if (r >= MAX_EXTRA_RANGES) {
+      ok = false;
+      continue;
+    }
+    slave->extraRanges[slave->extraRangeCount++] = range;
+  }
+  ok = ok && slaveRangesValid(*slave) && allocSlaveImages(*slave);  // same checks as /addSlave
+
+  RegDeadband overrides[MAX_DEADBAND_OVERRIDES];
+  uint8_t overrideCount = get8();
+  for (uint8_t i = 0; i < overrideCount; i++) {
+    RegDeadband d = {get16(), get16(), get8()};
+    if (i < MAX_DEADBAND_OVERRIDES) overrides[i] = d;
+  }
+  ok = ok && overrideCount <= MAX_DEADBAND_OVERRIDES && setSlaveDeadbands(*slave, overrides, overrideCount);
+
+  RegField fields[MAX_FIELDS_PER_SLAVE];
+  uint8_t fieldCount = get8();
+  for (uint8_t i = 0; i < fieldCount; i++) {
+    RegField f = {};
+    f.reg = get16();
+    f.type = get8();
+    f.decimals = get8();
+    uint32_t offset = get32();
+    uint64_t scale = get32();
+    scale |= (uint64_t)get32() << 32;
+    memcpy(&f.offset, &offset, sizeof(f.offset));
+    memcpy(&f.scale, &scale, sizeof(f.scale));
+    char fieldNameText[FIELD_NAME_MAX + 1];
+    getString(fieldNameText, sizeof(fieldNameText));
+    f.name = internFieldName(fieldNameText);
+    if (i < MAX_FIELDS_PER_SLAVE) fields[i] = f;
+    if (f.name == FIELD_NAME_NONE) ok = false;
+  }
+  ok = ok && fieldCount <= MAX_FIELDS_PER_SLAVE && setSlaveFields(*slave, fields, fieldCount) &&
+       compileRegisterMap(*slave);
+  if (readLeft) slave->cacheMs = get32();
+  if (readLeft) slave->fixedRate = get8();
+  if (readLeft) slave->windowMs = get32();
+  if (readLeft) slave->windowRaw = get8();
+  ok = ok && allocSlaveWindows(*slave);
+
+  if (!ok || !readOk) {
+    removeSlave(id);
+    return nullptr;
+  }
+  return slave;
+}
+
+// ----------------- Loading -----------------
+
+static bool compactJournal();
+
+// Replays /config.jnl into the slave table; false if there is no usable
+// journal (the table is then left alone)
+bool journalLoad() {
+  File file = LittleFS.open(JOURNAL_PATH, "r");
+  if (!file) return false;
+  uint8_t header[JOURNAL_HEADER_SIZE];
+  if (file.read(header, sizeof(header)) != sizeof(header) || memcmp(header, journalHeader, 4) != 0 ||
+      header[4] != JOURNAL_VERSION) {
+    LOG_WARN("⚠️ %s has an unknown format, ignoring it", JOURNAL_PATH);
+    file.close();
+    return false;
+  }
+
+  unsigned long started = millis();
+  clearSlaves();
+  busSaved = publishSaved = false;
+  memset(savedIds, 0, sizeof(savedIds));
+
+  uint32_t fileSize = file.size();
+  uint32_t validEnd = JOURNAL_HEADER_SIZE;
+  uint16_t records = 0, skipped = 0;
+  while (validEnd + JOURNAL_RECORD_OVERHEAD <= fileSize) {
+    if (file.read(record, 3) != 3) break;
+    uint16_t payload = record[1] | record[2] << 8;
+    recordLen = 3 + payload + 2;
+    if (recordLen > JOURNAL_MAX_RECORD || file.read(record + 3, payload + 2) != payload + 2) break;
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < 3 + payload; i++) crc = crc16Update(crc, record[i]);
+    if (crc != (record[3 + payload] | record[4 + payload] << 8)) break;
+
+    readPos = record + 3;
+    readLeft = payload;
+    readOk = true;
+    switch (record[0]) {
+      case RECORD_BUS:
+        busSaved = applyBus();
+        busHash = recordHash(record, 3 + payload);
+        break;
+      case RECORD_PUBLISH:
+        publishSaved = applyPublish();
+        publishHash = recordHash(record, 3 + payload);
+        break;
+      case RECORD_SLAVE: {
+        uint8_t id = record[3];
+        ModbusSlave* slave = applySlave();
+        if (slave) slave->journalHash = recordHash(record, 3 + payload);
+        else skipped++;
+        markSaved(id, slave != nullptr);
+        break;
+      }
+      case RECORD_DELETE:
+        removeSlave(get8());
+        markSaved(record[3], false);
+        break;
+      default:
+        skipped++;  // from a newer build
+        break;
+    }
+    validEnd += recordLen;
+    records++;
+  }
+  file.close();
+  journalStats.bytes = validEnd;
+
+  LOG_INFO("✅ Config journal: %u records, %u slaves in %lu ms", records, slaveCount, millis() - started);
+  if (skipped) LOG_WARN("⚠️ %u journal record(s) didn't fit and were skipped", skipped);
+  if (validEnd < fileSize) {
+    // Appending after the torn record would hide everything written later
+    LOG_WARN("⚠️ Config journal damaged after %lu bytes, rewriting it", (unsigned long)validEnd);
+    compactJournal();
+  }
+  return true;
+}
+
+// ----------------- Saving -----------------
+
+static bool writeRecord(File& file) {
+  return !recordOverflow && file.write(record, recordLen) == recordLen;
+}
+
+// Whole configuration into a new file, renamed over the journal once complete
+static bool compactJournal() {
+  File file = LittleFS.open(JOURNAL_TMP_PATH, "w");
+  bool ok = (bool)file && file.write(journalHeader, sizeof(journalHeader)) == sizeof(journalHeader);
+  uint32_t size = JOURNAL_HEADER_SIZE;
+
+  uint32_t hash = encodeBus();
+  ok = ok && writeRecord(file);
+  size += recordLen;
+  uint32_t pubHash = encodePublish();
+  ok = ok && writeRecord(file);
+  size += recordLen;
+  for (uint8_t i = 0; i < slaveCount && ok; i++) {
+    slaves[i].journalHash = encodeSlave(slaves[i]);
+    ok = writeRecord(file);
+    size += recordLen;
+  }
+  if (file) file.close();
+  if (!ok || !LittleFS.rename(JOURNAL_TMP_PATH, JOURNAL_PATH)) {
+    LOG_ERROR("❌ Failed to write the config journal");
+    LittleFS.remove(JOURNAL_TMP_PATH);
+    return false;
+  }
+
+  busSaved = publishSaved = true;
+  busHash = hash;
+  publishHash = pubHash;
+  memset(savedIds, 0, sizeof(savedIds));
+  for (uint8_t i = 0; i < slaveCount; i++) markSaved(slaves[i].id, true);
+  journalStats.bytes = size;
+  journalStats.compactions++;
+  LOG_INFO("💾 Config journal rewritten: %u slaves, %lu bytes", slaveCount, (unsigned long)size);
+  return true;
+}
+
+// Appends a record for every setting that differs from the journal, or
+// rewrites the journal when that's the better deal
+bool journalSave() {
+  if (!LittleFS.exists(JOURNAL_PATH)) return compactJournal();
+
+  // Size up the changes first
+  uint32_t live = 0, changed = 0;
+  uint32_t hash = encodeBus();
+  live += recordLen;
+  if (!busSaved || hash != busHash) changed += recordLen;
+  hash = encodePublish();
+  live += recordLen;
+  if (!publishSaved || hash != publishHash) changed += recordLen;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    hash = encodeSlave(slaves[i]);
+    live += recordLen;
+    if (!idSaved(slaves[i].id) || hash != slaves[i].journalHash) changed += recordLen;
+  }
+  for (uint16_t id = SLAVE_ID_MIN; id <= SLAVE_ID_MAX; id++) {
+    if (idSaved(id) && !findSlaveById(id)) changed += JOURNAL_RECORD_OVERHEAD + 1;
+  }
+
+  if (changed == 0) {
+    LOG_INFO("💾 Config unchanged, nothing to save");
+    return true;
+  }
+  uint32_t after = journalStats.bytes + changed;
+  if (after > JOURNAL_COMPACT_BYTES && after > 2 * (live + JOURNAL_HEADER_SIZE)) return compactJournal();
+
+  File file = LittleFS.open(JOURNAL_PATH, "a");
+  if (!file) {
+    LOG_ERROR("❌ Failed to open the config journal");
+    return false;
+  }
+  bool ok = true;
+  uint16_t appended = 0;
+  hash = encodeBus();
+  if (!busSaved || hash != busHash) {
+    ok = ok && writeRecord(file);
+    busSaved = ok;
+    busHash = hash;
+    appended++;
+  }
+  hash = encodePublish();
+  if (ok && (!publishSaved || hash != publishHash)) {
+    ok = writeRecord(file);
+    publishSaved = ok;
+    publishHash = hash;
+    appended++;
+  }
+  for (uint8_t i = 0; i < slaveCount && ok; i++) {
+    hash = encodeSlave(slaves[i]);
+    if (idSaved(slaves[i].id) && hash == slaves[i].journalHash) continue;
+    ok = writeRecord(file);
+    markSaved(slaves[i].id, ok);
+    slaves[i].journalHash = hash;
+    appended++;
+  }
+  for (uint16_t id = SLAVE_ID_MIN; id <= SLAVE_ID_MAX && ok; id++) {
+    if (!idSaved(id) || findSlaveById(id)) continue;
+    encodeDelete(id);
+    ok = writeRecord(file);
+    markSaved(id, !ok);
+    appended++;
+  }
+  file.close();
+
+  if (!ok) {
+    // Whatever did reach flash is a CRC-checked prefix; the next boot replays it
+    LOG_ERROR("❌ Config journal append failed");
+    return false;
+  }
+  journalStats.bytes += changed;
+  journalStats.appends += appended;
+  journalStats.appendedBytes += changed;
+  LOG_INFO("💾 Config saved: %u record(s), %lu bytes appended (journal %lu bytes)", appended,
+           (unsigned long)changed, (unsigned long)journalStats.bytes);
+  return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Configuration on flash as an append-only binary journal, /config.jnl:
+//   header  "MBCJ", version, 3 reserved bytes
+//   record  type, payload length (2, LE), payload, CRC-16/MODBUS of all three
+// A record holds the bus settings, the publish settings, one whole slave
+// (replacing any earlier record for its ID) or a slave deletion. A save
+// appends only what changed since the last one. Once the journal passes
+// JOURNAL_COMPACT_BYTES and is mostly superseded records, it is rewritten as
+// a snapshot into /config.tmp and renamed over the old one.
+// Boot replays the records straight into the slave table, no JSON involved.
+// A record torn by a power cut fails its CRC: replay stops there and the
+// journal is rewritten from what came before.
+
+#define JOURNAL_PATH "/config.jnl"
+#define JOURNAL_TMP_PATH "/config.tmp"
+#define JOURNAL_VERSION 1
+#define JOURNAL_COMPACT_BYTES 16384UL
+#define JOURNAL_MAX_RECORD 1024      // a slave with a full register map is ~750 bytes
+
+struct JournalStats {
+  uint32_t bytes;          // current journal size
+  uint32_t appends;        // records appended by saves
+  uint32_t appendedBytes;
+  uint32_t compactions;
+};
+
+extern JournalStats journalStats;
+
+// Function declarations
+bool journalLoad();
+bool journalSave();
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Thin hardware layer for the polling path. The device build maps these onto
+// Serial / millis() (HalEsp8266.cpp); [env:native] maps them onto a virtual
+// clock and the simulated RS485 bus in src/native/. Filesystem and network
+// code keeps using the LittleFS / ESP8266WebServer / PubSubClient APIs, which
+// the native build replaces with host versions under src/native/include/,
+// apart from the lookup and connect the MQTT reconnect uses to never block.
+
+// ----------------- Clock -----------------
+uint32_t halMillis();
+uint32_t halMicros();
+void halDelayMicros(uint32_t us);       // busy-waits; only for waits well under a loop pass
+
+// ----------------- Wall clock -----------------
+// SNTP keeps it set in the background; 0 means not synced since boot
+#define HAL_EPOCH_VALID_S 1600000000UL  // anything earlier is the clock counting from 1970
+void halClockBegin(const char* ntpServer);
+uint64_t halEpochMillis();              // ms since 1970-01-01 UTC
+
+// ----------------- RS485 bus UART -----------------
+void halBusBegin(uint32_t baud, uint8_t config, uint8_t dePin);
+int halBusAvailable();
+int halBusRead();
+size_t halBusWrite(const uint8_t* data, size_t len);
+int halBusAvailableForWrite();          // free TX FIFO space
+int halBusTxQueued();                   // bytes still in the TX FIFO, not counting the shift register
+void halBusSetTransmit(bool transmit);  // drive DE/RE
+
+// ----------------- Network -----------------
+// Name lookup and a TCP connect that never wait: start, then poll from
+// loop() until the answer is HAL_DONE or HAL_FAILED. One of each at a time.
+// A finished connect is handed to a WiFiClient with halConnectTake().
+#define HAL_PENDING 0
+#define HAL_DONE    1
+#define HAL_FAILED  2
+
+class WiFiClient;
+
+uint8_t halResolveStart(const char* host, uint32_t& ip);  // HAL_DONE at once for literals and cached names
+uint8_t halResolvePoll(uint32_t& ip);
+void halResolveCancel();
+uint8_t halConnectStart(uint32_t ip, uint16_t port);
+uint8_t halConnectPoll();
+void halConnectCancel();
+bool halConnectTake(WiFiClient& client);  // after HAL_DONE; false if the connection is gone
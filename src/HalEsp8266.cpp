@@ -0,0 +1,130 @@
+#include "Hal.h"
+#include <Arduino.h>
+#include <lwip/dns.h>
+#include <lwip/tcp.h>
+#include <WiFiClient.h>
+#include <include/ClientContext.h>
+#include <time.h>
+#include <sys/time.h>
+
+// Device implementation of Hal.h: the RS485 transceiver hangs off Serial
+static uint8_t busDePin = 0;
+
+uint32_t halMillis() { return millis(); }
+uint32_t halMicros() { return micros(); }
+void halDelayMicros(uint32_t us) { delayMicroseconds(us); }
+
+// UTC, no DST: readings carry epoch milliseconds
+void halClockBegin(const char* ntpServer) { configTime(0, 0, ntpServer); }
+
+uint64_t halEpochMillis() {
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  if ((uint32_t)tv.tv_sec < HAL_EPOCH_VALID_S) return 0;
+  return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+void halBusBegin(uint32_t baud, uint8_t config, uint8_t dePin) {
+  busDePin = dePin;
+  pinMode(busDePin, OUTPUT);
+  digitalWrite(busDePin, LOW);
+  Serial.begin(baud, (SerialConfig)config);
+}
+
+int halBusAvailable() { return Serial.available(); }
+int halBusRead() { return Serial.read(); }
+size_t halBusWrite(const uint8_t* data, size_t len) { return Serial.write(data, len); }
+int halBusAvailableForWrite() { return Serial.availableForWrite(); }
+int halBusTxQueued() { return (USS(0) >> USTXC) & 0xFF; }  // UART0 status: TX FIFO count
+void halBusSetTransmit(bool transmit) { digitalWrite(busDePin, transmit ? HIGH : LOW); }
+
+// ----------------- Network -----------------
+// lwIP raw API. Its callbacks run between loop() passes and only set flags.
+static volatile uint8_t resolveState = HAL_FAILED;
+static uint32_t resolvedIp = 0;
+static uint8_t resolveGeneration = 0;  // a lookup can't be cancelled, only ignored
+static tcp_pcb* probePcb = nullptr;
+static volatile uint8_t connectState = HAL_FAILED;
+
+static void resolveFound(const char*, const ip_addr_t* addr, void* arg) {
+  if ((uintptr_t)arg != resolveGeneration) return;
+  if (addr) resolvedIp = ip_addr_get_ip4_u32(addr);
+  resolveState = addr ? HAL_DONE : HAL_FAILED;
+}
+
+uint8_t halResolveStart(const char* host, uint32_t& ip) {
+  ip_addr_t addr;
+  resolveGeneration++;
+  err_t err = dns_gethostbyname(host, &addr, resolveFound, (void*)(uintptr_t)resolveGeneration);
+  if (err == ERR_OK) {
+    ip = ip_addr_get_ip4_u32(&addr);
+    return resolveState = HAL_DONE;
+  }
+  return resolveState = err == ERR_INPROGRESS ? HAL_PENDING : HAL_FAILED;
+}
+
+uint8_t halResolvePoll(uint32_t& ip) {
+  if (resolveState == HAL_DONE) ip = resolvedIp;
+  return resolveState;
+}
+
+void halResolveCancel() {
+  resolveGeneration++;
+  resolveState = HAL_FAILED;
+}
+
+// Connected: the pcb waits here until halConnectTake() wraps it
+static err_t probeConnected(void*, tcp_pcb*, err_t) {
+  connectState = HAL_DONE;
+  return ERR_OK;
+}
+
+// Nothing reads before the hand-over; lwIP offers refused data again later
+static err_t probeReceived(void*, tcp_pcb*, pbuf* p, err_t) {
+  return p ? ERR_MEM : ERR_OK;
+}
+
+// Refused, unreachable or reset; lwIP has already freed the pcb
+static void probeFailed(void*, err_t) {
+  probePcb = nullptr;
+  connectState = HAL_FAILED;
+}
+
+// WiFiClient only wraps an existing ClientContext for WiFiServer
+struct ConnectedClient : WiFiClient {
+  explicit ConnectedClient(ClientContext* context) : WiFiClient(context) {}
+};
+
+uint8_t halConnectStart(uint32_t ip, uint16_t port) {
+  halConnectCancel();
+  probePcb = tcp_new();
+  if (!probePcb) return connectState;
+  ip_addr_t addr;
+  ip_addr_set_ip4_u32(&addr, ip);
+  tcp_err(probePcb, probeFailed);
+  tcp_recv(probePcb, probeReceived);
+  connectState = HAL_PENDING;
+  if (tcp_connect(probePcb, &addr, port, probeConnected) != ERR_OK) halConnectCancel();
+  return connectState;
+}
+
+uint8_t halConnectPoll() { return connectState; }
+
+void halConnectCancel() {
+  if (probePcb) {
+    tcp_err(probePcb, nullptr);
+    tcp_abort(probePcb);
+    probePcb = nullptr;
+  }
+  connectState = HAL_FAILED;
+}
+
+// ClientContext takes over the pcb's callbacks
+bool halConnectTake(WiFiClient& client) {
+  if (connectState != HAL_DONE || !probePcb) return false;
+  tcp_pcb* pcb = probePcb;
+  probePcb = nullptr;
+  connectState = HAL_FAILED;
+  client = ConnectedClient(new ClientContext(pcb, nullptr, nullptr));
+  return true;
+}
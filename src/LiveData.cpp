@@ -0,0 +1,161 @@
+#include "LiveData.h"
+#include "WebServerHandler.h"
+#include "ReadPlanner.h"
+#include "RegisterMap.h"
+#include "ResultEncoder.h"
+#include "SlaveTable.h"
+#include "Logger.h"
+
+EventStats eventStats;
+
+static WiFiClient eventClients[MAX_EVENT_CLIENTS];
+static bool eventActive[MAX_EVENT_CLIENTS];
+static unsigned long lastKeepalive = 0;
+
+static void closeEventClient(uint8_t i) {
+  eventClients[i].stop();
+  eventClients[i] = WiFiClient();
+  eventActive[i] = false;
+}
+
+uint8_t eventClientCount() {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < MAX_EVENT_CLIENTS; i++) n += eventActive[i];
+  return n;
+}
+
+// One write per stream. A stream whose socket buffer can't take the whole
+// event is dropped instead of stalling the poll loop; the browser reconnects
+// and starts over from the snapshot.
+static void broadcast(const char* data, size_t length) {
+  for (uint8_t i = 0; i < MAX_EVENT_CLIENTS; i++) {
+    if (!eventActive[i]) continue;
+    WiFiClient& client = eventClients[i];
+    if (!client.connected()) {
+      closeEventClient(i);
+      continue;
+    }
+    if ((size_t)client.availableForWrite() < length || client.write((const uint8_t*)data, length) != length) {
+      LOG_WARN("⚠️ Event stream too slow, closing it");
+      eventStats.slowClients++;
+      closeEventClient(i);
+      continue;
+    }
+    eventStats.events++;
+    eventStats.bytes += length;
+  }
+}
+
+// ----------------- Readings -----------------
+
+// Sends open streams the fields whose registers changed, or everything on
+// the first reading and on an error-state change
+static void pushChanges(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint32_t ageMs) {
+  if (!eventClientCount()) return;
+  const SlaveReading& last = slaveLastReading(slave);
+  bool full = !last.valid || result != last.result;
+  uint8_t count = result == RTU_SUCCESS ? slaveFieldCount(slave) : 0;
+  uint64_t mask = 0;
+  const uint16_t* lastImage = slaveLastImage(slave);
+  for (uint8_t i = 0; i < count; i++) {
+    RegField field = slaveField(slave, i);
+    if (full || memcmp(image + field.index, lastImage + field.index, 2 * fieldWords(field)) != 0) {
+      mask |= 1ULL << i;
+    }
+  }
+  if (full || mask) {
+    size_t length = encodeSlaveEvent(slave, result, image, mask, ageMs);
+    if (length) broadcast(resultPayload(), length);
+  }
+}
+
+// Run once per finished poll
+void recordSlaveReading(ModbusSlave& slave, uint8_t result, const uint16_t* image) {
+  pushChanges(slave, result, image, RESULT_AGE_LIVE);
+  if (result == RTU_SUCCESS) memcpy(slaveLastImage(slave), image, 2 * slave.imageWords);
+  SlaveReading& last = slaveLastReading(slave);
+  last.result = result;
+  last.time = slaveSampling(slave).sampleTime;
+  last.valid = true;
+}
+
+// One block read outside a poll (see RegisterCache), taken from the RTU
+// engine's reply. Changes go out as after a poll, but with ageMs 0 (and ts
+// now) as they weren't sampled with it; the slave's reading time and error
+// state stay as the last poll left them.
+void recordBlockReading(ModbusSlave& slave, const ReadBlock& block) {
+  static uint16_t image[MAX_REGS_PER_SLAVE];
+  memcpy(image, slaveLastImage(slave), 2 * slave.imageWords);
+  copyBlockToImage(slave, block, image);
+  const SlaveReading& last = slaveLastReading(slave);
+  if (last.valid && last.result == RTU_SUCCESS) pushChanges(slave, RTU_SUCCESS, image, 0);
+  memcpy(slaveLastImage(slave), image, 2 * slave.imageWords);
+}
+
+// ----------------- HTTP -----------------
+
+// {"uptimeMs":N,"slaves":[{"id":1,"name":"s1","temperature":25.3,...,"ageMs":N}]}
+// Straight from RAM, one chunk per slave; "ageMs" is null for slaves not
+// polled yet, and capture time is uptimeMs - ageMs (NON-BLOCKING)
+void handleGetData() {
+  unsigned long now = millis();
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+
+  char head[40];
+  server.sendContent(head, snprintf(head, sizeof(head), "{\"uptimeMs\":%lu,\"slaves\":[", now));
+  bool first = true;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    const ModbusSlave& slave = slaves[i];
+    const SlaveReading& last = slaveLastReading(slave);
+    size_t length = encodeSlaveReport(slave, last.result, slaveLastImage(slave), last.valid ? ~0ULL : 0, PAYLOAD_JSON,
+                                      last.valid ? now - last.time : RESULT_AGE_UNKNOWN);
+    if (!length) continue;
+    if (!first) server.sendContent(",", 1);
+    server.sendContent(resultPayload(), length);
+    first = false;
+  }
+  server.sendContent("]}", 2);
+  server.sendContent("");
+}
+
+// Takes over the connection; the web server lets go of it once this returns
+void handleEvents() {
+  int8_t slot = -1;
+  for (uint8_t i = 0; i < MAX_EVENT_CLIENTS; i++) {
+    if (eventActive[i] && !eventClients[i].connected()) closeEventClient(i);
+    if (!eventActive[i] && slot < 0) slot = i;
+  }
+  if (slot < 0) {
+    server.send(503, "application/json", "{\"error\":\"Too many event streams\"}");
+    return;
+  }
+
+  WiFiClient& client = eventClients[slot];
+  client = server.client();
+  client.setNoDelay(true);
+  client.print(F("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+                 "Connection: keep-alive\r\n\r\n"));
+  client.print(F("retry: "));
+  client.print(EVENTS_RETRY_MS);
+  client.print(F("\n\n"));
+  eventActive[slot] = true;
+
+  // Current values first; this one may wait on the socket like any response
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    const ModbusSlave& slave = slaves[i];
+    const SlaveReading& last = slaveLastReading(slave);
+    if (!last.valid) continue;
+    size_t length = encodeSlaveEvent(slave, last.result, slaveLastImage(slave), ~0ULL, now - last.time);
+    if (length) client.write((const uint8_t*)resultPayload(), length);
+  }
+  LOG_INFO("📡 Event stream opened (%u open)", eventClientCount());
+}
+
+// Keeps idle streams alive through proxies and frees closed ones
+void serviceEvents() {
+  if (millis() - lastKeepalive < EVENTS_KEEPALIVE_MS) return;
+  lastKeepalive = millis();
+  if (eventClientCount()) broadcast(":\n\n", 3);
+}
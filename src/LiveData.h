@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+#include "ReadPlanner.h"
+
+// Last reading of every slave, kept in RAM for the local web page. GET /data
+// serves the whole snapshot without touching the bus; /events is a
+// server-sent event stream that gets the current snapshot on connect and
+// then, per poll, only the values that changed. Polls are only diffed and
+// encoded while a stream is open.
+
+#define MAX_EVENT_CLIENTS 4
+#define EVENTS_KEEPALIVE_MS 15000UL  // comment line; also notices closed streams
+#define EVENTS_RETRY_MS 3000         // browser reconnect delay
+
+struct EventStats {
+  uint32_t events;       // events written, counted per stream
+  uint32_t bytes;
+  uint32_t slowClients;  // streams dropped because their socket couldn't take an event
+};
+
+extern EventStats eventStats;
+
+// Function declarations
+void recordSlaveReading(ModbusSlave& slave, uint8_t result, const uint16_t* image);
+void recordBlockReading(ModbusSlave& slave, const ReadBlock& block);
+void handleGetData();
+void handleEvents();
+void serviceEvents();
+uint8_t eventClientCount();
@@ -0,0 +1,105 @@
+#include "Logger.h"
+#include <stdarg.h>
+#include "RtuMaster.h"
+#ifdef LOG_MQTT_TOPIC
+#include "MQTTHandler.h"
+#endif
+
+// Positions are free-running byte counters (compared wrap-safe); the ring
+// index is pos % size
+static char logBuffer[LOG_BUFFER_SIZE];
+static uint32_t logWritePos = 0;
+static uint32_t logFill = 0;    // bytes held, saturates at LOG_BUFFER_SIZE
+static uint32_t logSerialPos = 0;
+static uint32_t logDropped = 0;
+#ifdef LOG_MQTT_TOPIC
+static uint32_t logMqttPos = 0;
+#endif
+
+static const char logLevelTag[] = "-EWID";
+
+void logBegin() {
+  Serial1.begin(LOG_SERIAL1_BAUD);
+}
+
+static bool logBefore(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+static void logAppend(const char* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    logBuffer[(logWritePos + i) & (LOG_BUFFER_SIZE - 1)] = data[i];
+  }
+  logWritePos += len;
+  logFill = min(logFill + (uint32_t)len, (uint32_t)LOG_BUFFER_SIZE);
+}
+
+void logPrintf(uint8_t level, const char* fmt, ...) {
+  char line[LOG_LINE_MAX];
+  int n = snprintf(line, sizeof(line), "[%8lu] %c ", (unsigned long)millis(), logLevelTag[level]);
+
+  va_list args;
+  va_start(args, fmt);
+  int m = vsnprintf(line + n, sizeof(line) - n - 1, fmt, args);
+  va_end(args);
+  if (m < 0) m = 0;
+  n = min(n + m, (int)sizeof(line) - 2);
+  line[n++] = '\n';
+  logAppend(line, n);
+}
+
+uint32_t logHead() {
+  return logWritePos;
+}
+
+// Oldest position still held by the ring
+uint32_t logOldest() {
+  return logWritePos - logFill;
+}
+
+size_t logRead(uint32_t pos, char* dst, size_t len) {
+  if (logBefore(pos, logOldest())) pos = logOldest();
+  size_t n = 0;
+  while (n < len && logBefore(pos + n, logWritePos)) {
+    dst[n] = logBuffer[(pos + n) & (LOG_BUFFER_SIZE - 1)];
+    n++;
+  }
+  return n;
+}
+
+uint32_t logDroppedBytes() {
+  return logDropped;
+}
+
+// Run from loop(): move a bounded chunk to the sinks while the bus is quiet
+void logDrain() {
+  if (rtuBusy()) return;
+
+  if (logBefore(logSerialPos, logOldest())) {
+    logDropped += logOldest() - logSerialPos;
+    logSerialPos = logOldest();
+  }
+  size_t room = min((size_t)Serial1.availableForWrite(), (size_t)LOG_DRAIN_BYTES);
+  while (room > 0 && logBefore(logSerialPos, logWritePos)) {
+    char chunk[LOG_DRAIN_BYTES];
+    size_t n = logRead(logSerialPos, chunk, room);
+    Serial1.write((const uint8_t*)chunk, n);
+    logSerialPos += n;
+    room -= n;
+  }
+
+#ifdef LOG_MQTT_TOPIC
+  if (logBefore(logMqttPos, logOldest())) logMqttPos = logOldest();
+  if (logBefore(logMqttPos, logWritePos) && mqttClient.connected()) {
+    char line[LOG_LINE_MAX];
+    size_t n = logRead(logMqttPos, line, sizeof(line) - 1);
+    size_t end = 0;
+    while (end < n && line[end] != '\n') end++;
+    if (end < n) {  // only whole lines
+      line[end] = '\0';
+      mqttClient.publish(LOG_MQTT_TOPIC, line);
+      logMqttPos += end + 1;
+    }
+  }
+#endif
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+
+// RAM ring-buffer logger. Serial is the Modbus UART, so nothing here ever
+// touches it: lines are formatted into the ring and drained to Serial1 TX
+// (GPIO2) only while the RTU engine is idle. GET /log returns what the ring
+// still holds.
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+// Levels above LOG_LEVEL compile to nothing; override with -DLOG_LEVEL=...
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_BUFFER_SIZE 2048     // must be a power of two
+#define LOG_LINE_MAX 160         // longer lines are truncated
+#define LOG_SERIAL1_BAUD 115200
+#define LOG_DRAIN_BYTES 64       // per loop() pass, capped by free TX FIFO space
+
+// Optional MQTT sink, e.g. -DLOG_MQTT_TOPIC=\"gateway/log\"; one line per publish
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logPrintf(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) logPrintf(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logPrintf(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logPrintf(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+// Function declarations
+void logBegin();
+void logPrintf(uint8_t level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+void logDrain();
+uint32_t logHead();
+uint32_t logOldest();
+size_t logRead(uint32_t pos, char* dst, size_t len);
+uint32_t logDroppedBytes();
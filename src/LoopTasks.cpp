@@ -0,0 +1,69 @@
+#include "LoopTasks.h"
+#include "RtuMaster.h"
+#include "Logger.h"
+
+LoopTask loopTasks[MAX_LOOP_TASKS];
+uint8_t loopTaskCount = 0;
+
+// Kept sorted by priority; tasks of equal priority run in the order added
+bool addLoopTask(const char* name, void (*run)(), TaskPriority priority, uint32_t budgetUs, uint16_t periodMs) {
+  if (loopTaskCount >= MAX_LOOP_TASKS) {
+    LOG_ERROR("❌ No room for task %s", name);
+    return false;
+  }
+  uint8_t at = loopTaskCount;
+  while (at > 0 && loopTasks[at - 1].priority > priority) {
+    loopTasks[at] = loopTasks[at - 1];
+    at--;
+  }
+  loopTasks[at] = LoopTask();
+  loopTasks[at].name = name;
+  loopTasks[at].run = run;
+  loopTasks[at].priority = priority;
+  loopTasks[at].periodMs = periodMs;
+  loopTasks[at].budgetUs = budgetUs;
+  loopTaskCount++;
+  return true;
+}
+
+static void runTask(LoopTask& task) {
+  uint32_t start = micros();
+  task.run();
+  uint32_t elapsed = micros() - start;
+  unsigned long now = millis();
+  task.lastRun = now;
+  task.runs++;
+  task.totalMicros += elapsed;
+  if (elapsed > task.maxMicros) task.maxMicros = elapsed;
+  if (elapsed <= task.budgetUs) return;
+
+  task.overruns++;
+  if (task.overruns == 1 || now - task.lastOverrunLog >= TASK_OVERRUN_LOG_MS) {
+    task.lastOverrunLog = now;
+    LOG_WARN("⏱️ Task %s took %lu us, budget %lu us (%lu overruns)", task.name, (unsigned long)elapsed,
+             (unsigned long)task.budgetUs, (unsigned long)task.overruns);
+  }
+}
+
+static void runBusTasks() {
+  for (uint8_t i = 0; i < loopTaskCount && loopTasks[i].priority == TASK_BUS; i++) runTask(loopTasks[i]);
+}
+
+// One loop() pass
+void runLoopTasks() {
+  uint32_t passStart = micros();
+  runBusTasks();
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    LoopTask& task = loopTasks[i];
+    if (task.priority == TASK_BUS) continue;
+    if (task.periodMs && millis() - task.lastRun < task.periodMs) continue;
+    if (!task.deferred && micros() - passStart >= LOOP_PASS_BUDGET_US) {
+      task.deferred = true;
+      task.deferrals++;
+      continue;
+    }
+    task.deferred = false;
+    runTask(task);
+    if (rtuBusy()) runBusTasks();
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+
+// Cooperative scheduler behind loop(). Each pass runs the due tasks in
+// priority order. TASK_BUS tasks run first and, while a transaction is in
+// flight, again after every other task, so a Modbus reply never waits behind
+// more than one of them. Once a pass has
+// used LOOP_PASS_BUDGET_US, the remaining tasks move to the next pass, but a
+// task is only ever put off once in a row. A task that takes longer than its
+// own budget counts an overrun; the counters are on /metrics.
+
+#define MAX_LOOP_TASKS 16
+#define LOOP_PASS_BUDGET_US 20000UL
+#define TASK_OVERRUN_LOG_MS 60000UL   // at most one overrun warning per task this often
+
+enum TaskPriority : uint8_t {
+  TASK_BUS,     // Modbus engine: every pass, and between the others mid-transaction
+  TASK_HIGH,
+  TASK_NORMAL,
+  TASK_LOW
+};
+
+struct LoopTask {
+  const char* name;
+  void (*run)();
+  TaskPriority priority;
+  uint16_t periodMs;          // 0: every pass
+  uint32_t budgetUs;
+  unsigned long lastRun;
+  unsigned long lastOverrunLog;
+  bool deferred;              // put off last pass, so it runs this one
+  uint32_t runs;
+  uint32_t overruns;
+  uint32_t deferrals;
+  uint32_t maxMicros;
+  uint64_t totalMicros;
+};
+
+extern LoopTask loopTasks[MAX_LOOP_TASKS];
+extern uint8_t loopTaskCount;
+
+// Function declarations
+bool addLoopTask(const char* name, void (*run)(), TaskPriority priority, uint32_t budgetUs, uint16_t periodMs = 0);
+void runLoopTasks();
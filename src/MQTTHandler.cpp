@@ -1,41 +1,191 @@
 #include "MQTTHandler.h"
 #include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "Hal.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "MqttCommands.h"
 
 const char* mqttServer = "192.168.31.66";
 const uint16_t mqttPort = 1883;
 const char* mqttTopicPub = "Lora/receive";
 
-unsigned long previousMQTTReconnect = 0;
-const unsigned long mqttReconnectInterval = 5000;
-
-WiFiClient espClient;
+MqttSocket espClient;
 PubSubClient mqttClient(espClient);
 
-void reconnectMQTT() {
-    unsigned long now = millis();
-    if (!mqttClient.connected() && now - previousMQTTReconnect > mqttReconnectInterval) {
-        previousMQTTReconnect = now;
-        Serial.print("Attempting MQTT connection...");
-        if (mqttClient.connect("ESP8266_LoRa_Client")) {
-            Serial.println("connected");
-            mqttClient.subscribe(mqttTopicPub);
-        } else {
-            Serial.print("failed, rc=");
-            Serial.print(mqttClient.state());
-            Serial.println(" try again later");
-        }
+enum MqttLinkState {
+  MQTT_LINK_DOWN,       // waiting out the retry delay
+  MQTT_LINK_RESOLVING,  // broker name lookup
+  MQTT_LINK_PROBING,    // TCP connect in progress
+  MQTT_LINK_HANDSHAKE,  // CONNECT sent, waiting for CONNACK
+  MQTT_LINK_UP
+};
+
+static MqttLinkState linkState = MQTT_LINK_DOWN;
+static unsigned long stepStart = 0;
+static unsigned long lastFailure = 0;
+static unsigned long retryWait = 0;               // in force now
+static unsigned long retryMs = MQTT_RETRY_MIN_MS;  // after the next failure
+static uint32_t brokerIp = 0;
+
+// ----------------- Reconnect Steps -----------------
+
+static void connectFailed(const char* reason) {
+  espClient.stop();
+  linkState = MQTT_LINK_DOWN;
+  lastFailure = millis();
+  retryWait = retryMs;
+  retryMs = min(retryMs * 2, MQTT_RETRY_MAX_MS);
+  LOG_WARN("MQTT connect failed (%s), next try in %lu s", reason, retryWait / 1000);
+}
+
+// MQTT 3.1.1 CONNECT with a clean session, byte for byte what PubSubClient sends
+static size_t buildConnect(uint8_t* packet, const char* clientId) {
+  uint8_t idLength = strlen(clientId);
+  size_t n = 0;
+  packet[n++] = 0x10;
+  packet[n++] = 12 + idLength;  // remaining length: one byte while under 128
+  memcpy(packet + n, "\0\4MQTT\4\2", 8);
+  n += 8;
+  packet[n++] = MQTT_KEEPALIVE >> 8;
+  packet[n++] = MQTT_KEEPALIVE & 0xFF;
+  packet[n++] = 0;
+  packet[n++] = idLength;
+  memcpy(packet + n, clientId, idLength);
+  return n + idLength;
+}
+
+static void startProbe() {
+  stepStart = millis();
+  linkState = MQTT_LINK_PROBING;
+  if (halConnectStart(brokerIp, mqttPort) == HAL_FAILED) connectFailed("no socket");
+}
+
+// The asynchronous connection becomes PubSubClient's socket, so CONNECT goes out
+// on it straight away; MQTT_SOCKET_TIMEOUT_MS caps writes to a stalled broker
+static void startHandshake() {
+  static uint8_t packet[14 + sizeof(MQTT_CLIENT_ID)];
+  if (!halConnectTake(espClient)) {
+    connectFailed("connection lost");
+    return;
+  }
+  espClient.setTimeout(MQTT_SOCKET_TIMEOUT_MS);
+  size_t length = buildConnect(packet, MQTT_CLIENT_ID);
+  if (espClient.write(packet, length) != length) {
+    connectFailed("CONNECT not sent");
+    return;
+  }
+  stepStart = millis();
+  linkState = MQTT_LINK_HANDSHAKE;
+}
+
+static void finishHandshake() {
+  uint8_t connack[4];
+  for (uint8_t i = 0; i < sizeof(connack); i++) connack[i] = espClient.read();
+  if (connack[0] != 0x20 || connack[1] != 2) {
+    connectFailed("bad CONNACK");
+    return;
+  }
+  if (connack[3] != 0) {
+    static char reason[24];
+    snprintf(reason, sizeof(reason), "refused, rc=%u", connack[3]);
+    connectFailed(reason);
+    return;
+  }
+  espClient.replayConnack(connack);
+  bool ok = mqttClient.connect(MQTT_CLIENT_ID);
+  espClient.endReplay();
+  if (!ok) {
+    connectFailed("client state");
+    return;
+  }
+  linkState = MQTT_LINK_UP;
+  retryWait = 0;
+  retryMs = MQTT_RETRY_MIN_MS;
+  LOG_INFO("MQTT connected");
+  mqttClient.subscribe(mqttTopicPub);
+  mqttCommandsConnected();
+}
+
+// Keeps the broker connection alive. Reconnecting runs as lookup, TCP
+// connect and CONNECT/CONNACK, each checked once per call, so an unreachable
+// broker never holds up loop().
+void serviceMQTT() {
+  unsigned long now = millis();
+  switch (linkState) {
+    case MQTT_LINK_UP:
+      if (mqttClient.loop()) return;
+      LOG_WARN("MQTT connection lost, rc=%d", mqttClient.state());
+      espClient.stop();
+      linkState = MQTT_LINK_DOWN;
+      return;
+
+    case MQTT_LINK_DOWN: {
+      if (WiFi.status() != WL_CONNECTED || now - lastFailure < retryWait) return;
+      LOG_INFO("Attempting MQTT connection...");
+      stepStart = now;
+      uint8_t lookup = halResolveStart(mqttServer, brokerIp);
+      if (lookup == HAL_DONE) startProbe();
+      else if (lookup == HAL_PENDING) linkState = MQTT_LINK_RESOLVING;
+      else connectFailed("lookup");
+      return;
+    }
+
+    case MQTT_LINK_RESOLVING: {
+      uint8_t lookup = halResolvePoll(brokerIp);
+      if (lookup == HAL_DONE) {
+        startProbe();
+      } else if (lookup == HAL_FAILED || now - stepStart >= MQTT_STEP_TIMEOUT_MS) {
+        halResolveCancel();
+        connectFailed("lookup");
+      }
+      return;
+    }
+
+    case MQTT_LINK_PROBING: {
+      uint8_t tcp = halConnectPoll();
+      if (tcp == HAL_DONE) {
+        startHandshake();
+      } else if (tcp == HAL_FAILED || now - stepStart >= MQTT_STEP_TIMEOUT_MS) {
+        halConnectCancel();
+        connectFailed("broker unreachable");
+      }
+      return;
     }
+
+    case MQTT_LINK_HANDSHAKE:
+      if (espClient.available() >= 4) finishHandshake();
+      else if (!espClient.connected() || now - stepStart >= MQTT_STEP_TIMEOUT_MS) connectFailed("no CONNACK");
+      return;
+  }
 }
 
 // ✅ Centralized publish function
 void publishMessage(const char* topic, const char* payload) {
-    if (mqttClient.connected()) {
-        mqttClient.publish(topic, payload);
-        Serial.print("MQTT Published → ");
-        Serial.print(topic);
-        Serial.print(": ");
-        Serial.println(payload);
+    publishPayload(topic, payload, strlen(payload));
+}
+
+// Streams the payload into the packet, so its size isn't capped by the
+// PubSubClient buffer and nothing is copied
+bool publishPayload(const char* topic, const char* payload, size_t length) {
+    if (!mqttClient.connected()) {
+        LOG_WARN("⚠️ MQTT not connected, message not sent");
+        return false;
+    }
+    uint32_t start = micros();
+    bool ok = mqttClient.beginPublish(topic, length, false) &&
+              mqttClient.write((const uint8_t*)payload, length) == length &&
+              mqttClient.endPublish();
+    histogramAdd(publishHist, micros() - start);
+    if (ok) {
+        // JSON is logged as text; binary payloads only by size
+        if (length && (payload[0] == '[' || payload[0] == '{')) {
+            LOG_DEBUG("MQTT Published → %s: %.*s", topic, (int)length, payload);
+        } else {
+            LOG_DEBUG("MQTT Published → %s: %u bytes", topic, (unsigned)length);
+        }
     } else {
-        Serial.println("⚠️ MQTT not connected, message not sent");
+        LOG_WARN("⚠️ MQTT publish to %s failed", topic);
     }
+    return ok;
 }
\ No newline at end of file
@@ -2,14 +2,46 @@
 #include <PubSubClient.h>
 #include <WiFiClient.h>
 
+#define MQTT_CLIENT_ID "ESP8266_LoRa_Client"
+#define MQTT_RETRY_MIN_MS 5000UL       // first retry after a failed connect...
+#define MQTT_RETRY_MAX_MS 60000UL      // ...doubling up to this
+#define MQTT_STEP_TIMEOUT_MS 5000UL    // each of lookup, TCP connect and CONNACK
+#define MQTT_SOCKET_TIMEOUT_MS 250     // writes to a stalled broker
+
 extern const char* mqttServer;
 extern const uint16_t mqttPort;
 extern const char* mqttTopicPub;
-extern unsigned long previousMQTTReconnect;
-extern const unsigned long mqttReconnectInterval;
 
-extern WiFiClient espClient;
+// The TCP connection under PubSubClient. PubSubClient::connect() sends
+// CONNECT and then spins until CONNACK arrives; serviceMQTT() does that
+// exchange itself without waiting and then lets connect() run against the
+// CONNACK it already has, swallowing the duplicate CONNECT. This depends on
+// how PubSubClient 2.8 uses its socket, hence the exact version in
+// platformio.ini and test/test_mqtt_handshake.
+class MqttSocket : public WiFiClient {
+ public:
+  void replayConnack(const uint8_t* connack) {
+    memcpy(connack_, connack, sizeof(connack_));
+    replayLeft_ = sizeof(connack_);
+  }
+  void endReplay() { replayLeft_ = 0; }
+
+  size_t write(uint8_t c) override { return replayLeft_ ? 1 : WiFiClient::write(c); }
+  size_t write(const uint8_t* buf, size_t size) override { return replayLeft_ ? size : WiFiClient::write(buf, size); }
+  using WiFiClient::write;
+  int available() override { return replayLeft_ ? replayLeft_ : WiFiClient::available(); }
+  int read() override { return replayLeft_ ? connack_[sizeof(connack_) - replayLeft_--] : WiFiClient::read(); }
+  using WiFiClient::read;
+  int peek() override { return replayLeft_ ? connack_[sizeof(connack_) - replayLeft_] : WiFiClient::peek(); }
+
+ private:
+  uint8_t connack_[4];
+  uint8_t replayLeft_ = 0;
+};
+
+extern MqttSocket espClient;
 extern PubSubClient mqttClient;
 
-void reconnectMQTT();
+void serviceMQTT();
 void publishMessage(const char* topic, const char* payload);
+bool publishPayload(const char* topic, const char* payload, size_t length);
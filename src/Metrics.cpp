@@ -0,0 +1,303 @@
+#include "Metrics.h"
+#include <ESP8266WiFi.h>
+#include <stdarg.h>
+#include "WebServerHandler.h"
+#include "MQTTHandler.h"
+#include "ResultPublisher.h"
+#include "SlaveTable.h"
+#include "SlaveHealth.h"
+#include "PollScheduler.h"
+#include "LoopTasks.h"
+#include "ModbusTcpServer.h"
+#include "RegisterCache.h"
+#include "WriteQueue.h"
+#include "WindowAggregator.h"
+#include "Logger.h"
+
+Histogram transactionHist = {10, {}, 0, 0, 0};   // from 1 ms
+Histogram pollHist = {10, {}, 0, 0, 0};
+Histogram loopHist = {6, {}, 0, 0, 0};           // from 64 us
+Histogram webHist = {8, {}, 0, 0, 0};            // from 256 us
+Histogram publishHist = {6, {}, 0, 0, 0};
+Histogram writeHist = {10, {}, 0, 0, 0};         // from 1 ms
+
+static uint32_t lastLoopMicros = 0;
+static bool loopTicked = false;
+
+// Bus utilisation over the last complete window
+static unsigned long windowStart = 0;
+static uint64_t windowBusyStart = 0;
+static uint8_t busPercent = 0;
+static unsigned long lastStatsPublish = 0;
+
+// ----------------- Recording -----------------
+
+void histogramAdd(Histogram& h, uint32_t micros) {
+  uint8_t bucket = 0;
+  if (micros >> h.firstLog2) {
+    bucket = 32 - __builtin_clz(micros) - h.firstLog2;
+    if (bucket >= HIST_BUCKETS) bucket = HIST_BUCKETS - 1;
+  }
+  h.buckets[bucket]++;
+  h.count++;
+  h.sumMicros += micros;
+  if (micros > h.maxMicros) h.maxMicros = micros;
+}
+
+// Upper bound of the bucket holding the given percentile (the maximum for the open-ended one)
+uint32_t histogramPercentile(const Histogram& h, uint8_t percent) {
+  uint32_t target = ((uint64_t)h.count * percent + 99) / 100, seen = 0;
+  for (uint8_t i = 0; i < HIST_BUCKETS - 1; i++) {
+    seen += h.buckets[i];
+    if (seen >= target) return min(1UL << (h.firstLog2 + i), (unsigned long)h.maxMicros);
+  }
+  return h.maxMicros;
+}
+
+// Call first thing in loop(): the time since the previous call is one iteration
+void metricsLoopTick() {
+  uint32_t now = micros();
+  if (loopTicked) histogramAdd(loopHist, now - lastLoopMicros);
+  lastLoopMicros = now;
+  loopTicked = true;
+}
+
+uint8_t busUtilisationPercent() {
+  return busPercent;
+}
+
+// ----------------- MQTT Stats -----------------
+
+static void publishStats() {
+  static char payload[384];
+  static char topic[MAX_TOPIC_PREFIX + 8];
+  uint8_t breakersOpen = 0;
+  for (uint8_t i = 0; i < slaveCount; i++) breakersOpen += slaveHealth(slaves[i]).probeLevel != 0;
+  uint32_t taskOverruns = 0;
+  for (uint8_t i = 0; i < loopTaskCount; i++) taskOverruns += loopTasks[i].overruns;
+  int length = snprintf(payload, sizeof(payload),
+                        "{\"uptimeMs\":%lu,\"heapFree\":%lu,\"heapMaxBlock\":%lu,\"busPct\":%u,"
+                        "\"polls\":%lu,\"pollP95Us\":%lu,\"transactionP95Us\":%lu,\"loopP99Us\":%lu,"
+                        "\"loopMaxUs\":%lu,\"webMaxUs\":%lu,\"publishP95Us\":%lu,\"breakersOpen\":%u,"
+                        "\"taskOverruns\":%lu}",
+                        millis(), (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMaxFreeBlockSize(),
+                        busPercent, (unsigned long)pollHist.count, (unsigned long)histogramPercentile(pollHist, 95),
+                        (unsigned long)histogramPercentile(transactionHist, 95),
+                        (unsigned long)histogramPercentile(loopHist, 99), (unsigned long)loopHist.maxMicros,
+                        (unsigned long)webHist.maxMicros, (unsigned long)histogramPercentile(publishHist, 95),
+                        breakersOpen, (unsigned long)taskOverruns);
+  snprintf(topic, sizeof(topic), "%s/stats", publishConfig.prefix);
+  publishPayload(topic, payload, min(length, (int)sizeof(payload) - 1));
+}
+
+// Run from loop(): closes utilisation windows and publishes stats when due
+void serviceMetrics() {
+  unsigned long now = millis();
+  if (now - windowStart >= METRICS_WINDOW_MS) {
+    uint64_t busy = rtuBusyMicros();
+    busPercent = min((busy - windowBusyStart) / 10 / (now - windowStart), (uint64_t)100);
+    windowBusyStart = busy;
+    windowStart = now;
+  }
+  if (publishConfig.statsMs && mqttClient.connected() && now - lastStatsPublish >= publishConfig.statsMs) {
+    lastStatsPublish = now;
+    publishStats();
+  }
+}
+
+// ----------------- Prometheus Text -----------------
+
+// Lines collect here and go out as one chunk when it's full
+static char metricsChunk[512];
+static size_t metricsLength = 0;
+
+static void flushMetrics() {
+  if (metricsLength) server.sendContent(metricsChunk, metricsLength);
+  metricsLength = 0;
+}
+
+static void emit(const char* format, ...) {
+  for (uint8_t attempt = 0; attempt < 2; attempt++) {
+    va_list args;
+    va_start(args, format);
+    size_t room = sizeof(metricsChunk) - metricsLength;
+    int n = vsnprintf(metricsChunk + metricsLength, room, format, args);
+    va_end(args);
+    if (n >= 0 && (size_t)n < room) {
+      metricsLength += n;
+      return;
+    }
+    flushMetrics();  // didn't fit: send what we have and try again on an empty chunk
+  }
+}
+
+// Label value with ", \ and newlines escaped
+static const char* labelValue(const char* text) {
+  static char escaped[2 * SLAVE_NAME_MAX + 1];
+  size_t n = 0;
+  for (const char* p = text; *p && n < sizeof(escaped) - 2; p++) {
+    if (*p == '"' || *p == '\\' || *p == '\n') escaped[n++] = '\\';
+    escaped[n++] = *p == '\n' ? 'n' : *p;
+  }
+  escaped[n] = '\0';
+  return escaped;
+}
+
+// Microseconds as seconds, without floating point
+#define SECONDS(us) (unsigned long)((us) / 1000000), (unsigned long)((us) % 1000000)
+
+static void emitHistogram(const char* name, const char* help, const Histogram& h) {
+  emit("# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < HIST_BUCKETS - 1; i++) {
+    cumulative += h.buckets[i];
+    uint32_t bound = 1UL << (h.firstLog2 + i);
+    emit("%s_bucket{le=\"%lu.%06lu\"} %lu\n", name, SECONDS(bound), (unsigned long)cumulative);
+  }
+  emit("%s_bucket{le=\"+Inf\"} %lu\n%s_sum %lu.%06lu\n%s_count %lu\n", name, (unsigned long)h.count, name,
+       SECONDS(h.sumMicros), name, (unsigned long)h.count);
+}
+
+static void emitHeader(const char* name, const char* type, const char* help) {
+  emit("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Prometheus text exposition format, streamed (NON-BLOCKING)
+void handleMetrics() {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4", "");
+  metricsLength = 0;
+
+  emitHistogram("modbus_transaction_seconds", "One RTU request and its reply or timeout.", transactionHist);
+  emitHistogram("modbus_poll_seconds", "All reads of one slave poll.", pollHist);
+  emitHistogram("gateway_loop_seconds", "loop() iteration, entry to entry.", loopHist);
+  emitHistogram("gateway_web_request_seconds", "HTTP handler time.", webHist);
+  emitHistogram("mqtt_publish_seconds", "One MQTT publish.", publishHist);
+  emitHistogram("modbus_write_seconds", "Write request, queued to written and read back.", writeHist);
+
+  emitHeader("gateway_loop_max_stall_seconds", "gauge", "Longest loop() iteration since boot.");
+  emit("gateway_loop_max_stall_seconds %lu.%06lu\n", SECONDS(loopHist.maxMicros));
+  emitHeader("gateway_uptime_seconds", "gauge", "Time since boot.");
+  emit("gateway_uptime_seconds %lu\n", millis() / 1000);
+  emitHeader("gateway_heap_free_bytes", "gauge", "Free heap.");
+  emit("gateway_heap_free_bytes %lu\n", (unsigned long)ESP.getFreeHeap());
+  emitHeader("gateway_heap_max_block_bytes", "gauge", "Largest free heap block.");
+  emit("gateway_heap_max_block_bytes %lu\n", (unsigned long)ESP.getMaxFreeBlockSize());
+
+  // Loop tasks, see LoopTasks.h
+  emitHeader("gateway_task_seconds_total", "counter", "Time spent in the loop task.");
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    emit("gateway_task_seconds_total{task=\"%s\"} %lu.%06lu\n", loopTasks[i].name, SECONDS(loopTasks[i].totalMicros));
+  }
+  emitHeader("gateway_task_runs_total", "counter", "Loop task runs.");
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    emit("gateway_task_runs_total{task=\"%s\"} %lu\n", loopTasks[i].name, (unsigned long)loopTasks[i].runs);
+  }
+  emitHeader("gateway_task_overruns_total", "counter", "Runs that took longer than the task's budget.");
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    emit("gateway_task_overruns_total{task=\"%s\"} %lu\n", loopTasks[i].name, (unsigned long)loopTasks[i].overruns);
+  }
+  emitHeader("gateway_task_deferrals_total", "counter", "Times the task was moved to the next pass.");
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    emit("gateway_task_deferrals_total{task=\"%s\"} %lu\n", loopTasks[i].name, (unsigned long)loopTasks[i].deferrals);
+  }
+  emitHeader("gateway_task_max_seconds", "gauge", "Longest single run of the task.");
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    emit("gateway_task_max_seconds{task=\"%s\"} %lu.%06lu\n", loopTasks[i].name, SECONDS(loopTasks[i].maxMicros));
+  }
+
+  emitHeader("modbus_bus_busy_seconds_total", "counter", "Time transactions held the bus: request, slave turnaround, reply.");
+  emit("modbus_bus_busy_seconds_total %lu.%06lu\n", SECONDS(rtuBusyMicros()));
+  emitHeader("modbus_bus_utilisation_ratio", "gauge", "Share of time a transaction held the bus, last 10 s.");
+  emit("modbus_bus_utilisation_ratio %u.%02u\n", busPercent / 100, busPercent % 100);
+
+  // Modbus TCP server
+  emitHeader("modbus_tcp_clients", "gauge", "Open Modbus TCP connections.");
+  emit("modbus_tcp_clients %u\n", modbusTcpClientCount());
+  emitHeader("modbus_tcp_queue_length", "gauge", "Modbus TCP requests waiting for the bus or a cache refresh.");
+  emit("modbus_tcp_queue_length %u\n", modbusTcpQueued());
+  emitHeader("modbus_tcp_requests_total", "counter", "Modbus TCP requests by outcome.");
+  emit("modbus_tcp_requests_total{outcome=\"reply\"} %lu\n", (unsigned long)modbusTcpStats.replies);
+  emit("modbus_tcp_requests_total{outcome=\"cached\"} %lu\n", (unsigned long)modbusTcpStats.cached);
+  emit("modbus_tcp_requests_total{outcome=\"no_reply\"} %lu\n", (unsigned long)modbusTcpStats.noReply);
+  emit("modbus_tcp_requests_total{outcome=\"expired\"} %lu\n", (unsigned long)modbusTcpStats.expired);
+  emit("modbus_tcp_requests_total{outcome=\"rejected\"} %lu\n", (unsigned long)modbusTcpStats.rejected);
+  emitHeader("modbus_tcp_orphaned_total", "counter", "Answers dropped because the client had disconnected.");
+  emit("modbus_tcp_orphaned_total %lu\n", (unsigned long)modbusTcpStats.orphaned);
+  emitHeader("modbus_tcp_connections_total", "counter", "Accepted Modbus TCP connections.");
+  emit("modbus_tcp_connections_total %lu\n", (unsigned long)modbusTcpStats.connections);
+
+  // Register cache
+  emitHeader("modbus_cache_reads_total", "counter", "Register cache reads by HTTP, MQTT and Modbus TCP.");
+  emit("modbus_cache_reads_total{outcome=\"hit\"} %lu\n", (unsigned long)cacheStats.hits);
+  emit("modbus_cache_reads_total{outcome=\"miss\"} %lu\n", (unsigned long)cacheStats.misses);
+  emitHeader("modbus_cache_refreshes_total", "counter", "Bus reads made to refresh stale cached blocks.");
+  emit("modbus_cache_refreshes_total %lu\n", (unsigned long)cacheStats.fetches);
+  emitHeader("modbus_cache_refresh_failures_total", "counter", "Cache refreshes the slave didn't answer correctly.");
+  emit("modbus_cache_refresh_failures_total %lu\n", (unsigned long)cacheStats.failures);
+
+  // Writes
+  emitHeader("modbus_write_queue_length", "gauge", "Coil and register values waiting for the bus.");
+  emit("modbus_write_queue_length %u\n", writeQueueLength());
+  emitHeader("modbus_write_requests_total", "counter", "Settled write requests by status.");
+  for (uint8_t status = WRITE_OK; status <= WRITE_REJECTED; status++) {
+    emit("modbus_write_requests_total{status=\"%s\"} %lu\n", writeStatusName(status),
+         (unsigned long)writeStats.outcomes[status]);
+  }
+  emitHeader("modbus_write_superseded_values_total", "counter", "Values replaced by a newer one before going out.");
+  emit("modbus_write_superseded_values_total %lu\n", (unsigned long)writeStats.superseded);
+  emitHeader("modbus_write_transactions_total", "counter", "Writes put on the bus (FC05/06/15/16).");
+  emit("modbus_write_transactions_total %lu\n", (unsigned long)writeStats.transactions);
+  emitHeader("modbus_write_values_total", "counter", "Values carried by those writes.");
+  emit("modbus_write_values_total %lu\n", (unsigned long)writeStats.values);
+
+  // Summary windows
+  emitHeader("modbus_window_samples_total", "counter", "Polls folded into summary windows.");
+  emit("modbus_window_samples_total %lu\n", (unsigned long)windowStats.samples);
+  emitHeader("modbus_window_summaries_total", "counter", "Window summaries by outcome.");
+  emit("modbus_window_summaries_total{outcome=\"published\"} %lu\n", (unsigned long)windowStats.published);
+  emit("modbus_window_summaries_total{outcome=\"queued\"} %lu\n", (unsigned long)windowStats.queued);
+  emit("modbus_window_summaries_total{outcome=\"dropped\"} %lu\n", (unsigned long)windowStats.dropped);
+
+  // Per slave, one family at a time as the format requires
+  emitHeader("modbus_slave_polls_total", "counter", "Finished polls.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    emit("modbus_slave_polls_total{slave=\"%u\",name=\"%s\"} %lu\n", slaves[i].id, labelValue(slaveName(slaves[i])),
+         (unsigned long)slaveSchedule(slaves[i]).pollCount);
+  }
+  emitHeader("modbus_slave_deadline_misses_total", "counter", "Polls that finished after the next one was due.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    emit("modbus_slave_deadline_misses_total{slave=\"%u\",name=\"%s\"} %lu\n", slaves[i].id,
+         labelValue(slaveName(slaves[i])), (unsigned long)slaveSchedule(slaves[i]).deadlineMisses);
+  }
+  emitHeader("modbus_slave_turnaround_seconds", "gauge", "Smoothed slave turnaround.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    uint32_t rttMicros = (uint32_t)slaveHealth(slaves[i]).rttSmooth * HEALTH_RTT_UNIT_US;
+    emit("modbus_slave_turnaround_seconds{slave=\"%u\",name=\"%s\"} %lu.%06lu\n", slaves[i].id,
+         labelValue(slaveName(slaves[i])), SECONDS(rttMicros));
+  }
+  emitHeader("modbus_slave_error_ratio", "gauge", "Failed polls among the last 16.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    uint8_t pct = slaveErrorPercent(slaves[i]);
+    emit("modbus_slave_error_ratio{slave=\"%u\",name=\"%s\"} %u.%02u\n", slaves[i].id,
+         labelValue(slaveName(slaves[i])), pct / 100, pct % 100);
+  }
+  emitHeader("modbus_slave_breaker_open", "gauge", "1 while the slave is only probed.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    emit("modbus_slave_breaker_open{slave=\"%u\",name=\"%s\"} %u\n", slaves[i].id, labelValue(slaveName(slaves[i])),
+         slaveHealth(slaves[i]).probeLevel ? 1 : 0);
+  }
+  emitHeader("modbus_slave_sample_jitter_seconds", "gauge", "Smoothed deviation of sample spacing from pollMs.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    emit("modbus_slave_sample_jitter_seconds{slave=\"%u\",name=\"%s\"} %lu.%06lu\n", slaves[i].id,
+         labelValue(slaveName(slaves[i])), SECONDS(slaveJitterMicros(slaves[i])));
+  }
+  emitHeader("modbus_slave_skipped_polls_total", "counter", "Fixed-rate periods skipped as the bus was late.");
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    emit("modbus_slave_skipped_polls_total{slave=\"%u\",name=\"%s\"} %lu\n", slaves[i].id,
+         labelValue(slaveName(slaves[i])), (unsigned long)slaveSchedule(slaves[i]).skippedPolls);
+  }
+
+  flushMetrics();
+  server.sendContent("");
+}
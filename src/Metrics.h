@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+
+// Always-on runtime metrics. Durations go into fixed log2 histograms:
+// recording one is a count-leading-zeros and three adds, no floats, no heap.
+// Served as Prometheus text on /metrics and, if publishConfig.statsMs is
+// set, as a JSON summary on <prefix>/stats.
+
+#define HIST_BUCKETS 16               // bucket i: below 2^(firstLog2 + i) us; the last is open-ended
+#define METRICS_WINDOW_MS 10000UL     // bus utilisation is averaged over this long
+
+struct Histogram {
+  uint8_t firstLog2;
+  uint32_t buckets[HIST_BUCKETS];
+  uint32_t count;
+  uint64_t sumMicros;
+  uint32_t maxMicros;
+};
+
+extern Histogram transactionHist;   // one RTU request/reply
+extern Histogram pollHist;          // all reads of one slave
+extern Histogram loopHist;          // loop() entry to entry
+extern Histogram webHist;           // one HTTP handler
+extern Histogram publishHist;       // one MQTT publish
+extern Histogram writeHist;         // write request, queued to settled
+
+// Function declarations
+void histogramAdd(Histogram& h, uint32_t micros);
+uint32_t histogramPercentile(const Histogram& h, uint8_t percent);
+void metricsLoopTick();
+void serviceMetrics();
+uint8_t busUtilisationPercent();
+void handleMetrics();
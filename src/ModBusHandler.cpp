@@ -1,344 +1,166 @@
 #include "ModBusHandler.h"
 #include "MQTTHandler.h"
+#include "ReadPlanner.h"
+#include "SlaveTable.h"
+#include "SlaveHealth.h"
+#include "Metrics.h"
+#include "Logger.h"
 #include <Arduino.h>
-#include <ArduinoJson.h>
 
-ModbusSlave slaves[MAX_SLAVES];
-uint8_t slaveCount = 0;
+BusConfig busConfig;
 
 // RS485 DE/RE pin
 #define MAX485_DE 5
 
-#define SLAVE_TIMEOUT_MS 3000  // 5 seconds per slave
-#define TOTAL_QUERY_TIMEOUT_MS 30000  // 30 seconds total
-
-// RS485 control
-void preTransmission()  { digitalWrite(MAX485_DE, HIGH); }
-void postTransmission() { digitalWrite(MAX485_DE, LOW); }
-
-ModbusMaster node;
-
 // Non-blocking query variables
 QueryState queryState = Q_IDLE;
 uint8_t currentQueryIndex = 0;
 unsigned long queryStartTime = 0;
-JsonDocument queryData;
 
-// Convert Modbus register to signed temperature
-float convertRegisterToTemperature(uint16_t regVal) {
-  int16_t tempInt;
-  if (regVal & 0x8000) tempInt = -((0xFFFF - regVal) + 1);
-  else tempInt = regVal;
-  return tempInt * 0.1;
+// Progress through the current slave's read blocks
+static uint8_t blockIndex = 0;
+static bool blockStarted = false;
+static unsigned long blockStartTime = 0;
+
+// Registers of the slave being polled, filled block by block
+static uint16_t slaveImage[MAX_REGS_PER_SLAVE];
+static uint8_t slaveResult = RTU_SUCCESS;
+static uint32_t sampleMicros = 0;
+
+// ESP8266 SerialConfig for the frame format
+static uint8_t busSerialConfig(char parity, uint8_t stopBits) {
+  if (parity == 'E') return stopBits == 2 ? SERIAL_8E2 : SERIAL_8E1;
+  if (parity == 'O') return stopBits == 2 ? SERIAL_8O2 : SERIAL_8O1;
+  return stopBits == 2 ? SERIAL_8N2 : SERIAL_8N1;
 }
 
-// Convert Modbus register to humidity
-float convertRegisterToHumidity(uint16_t regVal) {
-  return regVal * 0.1;
+void setupModbus() {
+    applyBusConfig(busConfig);
+    LOG_INFO("✅ Modbus pins initialized");
 }
 
-void setupModbus() {
-    pinMode(MAX485_DE, OUTPUT);
-    digitalWrite(MAX485_DE, LOW);
-    Serial.println("✅ Modbus pins initialized");
+// Validate and (re)open the bus UART; frame timing follows the new settings
+bool applyBusConfig(const BusConfig& config) {
+  if (config.baud < 1200 || config.baud > 230400) return false;
+  if (config.parity != 'N' && config.parity != 'E' && config.parity != 'O') return false;
+  if (config.stopBits != 1 && config.stopBits != 2) return false;
+  if (config.turnaroundMs < 10 || config.turnaroundMs > 5000) return false;
+  
+  slaveTableChanged();  // drop the transaction in flight, re-estimate bus load
+  busConfig = config;
+  // Turnarounds were measured at the old settings, and dead slaves may just have had the wrong ones
+  for (uint8_t i = 0; i < slaveCount; i++) resetSlaveHealth(slaves[i]);
+  rtuBegin(busConfig.baud, busSerialConfig(busConfig.parity, busConfig.stopBits), MAX485_DE);
+  LOG_INFO("🔌 Bus: %lu baud, 8%c%u, %u ms turnaround", (unsigned long)busConfig.baud, busConfig.parity,
+           busConfig.stopBits, busConfig.turnaroundMs);
+  return true;
 }
 
 // ----------------- NON-BLOCKING MULTI-SLAVE QUERY -----------------
 
-uint8_t readModbusRegisters(uint8_t slaveID, uint16_t startReg, uint16_t numRegs) {
-    static ModbusMaster node;
-    static uint8_t lastSlaveID = 0;
-    
-    // Serial.print("🔧 readModbusRegisters - Slave: ");
-    // Serial.print(slaveID);
-    // Serial.print(", Reg: ");
-    // Serial.print(startReg);
-    // Serial.print(", Count: ");
-    // Serial.println(numRegs);
-    
-    // Re-initialize only when slave ID changes
-    if (slaveID != lastSlaveID) {
-        Serial.print("🔄 Initializing Modbus for Slave ID: ");
-        Serial.println(slaveID);
-        node.begin(1, Serial);
-        node.preTransmission(preTransmission);
-        node.postTransmission(postTransmission);
-        lastSlaveID = slaveID;
-        delay(50); // Increased delay for stabilization
-    }
-    
-    node.clearResponseBuffer();
-    
-    // Serial.println("   Sending Modbus request...");
-    // unsigned long startTime = millis();
-    // uint8_t result = node.readInputRegisters(startReg, numRegs);
-    // unsigned long endTime = millis();
-    
-    // Serial.print("   Modbus transaction took ");
-    // Serial.print(endTime - startTime);
-    // Serial.print("ms, Result: 0x");
-    // Serial.println(result, HEX);
-    
-    // // Enhanced error decoding
-    // if (result != node.ku8MBSuccess) {
-    //     Serial.print("   ❌ MODBUS ERROR: ");
-    //     switch(result) {
-    //         case node.ku8MBResponseTimedOut:
-    //             Serial.println("Response Timeout (0xE2) - No response from slave");
-    //             Serial.println("   → Check: Wiring, Power, Slave ID, Baud rate");
-    //             break;
-    //         case node.ku8MBInvalidSlaveID:
-    //             Serial.println("Invalid Slave ID (0xE0)");
-    //             break;
-    //         case node.ku8MBIllegalDataAddress:
-    //             Serial.println("Illegal Data Address (0x02) - Wrong register");
-    //             break;
-    //         case node.ku8MBIllegalFunction:
-    //             Serial.println("Illegal Function (0x01) - Try holding registers");
-    //             break;
-    //         case node.ku8MBSlaveDeviceFailure:
-    //             Serial.println("Slave Device Failure (0x04)");
-    //             break;
-    //         case node.ku8MBInvalidCRC:
-    //             Serial.println("Invalid CRC (0xE3)");
-    //             break;
-    //         default:
-    //             Serial.print("Unknown error: 0x");
-    //             Serial.println(result, HEX);
-    //             break;
-    //     }
-    // } else {
-    //     Serial.println("   ✅ Modbus request sent successfully");
-    // }
-    
-    return node.readInputRegisters(0, 2);
+// Queue a read on the RTU engine; the reply is collected by rtuPoll()
+bool startModbusRead(const ModbusSlave& slave, uint16_t startReg, uint16_t numRegs) {
+    return rtuStartRead(slave.id, RTU_FC_READ_INPUT_REGISTERS, startReg, numRegs, slaveTimeoutMs(slave));
 }
 
-// Query a single slave and return success status
-bool querySingleSlave(const ModbusSlave& slave, JsonObject& resultObj) {
-
-    // Serial.println();
-    // Serial.print("🎯 STARTING querySingleSlave for: ");
-    // Serial.print(slave.name);
-    // Serial.print(" (ID: ");
-    // Serial.print(slave.id);
-    // Serial.print(")");
-    // Serial.print(" - Reading registers ");
-    // Serial.print(slave.startReg);
-    // Serial.print(" to ");
-    // Serial.println(slave.startReg + slave.numRegs - 1);
+// Start polling one slave; the scheduler decides which one
+bool startSlavePoll(ModbusSlave* slaves, uint8_t slaveCount, uint8_t index) {
+  if (queryState != Q_IDLE || index >= slaveCount) return false;
+  ensureReadPlan(slaves, slaveCount);
   
-    uint8_t result = readModbusRegisters(slave.id, slave.startReg, slave.numRegs);
-
-    resultObj["id"] = slave.id;
-    resultObj["name"] = slave.name;
-    resultObj["startReg"] = slave.startReg;
-    resultObj["numRegs"] = slave.numRegs;
-
-    if (result == node.ku8MBSuccess) {
-        Serial.println("✅ MODBUS SUCCESS - Processing response data:");
-        
-        // Successfully received data
-        if (slave.numRegs >= 1) {
-            uint16_t rawTemp = node.getResponseBuffer(0);
-            float temperature = convertRegisterToTemperature(rawTemp);
-            resultObj["temperature"] = temperature;
-            // Serial.print("   Temperature: Raw=0x");
-            // Serial.print(rawTemp, HEX);
-            // Serial.print(" (");
-            // Serial.print(rawTemp);
-            // Serial.print(") → ");
-            // Serial.print(temperature);
-            // Serial.println("°C");
-        }
-        if (slave.numRegs >= 2) {
-            uint16_t rawHum = node.getResponseBuffer(1);
-            float humidity = convertRegisterToHumidity(rawHum);
-            resultObj["humidity"] = humidity;
-            // Serial.print("   Humidity: Raw=0x");
-            // Serial.print(rawHum, HEX);
-            // Serial.print(" (");
-            // Serial.print(rawHum);
-            // Serial.print(") → ");
-            // Serial.print(humidity);
-            // Serial.println("%");
-        }
-        
-        // Add any additional registers
-        for (uint16_t i = 2; i < slave.numRegs; i++) {
-            String regName = "reg" + String(i);
-            uint16_t regValue = node.getResponseBuffer(i);
-            resultObj[regName] = regValue;
-            // Serial.print("   Register ");
-            // Serial.print(i);
-            // Serial.print(": 0x");
-            // Serial.print(regValue, HEX);
-            // Serial.print(" (");
-            // Serial.print(regValue);
-            // Serial.println(")");
-        }
-        
-        // Serial.print("📊 Slave ");
-        // Serial.print(slave.id);
-        // Serial.print(" (");
-        // Serial.print(slave.name);
-        // Serial.println(") completed successfully");
-        
-        return true;
-    } else {
-        // Error occurred
-        resultObj["error"] = "0x" + String(result, HEX);
-        Serial.print("❌ Slave ");
-        Serial.print(slave.id);
-        Serial.print(" (");
-        Serial.print(slave.name);
-        Serial.print(") FAILED with error: 0x");
-        Serial.println(result, HEX);
-        return false;
-    }
-}
-
-// Start non-blocking query of all slaves
-bool startNonBlockingQuery(ModbusSlave* slaves, uint8_t slaveCount) {
-  if (queryState == Q_IDLE && slaveCount > 0) {
-    queryState = Q_QUERYING;
-    currentQueryIndex = 0;
-    queryStartTime = millis();
-    queryData.clear();
-    JsonArray arr = queryData.to<JsonArray>();
-    
-    Serial.println("🚀 === STARTING NON-BLOCKING SLAVE QUERY ===");
-    Serial.print("📋 Number of slaves to query: ");
-    Serial.println(slaveCount);
-    
-    // // Debug: Show all slaves that will be queried
-    // for (uint8_t i = 0; i < slaveCount; i++) {
-    //     Serial.print("   Slave ");
-    //     Serial.print(i);
-    //     Serial.print(": ID=");
-    //     Serial.print(slaves[i].id);
-    //     Serial.print(", Name='");
-    //     Serial.print(slaves[i].name);
-    //     Serial.print("', Reg=");
-    //     Serial.print(slaves[i].startReg);
-    //     Serial.print(", Count=");
-    //     Serial.println(slaves[i].numRegs);
-    // }
-    
-    return true;
-  }
-  return false;
+  queryState = Q_QUERYING;
+  currentQueryIndex = index;
+  queryStartTime = millis();
+  blockIndex = 0;
+  blockStarted = false;
+  return true;
 }
 
-bool continueNonBlockingQuery(ModbusSlave* slaves, uint8_t slaveCount) {
+// Walk the slave's read blocks; true once slavePollResult()/slavePollImage() hold the outcome
+bool continueSlavePoll(ModbusSlave* slaves) {
   if (queryState != Q_QUERYING) return false;
   
-  // Overall timeout check
-  if (millis() - queryStartTime > TOTAL_QUERY_TIMEOUT_MS) {
-    queryState = Q_ERROR;
-    Serial.println("⏰ !!! QUERY TIMEOUT - STOPPING EARLY !!!");
-    return true;
-  }
-  
-  static unsigned long slaveStartTime = 0;
-  static bool slaveInProgress = false;
+  ModbusSlave& slave = slaves[currentQueryIndex];
+  uint8_t result = RTU_SUCCESS;
+  bool slaveDone = false;
   
-  // START new slave query
-  if (!slaveInProgress) {
-    if (currentQueryIndex < slaveCount) {
-      slaveInProgress = true;
-      slaveStartTime = millis();
-      
-      // Serial.println();
-      // Serial.print("🔍 Querying slave [");
-      // Serial.print(currentQueryIndex + 1);
-      // Serial.print("/");
-      // Serial.print(slaveCount);
-      // Serial.print("]: ");
-      // Serial.print(slaves[currentQueryIndex].name);
-      // Serial.print(" (ID: ");
-      // Serial.print(slaves[currentQueryIndex].id);
-      // Serial.println(")");
-      
-    } else {
-      // All slaves processed
-      queryState = Q_COMPLETE;
-      Serial.println("🎉 === QUERY COMPLETED ===");
-      return true;
-    }
-  }
-  
-  // CHECK timeout for current slave
-  if (slaveInProgress && (millis() - slaveStartTime > SLAVE_TIMEOUT_MS)) {
-    // Serial.print("⏰ !!! Slave ");
-    // Serial.print(slaves[currentQueryIndex].id);
-    // Serial.print(" (");
-    // Serial.print(slaves[currentQueryIndex].name);
-    // Serial.println(") timeout - skipping !!!");
-    
-    JsonObject obj = queryData.add<JsonObject>();
-    obj["id"] = slaves[currentQueryIndex].id;
-    obj["name"] = slaves[currentQueryIndex].name;
-    obj["error"] = "timeout";
-    
-    slaveInProgress = false;
-    currentQueryIndex++;
-    
-    // Check if this was the last slave
-    if (currentQueryIndex >= slaveCount) {
-      queryState = Q_COMPLETE;
-      return true;
+  if (blockIndex >= slavePlanCount[currentQueryIndex]) {
+    slaveDone = true;
+  } else {
+    const ReadBlock& block = readPlan[slavePlanFirst[currentQueryIndex] + blockIndex];
+    if (!blockStarted) {
+      if (!startModbusRead(slave, block.start, block.count)) return false;
+      blockStarted = true;
+      blockStartTime = millis();
     }
-    return false;
-  }
-  
-  // PROCESS current slave (if no timeout)
-  if (slaveInProgress && currentQueryIndex < slaveCount) {
-    JsonObject obj = queryData.add<JsonObject>();
-    bool success = querySingleSlave(slaves[currentQueryIndex], obj);
     
-    if (success) {
-      Serial.print("✅ Slave ");
-      Serial.print(slaves[currentQueryIndex].id);
-      Serial.println(" completed successfully");
+    // CHECK timeout for this block (backstop, the engine times out first)
+    uint32_t limitMs = rtuTimeoutMillis(8, 5 + block.count * 2, slaveTimeoutMs(slave));
+    if (millis() - blockStartTime > 2 * limitMs) {
+      rtuAbort();
+      blockStarted = false;
+      result = RTU_RESPONSE_TIMED_OUT;
+      slaveDone = true;
     } else {
-      Serial.print("❌ Slave ");
-      Serial.print(slaves[currentQueryIndex].id);
-      Serial.println(" failed");
-    }
-    
-    slaveInProgress = false;
-    currentQueryIndex++;
-    
-    // Check if all slaves are done
-    if (currentQueryIndex >= slaveCount) {
-      queryState = Q_COMPLETE;
-      Serial.println("🎉 === NON-BLOCKING QUERY COMPLETED ===");
-      Serial.print("📊 Total slaves processed: ");
-      Serial.println(slaveCount);
-      return true;
+      // ADVANCE the engine by a few bytes; come back next loop() if not done
+      if (rtuPoll() != RTU_DONE) return false;
+      blockStarted = false;
+      
+      result = rtuResult();
+      histogramAdd(transactionHist, rtuTransactionMicros());
+      if (rtuTurnaroundMicros()) recordTurnaround(slave, rtuTurnaroundMicros());
+      if (result == RTU_SUCCESS) {
+        if (blockIndex == 0) sampleMicros = rtuReplyMicros();
+        copyBlockToImage(slave, block, slaveImage);
+        blockIndex++;
+        slaveDone = blockIndex >= slavePlanCount[currentQueryIndex];
+      } else {
+        slaveDone = true;  // skip the slave's remaining blocks
+      }
     }
   }
   
-  return false; // Still processing
+  if (!slaveDone) return false;
+  
+  if (result != RTU_SUCCESS) {
+    LOG_WARN("❌ Slave %u (%s) FAILED with error: 0x%02X", slave.id, slaveName(slave), result);
+    sampleMicros = micros();
+  }
+  slaveResult = result;
+  queryState = Q_COMPLETE;
+  return true;
 }
 
-// Get query results as JSON string
-String getQueryResults() {
-  String output;
-  serializeJson(queryData, output);
-  
-  Serial.println("📄 === QUERY RESULTS ===");
-  serializeJsonPretty(queryData, Serial);
-  Serial.println();
-  Serial.println("=====================");
-  
-  return output;
+// Drop an in-flight poll, e.g. because slaves[] is about to change
+void cancelSlavePoll() {
+  if (queryState == Q_QUERYING) {
+    rtuAbort();
+    queryState = Q_IDLE;
+  }
+}
+
+// Call after adding, deleting or loading slaves
+void slaveTableChanged() {
+  cancelSlavePoll();
+  invalidateReadPlan();
+}
+
+// Outcome of the poll that just completed (valid while queryState is Q_COMPLETE)
+uint8_t slavePollResult() {
+  return slaveResult;
+}
+
+const uint16_t* slavePollImage() {
+  return slaveImage;
+}
+
+// When the poll's first reply frame arrived, or when a failed poll gave up
+uint32_t slavePollSampleMicros() {
+  return sampleMicros;
 }
 
 // Reset query state for next poll
 void resetQueryState() {
   queryState = Q_IDLE;
-  currentQueryIndex = 0;
-  Serial.println("🔄 Query state reset to Q_IDLE");
+  LOG_DEBUG("🔄 Query state reset to Q_IDLE");
 }
\ No newline at end of file
@@ -1,8 +1,26 @@
 #pragma once
-#include <ModbusMaster.h>
-#include <ArduinoJson.h>
+#include "RtuMaster.h"
 
-#define MAX_SLAVES 10
+// The host build takes every RTU address (1-247); the ESP8266 one as many
+// as one RS485 segment carries without repeaters, which is what fits next to
+// WiFi (see SlaveTable.h for the memory budget). Override with
+// -DMAX_SLAVES=... either way.
+#ifndef MAX_SLAVES
+#ifdef ESP8266
+#define MAX_SLAVES 32
+#else
+#define MAX_SLAVES 247
+#endif
+#endif
+#define MAX_EXTRA_RANGES 3      // register ranges per slave besides startReg/numRegs
+#define MAX_REGS_PER_SLAVE 64   // all ranges of one slave together
+#define DEFAULT_POLL_MS 3000    // poll period for slaves that don't set pollMs
+#define MIN_POLL_MS 100
+#define DEFAULT_MAX_GAP 8       // 16 extra reply bytes still beat a second round trip (~20 chars)
+#define MAX_DEADBAND_OVERRIDES 4  // registers with their own deadband, per slave
+#define MAX_FIELDS_PER_SLAVE 16   // decoded values per slave, see RegisterMap
+#define DEFAULT_BAUD 9600
+#define DEFAULT_TURNAROUND_MS 1000  // slave think time allowed before its first reply byte
 
 enum QueryState { 
   Q_IDLE, 
@@ -11,28 +29,148 @@ enum QueryState {
   Q_ERROR 
 };
 
+struct RegRange {
+  uint16_t start;
+  uint16_t count;
+};
+
+// Line settings shared by every slave on the segment (saved with the slaves)
+struct BusConfig {
+  uint32_t baud = DEFAULT_BAUD;
+  char parity = 'N';          // 'N', 'E' or 'O'
+  uint8_t stopBits = 1;
+  uint16_t turnaroundMs = DEFAULT_TURNAROUND_MS;
+};
+
+// Deadband for one register address; overrides the slave-wide one
+struct RegDeadband {
+  uint16_t reg;
+  uint16_t absolute;       // raw counts (tenths for temperature/humidity)
+  uint8_t percent;         // of the last reported value
+};
+
+// One decoded value: where it sits in the slave's registers and how to turn
+// it into engineering units (value = raw * scale + offset)
+struct RegField {
+  uint16_t reg;           // address of the first register (raw fields: the regN key)
+  uint8_t type;           // FIELD_* | FIELD_WORD_SWAP
+  uint8_t name;           // index into the field name pool
+  uint8_t index;          // position in the slave's register image (resolved at config time)
+  uint8_t decimals;       // digits after the point when published
+  float offset;
+  double scale;           // float would turn 0.01 * 123456789 into 1234567.86
+};
+
+// Running statistics of one field over the current summary window, see
+// WindowAggregator
+struct WindowField {
+  double min;
+  double max;
+  double sum;
+  double last;
+  uint32_t count;         // samples with a finite value
+};
+
+// One entry of the slave table. Variable-sized parts (name, register map,
+// deadband overrides, register images) live in SlaveTable's static pools and
+// runtime state in its arrays, both reached through its accessors; the
+// record itself stays small.
 struct ModbusSlave {
   uint8_t id;
   uint16_t startReg;
   uint16_t numRegs;
-  String name;
+  uint16_t name;                           // name arena offset, see slaveName()
+  RegRange extraRanges[MAX_EXTRA_RANGES];  // further ranges read in the same poll
+  uint8_t extraRangeCount = 0;
+  uint8_t maxGap = DEFAULT_MAX_GAP;        // unused registers the planner may read through
+  uint32_t pollMs = DEFAULT_POLL_MS;       // poll period
+  uint32_t cacheMs = 0;                    // oldest cached value served, 0 = pollMs, see RegisterCache
+  bool fixedRate = false;                  // polls on a fixed grid of pollMs, see PollScheduler
+  uint32_t windowMs = 0;                   // publish summaries over windows this long, 0 = every poll
+  bool windowRaw = false;                  // ...and every poll as well, see WindowAggregator
+  uint16_t deadband = 0;                   // report-by-exception thresholds, see ResultPublisher
+  uint8_t deadbandPct = 0;
+  uint8_t regDeadbandCount = 0;            // overrides at firstDeadband, see slaveDeadbands()
+  uint16_t firstDeadband = 0;
+  uint8_t fieldCount = 0;                  // register map at firstField, see slaveFields();
+  uint16_t firstField = 0;                 // empty = temperature/humidity/regN
+  uint16_t image = 0;                      // image pool offset, see slaveReportedImage()
+  uint8_t imageWords = 0;                  // registers per image
+  uint16_t firstWindow = 0;                // window pool offset, see slaveWindows()
+  uint8_t windowFields = 0;                // 0 unless windowMs is set
+  uint32_t journalHash = 0;                // of its last config journal record, see ConfigJournal
+};
+
+// Runtime state lives beside the table rather than in ModbusSlave, one entry
+// per table position, so the record holds configuration only. SlaveTable
+// moves it along with its slave; reach it through slaveSchedule() etc.
+
+// Scheduler state, see PollScheduler
+struct SlaveSchedule {
+  unsigned long nextPollDue = 0;
+  uint32_t pollCount = 0;
+  uint32_t deadlineMisses = 0;             // polls that finished after the next one was due
+  uint32_t maxLateMs = 0;
+  uint32_t skippedPolls = 0;               // fixed-rate periods dropped after falling behind
+};
+
+// When the last poll's reply arrived, and how evenly successive samples are
+// spaced, see PollScheduler
+struct SlaveSampling {
+  unsigned long sampleTime = 0;            // millis()
+  uint32_t sampleMicros = 0;
+  uint32_t jitter16 = 0;                   // smoothed |spacing - pollMs| in us, times 16
+  uint32_t maxJitterUs = 0;
+  uint32_t jitterSamples = 0;
+  bool sampled = false;                    // sampleTime is valid
+  bool spacingValid = false;               // sampleMicros starts a spacing measurement
+};
+
+// Turnaround statistics, error window and breaker, see SlaveHealth
+struct SlaveHealth {
+  uint16_t rttSmooth = 0;                  // turnaround in 0.1 ms
+  uint16_t rttVar = 0;
+  uint16_t timeoutMs = 0;                  // learned reply timeout, 0 = turnaroundMs
+  uint16_t recentFailures = 0;             // one bit per poll, newest lowest
+  uint8_t recentPolls = 0;
+  uint8_t rttSamples = 0;
+  uint8_t timeoutStreak = 0;
+  uint8_t probeLevel = 0;                  // 0 = breaker closed, else probing every 10 s << (n - 1)
+};
+
+// The summary window in progress, see WindowAggregator
+struct WindowState {
+  bool open = false;
+  unsigned long end = 0;                   // millis()
+  uint32_t polls = 0;                      // successful polls in the window
+  uint32_t errors = 0;                     // failed ones
+};
+
+// A reading as last reported (report-by-exception, see ResultPublisher) or
+// last polled (/data and /events, see LiveData)
+struct SlaveReading {
+  uint8_t result = RTU_SUCCESS;
+  bool valid = false;                      // the matching image and result are valid
+  unsigned long time = 0;                  // millis()
 };
 
+extern BusConfig busConfig;
 extern ModbusSlave slaves[MAX_SLAVES];
 extern uint8_t slaveCount;
 
-// Non-blocking query variables
+// Non-blocking query variables (one slave at a time)
 extern QueryState queryState;
 extern uint8_t currentQueryIndex;
 extern unsigned long queryStartTime;
-extern JsonDocument queryData;
 
 // Function declarations
 void setupModbus();
-bool startNonBlockingQuery(ModbusSlave* slaves, uint8_t slaveCount);
-bool continueNonBlockingQuery(ModbusSlave* slaves, uint8_t slaveCount);
-String getQueryResults();
-void resetQueryState();
-bool querySingleSlave(const ModbusSlave& slave, JsonObject& resultObj);
-float convertRegisterToTemperature(uint16_t regVal);
-float convertRegisterToHumidity(uint16_t regVal);
\ No newline at end of file
+bool applyBusConfig(const BusConfig& config);
+bool startSlavePoll(ModbusSlave* slaves, uint8_t slaveCount, uint8_t index);
+bool continueSlavePoll(ModbusSlave* slaves);
+void cancelSlavePoll();
+void slaveTableChanged();
+uint8_t slavePollResult();
+const uint16_t* slavePollImage();
+uint32_t slavePollSampleMicros();
+void resetQueryState();
\ No newline at end of file
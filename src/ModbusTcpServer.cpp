@@ -0,0 +1,393 @@
+#include "ModbusTcpServer.h"
+#include <ESP8266WiFi.h>
+#include "ModBusHandler.h"
+#include "RtuMaster.h"
+#include "ReadPlanner.h"
+#include "RegisterCache.h"
+#include "SlaveTable.h"
+#include "SlaveHealth.h"
+#include "Metrics.h"
+#include "Logger.h"
+
+#define MBAP_HEADER 7   // transaction ID, protocol ID, length, unit ID
+
+ModbusTcpStats modbusTcpStats;
+
+struct TcpConnection {
+  WiFiClient client;
+  bool open;
+  uint8_t generation;       // bumped per connection, so late replies can't reach a newcomer
+  uint8_t queued;           // requests waiting or on the bus
+  uint16_t rxLength;
+  unsigned long lastActivity;
+  uint8_t rx[MBAP_HEADER + MODBUS_TCP_MAX_PDU];
+};
+
+struct TcpRequest {
+  uint8_t slot;
+  uint8_t generation;
+  uint16_t transactionId;
+  uint8_t unitId;
+  uint8_t pduLength;
+  bool cached;              // waiting for a cache refresh instead of the bus, see RegisterCache
+  unsigned long queuedAt;
+  uint8_t pdu[MODBUS_TCP_MAX_PDU];
+};
+
+WiFiServer modbusTcpServer(MODBUS_TCP_PORT);
+static TcpConnection connections[MODBUS_TCP_MAX_CLIENTS];
+
+// Waiting requests in service order, and the one on the bus
+static TcpRequest requestQueue[MODBUS_TCP_QUEUE_SIZE];
+static uint8_t queueCount = 0;
+static TcpRequest activeRequest;
+static bool requestActive = false;
+static unsigned long activeStart = 0;
+static uint16_t activeTimeoutMs = 0;
+static uint32_t seenCacheUpdates = 0;
+
+// ----------------- Replies -----------------
+
+static void sendReply(const TcpRequest& request, const uint8_t* pdu, uint16_t length) {
+  TcpConnection& conn = connections[request.slot];
+  if (!conn.open || conn.generation != request.generation) {
+    modbusTcpStats.orphaned++;
+    return;
+  }
+  conn.queued--;
+  static uint8_t frame[MBAP_HEADER + MODBUS_TCP_MAX_PDU];
+  frame[0] = request.transactionId >> 8;
+  frame[1] = request.transactionId & 0xFF;
+  frame[2] = 0;
+  frame[3] = 0;
+  frame[4] = (length + 1) >> 8;
+  frame[5] = (length + 1) & 0xFF;
+  frame[6] = request.unitId;
+  memcpy(frame + MBAP_HEADER, pdu, length);
+  conn.client.write(frame, MBAP_HEADER + length);
+}
+
+static void sendException(const TcpRequest& request, uint8_t code) {
+  uint8_t pdu[2] = {(uint8_t)(request.pdu[0] | 0x80), code};
+  sendReply(request, pdu, sizeof(pdu));
+}
+
+// FC04 reply from cached registers
+static void sendRegisters(const TcpRequest& request, const uint16_t* values) {
+  uint8_t count = request.pdu[4];
+  uint8_t pdu[2 + 2 * MODBUS_MAX_READ_REGS];
+  pdu[0] = RTU_FC_READ_INPUT_REGISTERS;
+  pdu[1] = 2 * count;
+  for (uint8_t i = 0; i < count; i++) {
+    pdu[2 + 2 * i] = values[i] >> 8;
+    pdu[3 + 2 * i] = values[i] & 0xFF;
+  }
+  modbusTcpStats.cached++;
+  sendReply(request, pdu, 2 + 2 * count);
+}
+
+// ----------------- Cache -----------------
+
+// Reads of polled input registers go through the register cache; anything
+// else is CACHE_UNCACHED and goes to the slave
+static uint8_t cacheRead(const TcpRequest& request, uint16_t* values, bool waiting) {
+  if (request.pdu[0] != RTU_FC_READ_INPUT_REGISTERS || request.pduLength != 5) return CACHE_UNCACHED;
+  uint16_t start = ((uint16_t)request.pdu[1] << 8) | request.pdu[2];
+  uint16_t count = ((uint16_t)request.pdu[3] << 8) | request.pdu[4];
+  ModbusSlave* slave = findSlaveById(request.unitId);
+  if (!slave || count == 0 || count > MODBUS_MAX_READ_REGS) return CACHE_UNCACHED;
+  uint32_t ageMs;
+  return cacheLookup(*slave, start, count, slaveCacheMs(*slave), request.queuedAt, waiting, values, ageMs);
+}
+
+// ----------------- Queue -----------------
+
+static bool isWrite(uint8_t function) {
+  return function == 0x05 || function == 0x06 || function == 0x0F || function == 0x10 || function == 0x16 ||
+         function == 0x17;
+}
+
+static void removeQueued(uint8_t index) {
+  queueCount--;
+  for (uint8_t i = index; i < queueCount; i++) requestQueue[i] = requestQueue[i + 1];
+}
+
+// First request that needs the bus, queueCount if none
+static uint8_t firstBusRequest() {
+  uint8_t i = 0;
+  while (i < queueCount && requestQueue[i].cached) i++;
+  return i;
+}
+
+// Run when the cache changed: parked reads are answered from it, or with
+// 0x0B if their refresh failed
+static void answerCachedRequests() {
+  uint16_t values[MODBUS_MAX_READ_REGS];
+  for (uint8_t i = 0; i < queueCount;) {
+    TcpRequest& request = requestQueue[i];
+    uint8_t lookup = request.cached ? cacheRead(request, values, true) : CACHE_MISS;
+    if (lookup == CACHE_HIT) {
+      sendRegisters(request, values);
+    } else if (lookup == CACHE_FAILED) {
+      modbusTcpStats.noReply++;
+      sendException(request, MODBUS_EX_TARGET_NO_REPLY);
+    } else {
+      if (lookup == CACHE_UNCACHED) request.cached = false;  // slave reconfigured: ask it directly
+      i++;
+      continue;
+    }
+    removeQueued(i);
+  }
+}
+
+// Writes go behind the writes already waiting but ahead of every read
+static TcpRequest* insertRequest(bool write) {
+  uint8_t at = queueCount;
+  if (write) {
+    at = 0;
+    while (at < queueCount && isWrite(requestQueue[at].pdu[0])) at++;
+  }
+  for (uint8_t i = queueCount; i > at; i--) requestQueue[i] = requestQueue[i - 1];
+  queueCount++;
+  return &requestQueue[at];
+}
+
+// Requests of a closed connection would only be answered into the void
+static void dropQueued(uint8_t slot) {
+  for (uint8_t i = 0; i < queueCount;) {
+    if (requestQueue[i].slot == slot && requestQueue[i].generation == connections[slot].generation) {
+      removeQueued(i);
+    } else {
+      i++;
+    }
+  }
+}
+
+// ----------------- Connections -----------------
+
+static void closeConnection(uint8_t slot, const char* why) {
+  TcpConnection& conn = connections[slot];
+  dropQueued(slot);
+  conn.client.stop();
+  conn.open = false;
+  LOG_INFO("🔌 Modbus TCP client %u closed (%s)", slot, why);
+}
+
+static void acceptConnections() {
+  while (modbusTcpServer.hasClient()) {
+    WiFiClient client = modbusTcpServer.accept();
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < MODBUS_TCP_MAX_CLIENTS && slot < 0; i++) {
+      if (!connections[i].open) slot = i;
+    }
+    if (slot < 0) {
+      LOG_WARN("⚠️ Modbus TCP: %u clients already connected, refusing another", MODBUS_TCP_MAX_CLIENTS);
+      client.stop();
+      continue;
+    }
+    TcpConnection& conn = connections[slot];
+    conn.client = client;
+    conn.client.setNoDelay(true);
+    conn.open = true;
+    conn.generation++;
+    conn.queued = 0;
+    conn.rxLength = 0;
+    conn.lastActivity = millis();
+    modbusTcpStats.connections++;
+    LOG_INFO("🔌 Modbus TCP client %u connected", slot);
+  }
+}
+
+// One complete MBAP frame in conn.rx
+static void queueRequest(uint8_t slot) {
+  TcpConnection& conn = connections[slot];
+  TcpRequest request;
+  request.slot = slot;
+  request.generation = conn.generation;
+  request.transactionId = ((uint16_t)conn.rx[0] << 8) | conn.rx[1];
+  request.unitId = conn.rx[6];
+  request.pduLength = conn.rxLength - MBAP_HEADER;
+  request.cached = false;
+  request.queuedAt = millis();
+  memcpy(request.pdu, conn.rx + MBAP_HEADER, request.pduLength);
+  modbusTcpStats.requests++;
+  conn.queued++;  // sendReply() takes it off again
+
+  uint8_t reject = 0;
+  if (request.pdu[0] == 0 || (request.pdu[0] & 0x80)) {
+    reject = MODBUS_EX_ILLEGAL_FUNCTION;
+  } else if (request.unitId < SLAVE_ID_MIN || request.unitId > SLAVE_ID_MAX) {
+    reject = MODBUS_EX_PATH_UNAVAILABLE;  // no broadcasts: a TCP client always waits for an answer
+  } else {
+    uint16_t values[MODBUS_MAX_READ_REGS];
+    uint8_t lookup = cacheRead(request, values, false);
+    if (lookup == CACHE_HIT) {
+      sendRegisters(request, values);
+      return;
+    }
+    request.cached = lookup == CACHE_MISS;
+
+    // Same transaction ID again: the client gave up on the earlier one
+    for (uint8_t i = 0; i < queueCount; i++) {
+      const TcpRequest& queued = requestQueue[i];
+      if (queued.slot == slot && queued.generation == conn.generation && queued.transactionId == request.transactionId) {
+        removeQueued(i);
+        conn.queued--;
+        break;
+      }
+    }
+    if (queueCount >= MODBUS_TCP_QUEUE_SIZE || conn.queued > MODBUS_TCP_CLIENT_QUEUED) reject = MODBUS_EX_SERVER_BUSY;
+  }
+  if (reject) {
+    modbusTcpStats.rejected++;
+    sendException(request, reject);
+    return;
+  }
+  *insertRequest(isWrite(request.pdu[0])) = request;
+  LOG_DEBUG("Modbus TCP client %u: tid %u, unit %u, fc 0x%02X queued (%u waiting)", slot, request.transactionId,
+            request.unitId, request.pdu[0], queueCount);
+}
+
+// Collects MBAP frames; a broken header closes the connection, as there is
+// no way to find the next frame boundary
+static void readRequests(uint8_t slot) {
+  TcpConnection& conn = connections[slot];
+  while (conn.client.available() > 0) {
+    uint16_t frameLength = MBAP_HEADER;
+    if (conn.rxLength >= MBAP_HEADER) frameLength = 6 + (((uint16_t)conn.rx[4] << 8) | conn.rx[5]);
+    int n = conn.client.read(conn.rx + conn.rxLength, frameLength - conn.rxLength);
+    if (n <= 0) return;
+    conn.rxLength += n;
+    conn.lastActivity = millis();
+    if (conn.rxLength < frameLength) continue;
+
+    if (frameLength == MBAP_HEADER) {
+      uint16_t protocol = ((uint16_t)conn.rx[2] << 8) | conn.rx[3];
+      uint16_t length = ((uint16_t)conn.rx[4] << 8) | conn.rx[5];
+      if (protocol != 0 || length < 2 || length > 1 + MODBUS_TCP_MAX_PDU) {
+        closeConnection(slot, "bad MBAP header");
+        return;
+      }
+      continue;
+    }
+    queueRequest(slot);
+    conn.rxLength = 0;
+  }
+}
+
+// ----------------- Service -----------------
+
+void setupModbusTcp() {
+  modbusTcpServer.begin();
+  modbusTcpServer.setNoDelay(true);
+  LOG_INFO("🔌 Modbus TCP server on port %u", MODBUS_TCP_PORT);
+}
+
+// Run from loop(): accepts clients, queues their requests and answers the
+// ones that waited too long. The bus side is startTcpRequest() /
+// continueTcpRequest().
+void serviceModbusTcp() {
+  acceptConnections();
+  if (cacheUpdates() != seenCacheUpdates) {
+    seenCacheUpdates = cacheUpdates();
+    answerCachedRequests();
+  }
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    TcpConnection& conn = connections[i];
+    if (!conn.open) continue;
+    if (!conn.client.connected()) {
+      closeConnection(i, "by peer");
+    } else if (now - conn.lastActivity >= MODBUS_TCP_IDLE_MS && !conn.queued) {
+      closeConnection(i, "idle");
+    } else {
+      readRequests(i);
+    }
+  }
+  for (uint8_t i = 0; i < queueCount;) {
+    if (now - requestQueue[i].queuedAt < MODBUS_TCP_QUEUE_TIMEOUT_MS) {
+      i++;
+      continue;
+    }
+    modbusTcpStats.expired++;
+    sendException(requestQueue[i], MODBUS_EX_TARGET_NO_REPLY);
+    removeQueued(i);
+  }
+}
+
+uint8_t modbusTcpClientCount() {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) n += connections[i].open;
+  return n;
+}
+
+uint8_t modbusTcpQueued() {
+  return queueCount;
+}
+
+// Whether a request is waiting for the bus (cached reads wait for the cache)
+bool tcpRequestPending() {
+  return firstBusRequest() < queueCount;
+}
+
+bool tcpRequestActive() {
+  return requestActive;
+}
+
+// ----------------- Bus Side -----------------
+
+// Puts the first queued request that needs the bus on it; the caller makes
+// sure no poll is running
+bool startTcpRequest() {
+  while (!requestActive && !rtuBusy()) {
+    uint8_t next = firstBusRequest();
+    if (next >= queueCount) return false;
+    activeRequest = requestQueue[next];
+    removeQueued(next);
+    ModbusSlave* slave = findSlaveById(activeRequest.unitId);
+    activeTimeoutMs = slave ? slaveTimeoutMs(*slave) : busConfig.turnaroundMs;
+    // Behind an open breaker only the probes go to the slave
+    if ((slave && slaveHealth(*slave).probeLevel) ||
+        !rtuStartRequest(activeRequest.unitId, activeRequest.pdu, activeRequest.pduLength, activeTimeoutMs)) {
+      modbusTcpStats.noReply++;
+      sendException(activeRequest, MODBUS_EX_TARGET_NO_REPLY);
+      continue;
+    }
+    requestActive = true;
+    activeStart = millis();
+    return true;
+  }
+  return false;
+}
+
+// Advances the request on the bus; true once it has been answered
+bool continueTcpRequest() {
+  if (!requestActive) return false;
+
+  // Backstop as for polls; the engine times out first. An idle engine means
+  // the bus settings changed under the request.
+  uint32_t limitMs = rtuTimeoutMillis(activeRequest.pduLength + 3, RTU_MAX_FRAME, activeTimeoutMs);
+  RtuState state = RTU_IDLE;
+  if (millis() - activeStart > 2 * limitMs) rtuAbort();
+  else state = rtuPoll();
+  if (state != RTU_IDLE && state != RTU_DONE) return false;
+  requestActive = false;
+
+  uint16_t length = 0;
+  const uint8_t* pdu = state == RTU_DONE ? rtuResponsePdu(length) : nullptr;
+  if (state == RTU_DONE) {
+    histogramAdd(transactionHist, rtuTransactionMicros());
+    ModbusSlave* slave = findSlaveById(activeRequest.unitId);
+    if (slave && rtuTurnaroundMicros()) recordTurnaround(*slave, rtuTurnaroundMicros());
+  }
+  if (pdu) {
+    modbusTcpStats.replies++;
+    sendReply(activeRequest, pdu, length);
+  } else {
+    modbusTcpStats.noReply++;
+    LOG_DEBUG("Modbus TCP: unit %u fc 0x%02X failed with 0x%02X", activeRequest.unitId, activeRequest.pdu[0],
+              state == RTU_DONE ? rtuResult() : RTU_RESPONSE_TIMED_OUT);
+    sendException(activeRequest, MODBUS_EX_TARGET_NO_REPLY);
+  }
+  return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+// Modbus TCP server that proxies to the RTU bus. MBAP requests from up to
+// MODBUS_TCP_MAX_CLIENTS connections wait in one bounded queue (writes ahead
+// of reads, otherwise in arrival order) and are sent to the slave whose
+// address is the unit ID. The bus task in main.cpp hands the bus to a queued
+// request and a due poll in turn, so neither starves the other and only one
+// master is ever on the wire. FC04 reads of polled registers are answered
+// from the register cache, or wait there for one refresh shared by all of
+// them. Replies go back with the request's transaction ID; a request that
+// can't reach the bus in time, or whose slave doesn't answer, gets
+// exception 0x0B.
+
+#define MODBUS_TCP_PORT 502
+#define MODBUS_TCP_MAX_CLIENTS 4
+#define MODBUS_TCP_QUEUE_SIZE 8
+#define MODBUS_TCP_CLIENT_QUEUED 4          // per connection, so one client can't fill the queue
+#define MODBUS_TCP_QUEUE_TIMEOUT_MS 3000UL  // longest wait for the bus
+#define MODBUS_TCP_IDLE_MS 120000UL         // silent connections are closed
+#define MODBUS_TCP_MAX_PDU 253
+
+// Exception codes the gateway answers with itself
+#define MODBUS_EX_ILLEGAL_FUNCTION 0x01
+#define MODBUS_EX_SERVER_BUSY      0x06     // queue full
+#define MODBUS_EX_PATH_UNAVAILABLE 0x0A     // unit ID isn't a slave address
+#define MODBUS_EX_TARGET_NO_REPLY  0x0B     // timeout, garbled reply, or waited too long
+
+struct ModbusTcpStats {
+  uint32_t connections;
+  uint32_t requests;
+  uint32_t replies;      // slave answers passed back, exceptions included
+  uint32_t cached;       // FC04 reads answered from the register cache
+  uint32_t noReply;      // answered 0x0B: slave silent, reply garbled or breaker open
+  uint32_t expired;      // answered 0x0B: waited too long for the bus
+  uint32_t rejected;     // answered 0x06 or 0x0A without touching the bus
+  uint32_t orphaned;     // finished after the client had gone
+};
+
+extern WiFiServer modbusTcpServer;
+extern ModbusTcpStats modbusTcpStats;
+
+// Function declarations
+void setupModbusTcp();
+void serviceModbusTcp();
+uint8_t modbusTcpClientCount();
+uint8_t modbusTcpQueued();
+bool tcpRequestPending();
+bool tcpRequestActive();
+bool startTcpRequest();
+bool continueTcpRequest();
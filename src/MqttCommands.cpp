@@ -0,0 +1,168 @@
+#include "MqttCommands.h"
+#include <ArduinoJson.h>
+#include "MQTTHandler.h"
+#include "ResultPublisher.h"
+#include "ReadPlanner.h"
+#include "RegisterCache.h"
+#include "WriteQueue.h"
+#include "SlaveTable.h"
+#include "Logger.h"
+
+struct PendingRead {
+  bool used;
+  bool counted;            // looked up once already, see cacheLookup()
+  uint8_t slaveId;
+  uint16_t start;
+  uint16_t count;
+  uint32_t maxAgeMs;       // 0 = the slave's cacheMs
+  unsigned long since;
+  char ref[MQTT_REF_MAX + 1];
+};
+
+static PendingRead pendingReads[MQTT_MAX_PENDING_READS];
+static uint32_t seenCacheUpdates = 0;
+static char subscribedPrefix[MAX_TOPIC_PREFIX + 1] = "";
+static bool subscribed = false;
+
+static void commandTopic(char* topic, size_t size, const char* command) {
+  snprintf(topic, size, "%s/%s", publishConfig.prefix, command);
+}
+
+// ----------------- Replies -----------------
+
+static void sendReadReply(const PendingRead& read, const uint16_t* values, uint32_t ageMs, const char* error) {
+  JsonDocument doc;
+  doc["ref"] = read.ref;
+  doc["id"] = read.slaveId;
+  if (error) {
+    doc["error"] = error;
+  } else {
+    doc["start"] = read.start;
+    JsonArray array = doc["values"].to<JsonArray>();
+    for (uint16_t i = 0; i < read.count; i++) array.add(values[i]);
+    doc["ageMs"] = ageMs;
+  }
+  static char payload[64 + 6 * MODBUS_MAX_READ_REGS];
+  size_t length = serializeJson(doc, payload, sizeof(payload));
+  char topic[MAX_TOPIC_PREFIX + 16];
+  commandTopic(topic, sizeof(topic), "read/reply");
+  publishPayload(topic, payload, length);
+}
+
+// Answers the read if it can be; false while it waits for a refresh
+static bool serviceRead(PendingRead& read) {
+  ModbusSlave* slave = findSlaveById(read.slaveId);
+  if (!slave) {
+    sendReadReply(read, nullptr, 0, "unknown slave");
+    return true;
+  }
+  uint16_t values[MODBUS_MAX_READ_REGS];
+  uint32_t ageMs;
+  uint32_t maxAgeMs = read.maxAgeMs ? read.maxAgeMs : slaveCacheMs(*slave);
+  uint8_t lookup = cacheLookup(*slave, read.start, read.count, maxAgeMs, read.since, read.counted, values, ageMs);
+  read.counted = true;
+  switch (lookup) {
+    case CACHE_HIT:
+      sendReadReply(read, values, ageMs, nullptr);
+      return true;
+    case CACHE_FAILED:
+      sendReadReply(read, nullptr, 0, "no reply");
+      return true;
+    case CACHE_UNCACHED:
+      sendReadReply(read, nullptr, 0, "registers not polled");
+      return true;
+  }
+  if (millis() - read.since < MQTT_READ_TIMEOUT_MS) return false;
+  sendReadReply(read, nullptr, 0, "timeout");
+  return true;
+}
+
+// ----------------- Messages -----------------
+
+// Runs inside mqttClient.loop(): only queues the command
+static void onMessage(char* topic, uint8_t* payload, unsigned int length) {
+  char readTopic[MAX_TOPIC_PREFIX + 8];
+  char writeTopic[MAX_TOPIC_PREFIX + 8];
+  commandTopic(readTopic, sizeof(readTopic), "read");
+  commandTopic(writeTopic, sizeof(writeTopic), "write");
+  bool write = strcmp(topic, writeTopic) == 0;
+  if (!write && strcmp(topic, readTopic) != 0) return;
+
+  JsonDocument doc;
+  if (deserializeJson(doc, (const char*)payload, length)) {
+    LOG_WARN("⚠️ MQTT %s: invalid JSON", write ? "write" : "read");
+    return;
+  }
+  if (write) {
+    const char* error;
+    queueWriteJson(doc.as<JsonObject>(), error);  // rejections are reported on write/status too
+    return;
+  }
+  long id = doc["id"] | 0L;
+  long start = doc["start"] | 0L;
+  long count = doc["count"] | 1L;
+  if (id < SLAVE_ID_MIN || id > SLAVE_ID_MAX || start < 0 || count < 1 || count > MODBUS_MAX_READ_REGS ||
+      start + count > 0x10000) {
+    LOG_WARN("⚠️ MQTT read: bad slave ID or register range");
+    return;
+  }
+  for (uint8_t i = 0; i < MQTT_MAX_PENDING_READS; i++) {
+    PendingRead& read = pendingReads[i];
+    if (read.used) continue;
+    read.used = true;
+    read.counted = false;
+    read.slaveId = id;
+    read.start = start;
+    read.count = count;
+    read.maxAgeMs = doc["maxAgeMs"] | 0UL;
+    read.since = millis();
+    strncpy(read.ref, doc["ref"] | "", MQTT_REF_MAX);
+    read.ref[MQTT_REF_MAX] = '\0';
+    return;
+  }
+  LOG_WARN("⚠️ MQTT read dropped: %u reads already waiting", MQTT_MAX_PENDING_READS);
+}
+
+// ----------------- Service -----------------
+
+void setupMqttCommands() {
+  mqttClient.setCallback(onMessage);
+}
+
+// A new session has no subscriptions; serviceMqttCommands() makes them again
+void mqttCommandsConnected() {
+  subscribed = false;
+}
+
+static void commandSubscriptions(bool subscribe) {
+  char topic[MAX_TOPIC_PREFIX + 8];
+  for (const char* command : {"read", "write"}) {
+    snprintf(topic, sizeof(topic), "%s/%s", subscribedPrefix, command);
+    if (subscribe) subscribed = mqttClient.subscribe(topic) && subscribed;
+    else mqttClient.unsubscribe(topic);
+  }
+}
+
+// Run from loop(): follows prefix changes with the subscriptions, answers
+// new reads, rechecks waiting ones when the cache changed and publishes the
+// status of settled writes
+void serviceMqttCommands() {
+  if (!mqttClient.connected()) return;
+  if (!subscribed || strcmp(publishConfig.prefix, subscribedPrefix) != 0) {
+    if (subscribed) commandSubscriptions(false);
+    strcpy(subscribedPrefix, publishConfig.prefix);
+    subscribed = true;
+    commandSubscriptions(true);
+  }
+
+  bool recheck = cacheUpdates() != seenCacheUpdates;
+  seenCacheUpdates = cacheUpdates();
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < MQTT_MAX_PENDING_READS; i++) {
+    PendingRead& read = pendingReads[i];
+    if (!read.used) continue;
+    if (read.counted && !recheck && now - read.since < MQTT_READ_TIMEOUT_MS) continue;
+    if (serviceRead(read)) read.used = false;
+  }
+  reportWriteStatus();
+}
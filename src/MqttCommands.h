@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+// Commands over MQTT, on topics under publishConfig.prefix:
+//   <prefix>/read  {"id":1,"start":0,"count":2,"maxAgeMs":500,"ref":"a1"}
+//                  answered on <prefix>/read/reply with
+//                  {"ref":"a1","id":1,"start":0,"values":[201,500],"ageMs":840}
+//                  or {"ref":"a1","id":1,"error":"..."}
+//   <prefix>/write {"id":1,"register":10,"values":[5,6],"ref":"w1"}
+//                  queued on the write queue; the outcome follows on
+//                  <prefix>/write/status (see WriteQueue)
+// Reads come from the register cache. One that finds stale values waits for
+// the refresh (shared with every other reader of the block) for up to
+// MQTT_READ_TIMEOUT_MS. Messages are only parsed (and writes queued) in the
+// callback; lookups and replies run from serviceMqttCommands().
+
+#define MQTT_MAX_PENDING_READS 8
+#define MQTT_READ_TIMEOUT_MS 3000UL
+#define MQTT_REF_MAX 32                // longer "ref"s are cut
+
+// Function declarations
+void setupMqttCommands();
+void mqttCommandsConnected();
+void serviceMqttCommands();
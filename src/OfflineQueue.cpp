@@ -0,0 +1,268 @@
+#include "OfflineQueue.h"
+#include <LittleFS.h>
+#include "RtuMaster.h"
+#include "Logger.h"
+
+// Reading on flash and in the page: capturedMs (4, LE), slave id, result,
+// word count, then the words (LE). Segment files start with their 4-byte
+// sequence number, so the order survives a reboot.
+#define QUEUE_RECORD_HEADER 7
+#define QUEUE_SEGMENT_HEADER 4
+
+QueueStats queueStats;
+
+static uint8_t page[QUEUE_PAGE_SIZE];
+static uint16_t pageLen = 0;
+static uint16_t pageRead = 0;          // replayed straight from RAM (only while flash is empty)
+static unsigned long pageSince = 0;    // first unflushed reading
+
+// Segments [firstSeq, nextSeq) are on flash; nextSeq - 1 takes appends
+// until it is full. Segments before liveSeq were written before this boot.
+static uint32_t firstSeq = 0;
+static uint32_t nextSeq = 0;
+static uint32_t liveSeq = 0;
+static uint32_t writeSize = 0;         // 0 = open a new segment on the next flush
+static uint32_t flashPending = 0;      // reading bytes on flash not yet replayed
+
+// Read cache over the oldest segment
+static uint8_t readBuf[QUEUE_PAGE_SIZE];
+static uint32_t readOffset = QUEUE_SEGMENT_HEADER;
+static uint16_t readLen = 0;
+static uint16_t readPos = 0;
+
+// What queuePop() consumes
+static uint16_t peekLen = 0;
+static bool peekFromPage = false;
+
+static const char* segmentPath(uint32_t seq) {
+  static char path[24];
+  snprintf(path, sizeof(path), "/queue%u.bin", (unsigned)(seq % QUEUE_MAX_SEGMENTS));
+  return path;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+  for (uint8_t i = 0; i < 4; i++) p[i] = v >> (8 * i);
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Encodes one reading; returns its length, 0 if it doesn't fit in room
+uint16_t packReading(uint8_t* p, uint16_t room, uint8_t slaveId, uint8_t result, const uint16_t* image,
+                     uint8_t words, uint32_t capturedMs) {
+  uint16_t size = QUEUE_RECORD_HEADER + 2 * words;
+  if (size > room) return 0;
+  put32(p, capturedMs);
+  p[4] = slaveId;
+  p[5] = result;
+  p[6] = words;
+  for (uint8_t i = 0; i < words; i++) {
+    p[QUEUE_RECORD_HEADER + 2 * i] = image[i] & 0xFF;
+    p[QUEUE_RECORD_HEADER + 2 * i + 1] = image[i] >> 8;
+  }
+  return size;
+}
+
+// Decodes one reading; returns its length, 0 if incomplete or invalid
+uint16_t unpackReading(const uint8_t* p, uint16_t len, QueuedReading& reading) {
+  if (len < QUEUE_RECORD_HEADER) return 0;
+  uint8_t words = p[6];
+  uint16_t size = QUEUE_RECORD_HEADER + 2 * words;
+  if (words > QUEUE_MAX_WORDS || len < size) return 0;
+  reading.capturedMs = get32(p);
+  reading.slaveId = p[4];
+  reading.result = p[5];
+  reading.words = words;
+  for (uint8_t i = 0; i < words; i++) {
+    reading.image[i] = p[QUEUE_RECORD_HEADER + 2 * i] | p[QUEUE_RECORD_HEADER + 2 * i + 1] << 8;
+  }
+  return size;
+}
+
+// ----------------- Segments -----------------
+
+static void resetReadCache() {
+  readOffset = QUEUE_SEGMENT_HEADER;
+  readLen = readPos = 0;
+}
+
+static void removeOldestSegment() {
+  const char* path = segmentPath(firstSeq);
+  File file = LittleFS.open(path, "r");
+  if (file) {
+    uint32_t size = file.size();
+    uint32_t unread = size > readOffset + readPos ? size - readOffset - readPos : 0;
+    flashPending -= min(flashPending, unread);
+    file.close();
+  }
+  LittleFS.remove(path);
+  firstSeq++;
+  if (firstSeq == nextSeq) writeSize = 0;
+  resetReadCache();
+}
+
+// Finds the segments left by an earlier boot
+void queueBegin() {
+  bool found = false;
+  flashPending = 0;
+  for (uint8_t slot = 0; slot < QUEUE_MAX_SEGMENTS; slot++) {
+    File file = LittleFS.open(segmentPath(slot), "r");
+    if (!file) continue;
+    uint8_t header[QUEUE_SEGMENT_HEADER];
+    if (file.read(header, sizeof(header)) == sizeof(header)) {
+      uint32_t seq = get32(header);
+      if (!found || seq < firstSeq) firstSeq = seq;
+      if (!found || seq >= nextSeq) nextSeq = seq + 1;
+      flashPending += file.size() - QUEUE_SEGMENT_HEADER;
+      found = true;
+    }
+    file.close();
+  }
+  liveSeq = nextSeq;
+  writeSize = 0;  // this boot's readings start a segment of their own
+  resetReadCache();
+  if (found) LOG_INFO("📦 Offline queue: %u segment(s), %u bytes from before reboot",
+                      (unsigned)(nextSeq - firstSeq), (unsigned)flashPending);
+}
+
+void queueClear() {
+  for (uint8_t slot = 0; slot < QUEUE_MAX_SEGMENTS; slot++) LittleFS.remove(segmentPath(slot));
+  firstSeq = nextSeq = liveSeq = 0;
+  writeSize = flashPending = 0;
+  pageLen = pageRead = 0;
+  resetReadCache();
+}
+
+// Appends the unreplayed part of the page to the newest segment
+static bool flushPage() {
+  uint16_t len = pageLen - pageRead;
+  if (len == 0) {
+    pageLen = pageRead = 0;
+    return true;
+  }
+
+  bool fresh = writeSize == 0 || writeSize + len > QUEUE_SEGMENT_SIZE;
+  if (fresh) {
+    if (nextSeq - firstSeq >= QUEUE_MAX_SEGMENTS) {
+      LOG_WARN("⚠️ Offline queue full, dropping its oldest segment");
+      queueStats.dropped++;
+      removeOldestSegment();
+    }
+    nextSeq++;
+    writeSize = 0;
+  }
+
+  File file = LittleFS.open(segmentPath(nextSeq - 1), fresh ? "w" : "a");
+  bool ok = (bool)file;
+  if (ok && fresh) {
+    uint8_t header[QUEUE_SEGMENT_HEADER];
+    put32(header, nextSeq - 1);
+    ok = file.write(header, sizeof(header)) == sizeof(header);
+    writeSize += sizeof(header);
+  }
+  ok = ok && file.write(page + pageRead, len) == len;
+  if (file) file.close();
+
+  if (ok) {
+    writeSize += len;
+    flashPending += len;
+    queueStats.flashWrites++;
+    queueStats.flashBytes += len + (fresh ? QUEUE_SEGMENT_HEADER : 0);
+  } else {
+    LOG_ERROR("❌ Offline queue flash write failed, %u bytes lost", len);
+    queueStats.dropped++;
+    writeSize = 0;  // don't append to a segment in an unknown state
+  }
+  pageLen = pageRead = 0;
+  return ok;
+}
+
+// ----------------- Queue -----------------
+
+bool queueReading(uint8_t slaveId, uint8_t result, const uint16_t* image, uint8_t words, uint32_t capturedMs) {
+  uint16_t size = QUEUE_RECORD_HEADER + 2 * words;
+
+  if (pageLen + size > QUEUE_PAGE_SIZE && firstSeq == nextSeq && pageRead > 0) {
+    // Still replaying from RAM: make room without touching flash
+    memmove(page, page + pageRead, pageLen - pageRead);
+    pageLen -= pageRead;
+    pageRead = 0;
+  }
+  if (pageLen + size > QUEUE_PAGE_SIZE) flushPage();
+  if (pageLen == pageRead) pageSince = millis();
+
+  pageLen += packReading(page + pageLen, QUEUE_PAGE_SIZE - pageLen, slaveId, result, image, words, capturedMs);
+  queueStats.queued++;
+  return true;
+}
+
+bool queueEmpty() {
+  return firstSeq == nextSeq && pageRead == pageLen;
+}
+
+uint32_t queueBytes() {
+  return flashPending + pageLen - pageRead;
+}
+
+// Oldest reading without consuming it; flash first, then the RAM page
+bool queuePeek(QueuedReading& reading) {
+  bool refilled = false;
+  while (firstSeq != nextSeq) {
+    peekLen = unpackReading(readBuf + readPos, readLen - readPos, reading);
+    if (peekLen) {
+      peekFromPage = false;
+      reading.earlierBoot = firstSeq < liveSeq;
+      return true;
+    }
+
+    // Refill the cache from where the last complete reading ended
+    if (!refilled) {
+      readOffset += readPos;
+      readPos = readLen = 0;
+      File file = LittleFS.open(segmentPath(firstSeq), "r");
+      if (file && file.size() > readOffset && file.seek(readOffset)) {
+        int n = file.read(readBuf, sizeof(readBuf));
+        readLen = n > 0 ? n : 0;
+      }
+      if (file) file.close();
+      refilled = true;
+      continue;
+    }
+
+    // Segment done; bytes that still don't parse are a torn write
+    if (readLen) LOG_WARN("⚠️ Offline queue segment %u damaged, skipping its rest", (unsigned)firstSeq);
+    removeOldestSegment();
+    refilled = false;
+  }
+
+  peekLen = unpackReading(page + pageRead, pageLen - pageRead, reading);
+  peekFromPage = true;
+  reading.earlierBoot = false;
+  return peekLen > 0;
+}
+
+// Consumes the reading returned by the last queuePeek()
+void queuePop() {
+  if (!peekLen) return;
+  if (peekFromPage) {
+    pageRead += peekLen;
+    if (pageRead == pageLen) pageLen = pageRead = 0;
+  } else {
+    readPos += peekLen;
+    flashPending -= min(flashPending, (uint32_t)peekLen);
+  }
+  peekLen = 0;
+  queueStats.replayed++;
+}
+
+// Puts a partial page on flash once it's been sitting for QUEUE_FLUSH_MS,
+// so a power cut loses at most that much; never while the bus is busy
+void queueService() {
+  if (pageLen == pageRead || rtuBusy()) return;
+  if (millis() - pageSince >= QUEUE_FLUSH_MS) flushPage();
+}
+
+uint32_t queuedAgeMs(const QueuedReading& reading) {
+  return reading.earlierBoot ? RESULT_AGE_UNKNOWN : millis() - reading.capturedMs;
+}
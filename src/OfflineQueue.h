@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+#include "ResultEncoder.h"
+
+// Store-and-forward for poll results and window summaries that couldn't be
+// published. Readings are stored raw (slave, status, register image, capture
+// time) and re-encoded when they are replayed. They collect in a RAM page first, so a
+// short outage never touches flash; full pages are appended to segment files
+// /queue<N>.bin on LittleFS. The oldest segment is dropped when all
+// QUEUE_MAX_SEGMENTS are in use. Replay is at-least-once: after a reboot the
+// oldest segment starts over from its beginning.
+
+#define QUEUE_PAGE_SIZE 320              // RAM front buffer = one flash append; fits the largest record
+#define QUEUE_SEGMENT_SIZE 4096          // one LittleFS block per segment file
+#define QUEUE_MAX_SEGMENTS 32            // 128 KB of flash at most
+#define QUEUE_FLUSH_MS 60000UL           // partial page goes to flash after this long
+#define QUEUE_DRAIN_BATCH 8              // replayed readings per drain pass
+#define QUEUE_DRAIN_INTERVAL_MS 200UL    // between drain passes
+
+// A record whose result is QUEUE_RESULT_WINDOW holds a window summary
+// instead of a poll (see WindowAggregator); it is the largest kind
+#define QUEUE_RESULT_WINDOW 0xFF
+#define QUEUE_WINDOW_WORDS(fields) (12 + 8 * (fields))
+#define QUEUE_MAX_WORDS QUEUE_WINDOW_WORDS(MAX_FIELDS_PER_SLAVE)
+
+struct QueuedReading {
+  uint32_t capturedMs;
+  bool earlierBoot;                      // capturedMs belongs to a previous uptime
+  uint8_t slaveId;
+  uint8_t result;
+  uint8_t words;
+  uint16_t image[QUEUE_MAX_WORDS];
+};
+
+struct QueueStats {
+  uint32_t queued;        // readings accepted
+  uint32_t replayed;      // readings handed back by queuePop()
+  uint32_t dropped;       // segments evicted from a full queue, pages lost to a failed write
+  uint32_t flashWrites;   // page appends
+  uint32_t flashBytes;
+};
+
+extern QueueStats queueStats;
+
+// Function declarations
+void queueBegin();
+void queueClear();
+bool queueReading(uint8_t slaveId, uint8_t result, const uint16_t* image, uint8_t words, uint32_t capturedMs);
+bool queueEmpty();
+uint32_t queueBytes();
+bool queuePeek(QueuedReading& reading);
+void queuePop();
+void queueService();
+uint32_t queuedAgeMs(const QueuedReading& reading);
+uint16_t packReading(uint8_t* p, uint16_t room, uint8_t slaveId, uint8_t result, const uint16_t* image,
+                     uint8_t words, uint32_t capturedMs);
+uint16_t unpackReading(const uint8_t* p, uint16_t len, QueuedReading& reading);
@@ -0,0 +1,198 @@
+#include "PollScheduler.h"
+#include "ReadPlanner.h"
+#include "RegisterCache.h"
+#include "SlaveHealth.h"
+#include "SlaveTable.h"
+#include "Metrics.h"
+#include "Hal.h"
+#include "Logger.h"
+
+// Due time and period of the poll in flight, for deadline accounting
+static unsigned long releasedDue = 0;
+static uint32_t releasedPeriod = 0;
+static uint32_t pollStartMicros = 0;
+
+// Fixed-rate slaves keep their grid only while the breaker is closed
+static bool onGrid(const ModbusSlave& slave) {
+  return slave.fixedRate && !slaveHealth(slave).probeLevel;
+}
+
+// Expected bus time of a slave's poll, with its own turnaround once learned
+static uint32_t pollEstimateMs(const ModbusSlave& slave, uint8_t index) {
+  const SlaveHealth& health = slaveHealth(slave);
+  uint32_t turnaround = health.rttSamples ? (uint32_t)health.rttSmooth * HEALTH_RTT_UNIT_US : RTU_TYPICAL_TURNAROUND_US;
+  uint32_t busMicros = 0;
+  for (uint8_t b = 0; b < slavePlanCount[index]; b++) {
+    busMicros += rtuEstimateMicros(8, 5 + readPlan[slavePlanFirst[index] + b].count * 2) -
+                 RTU_TYPICAL_TURNAROUND_US + turnaround;
+  }
+  return (busMicros + 999) / 1000;
+}
+
+// Most overdue slave, fixed-rate ones first, or -1 if nobody is due yet. A
+// slave that would still be polling at a fixed-rate deadline waits, unless
+// it has already waited a whole period itself.
+static int pickNextSlave(const ModbusSlave* slaves, uint8_t slaveCount, unsigned long now) {
+  int best = -1;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    const ModbusSlave& slave = slaves[i];
+    unsigned long due = slaveSchedule(slave).nextPollDue;
+    if ((long)(now - due) < 0) continue;
+    if (best >= 0 && onGrid(slaves[best]) != onGrid(slave)) {
+      if (onGrid(slave)) best = i;
+      continue;
+    }
+    if (best < 0 || (long)(due - slaveSchedule(slaves[best]).nextPollDue) < 0) best = i;
+  }
+  if (best >= 0 && !onGrid(slaves[best]) && now - slaveSchedule(slaves[best]).nextPollDue < slaves[best].pollMs &&
+      fixedRateDueWithin(slaves, slaveCount, pollEstimateMs(slaves[best], best))) {
+    return -1;
+  }
+  return best;
+}
+
+// Whether a fixed-rate slave falls due within ms: work that takes that long
+// should wait so the sample goes out on time. Slaves with periods under
+// twice that don't count, or the work would hardly ever get the bus.
+bool fixedRateDueWithin(const ModbusSlave* slaves, uint8_t slaveCount, uint32_t ms) {
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    const ModbusSlave& slave = slaves[i];
+    if (onGrid(slave) && slave.pollMs > 2 * ms && (long)(slaveSchedule(slave).nextPollDue - now) < (long)ms) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Share of bus time the configured poll rates ask for, in percent
+uint16_t scheduleLoadPercent(const ModbusSlave* slaves, uint8_t slaveCount) {
+  uint32_t load = 0;  // in 1/100000 of the bus
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    if (slaves[i].pollMs == 0) continue;
+    uint32_t busMicros = 0;
+    for (uint8_t b = 0; b < slavePlanCount[i]; b++) {
+      busMicros += rtuEstimateMicros(8, 5 + readPlan[slavePlanFirst[i] + b].count * 2);
+    }
+    load += busMicros * 100 / slaves[i].pollMs;
+  }
+  return load / 1000;
+}
+
+// ----------------- Sampling -----------------
+
+void resetSlaveSampling(ModbusSlave& slave) {
+  slaveSampling(slave) = SlaveSampling();
+  slaveSchedule(slave).skippedPolls = 0;
+}
+
+uint32_t slaveJitterMicros(const ModbusSlave& slave) {
+  return slaveSampling(slave).jitter16 >> JITTER_GAIN_SHIFT;
+}
+
+// Wall-clock time of the last sample, 0 before the first one or before the
+// clock has synced
+uint64_t slaveSampleEpochMs(const ModbusSlave& slave) {
+  const SlaveSampling& sampling = slaveSampling(slave);
+  uint64_t epochMs = halEpochMillis();
+  uint32_t ageMs = millis() - sampling.sampleTime;
+  return sampling.sampled && epochMs > ageMs ? epochMs - ageMs : 0;
+}
+
+// Stamps the reading with its reply's arrival and, if the previous sample
+// was about one period earlier (not before a skip or a manual query),
+// smooths |spacing - pollMs| into the jitter
+static void recordSample(ModbusSlave& slave, uint8_t result) {
+  SlaveSampling& sampling = slaveSampling(slave);
+  uint32_t sampleMicros = slavePollSampleMicros();
+  sampling.sampleTime = millis() - (micros() - sampleMicros) / 1000;
+  sampling.sampled = true;
+
+  if (result != RTU_SUCCESS) {
+    sampling.spacingValid = false;
+    return;
+  }
+  uint32_t periodMicros = slave.pollMs * 1000;
+  uint32_t spacing = sampleMicros - sampling.sampleMicros;
+  if (sampling.spacingValid && slave.pollMs <= JITTER_MAX_PERIOD_MS &&
+      spacing >= periodMicros / 2 && spacing < periodMicros + periodMicros / 2) {
+    uint32_t magnitude = spacing > periodMicros ? spacing - periodMicros : periodMicros - spacing;
+    sampling.jitter16 += magnitude - ((sampling.jitter16 + (1 << (JITTER_GAIN_SHIFT - 1))) >> JITTER_GAIN_SHIFT);
+    sampling.maxJitterUs = max(sampling.maxJitterUs, magnitude);
+    sampling.jitterSamples++;
+  }
+  sampling.sampleMicros = sampleMicros;
+  sampling.spacingValid = true;
+}
+
+// ----------------- Polling -----------------
+
+// Run from loop(): starts the next due slave when the bus is free and returns
+// true when a poll has finished (see slavePollResult())
+bool pollSlaves(ModbusSlave* slaves, uint8_t slaveCount) {
+  if (queryState == Q_IDLE) {
+    if (ensureReadPlan(slaves, slaveCount)) {
+      uint16_t load = scheduleLoadPercent(slaves, slaveCount);
+      LOG_INFO("📈 Requested bus load: %u%%", load);
+      if (load > 100) LOG_WARN("⚠️ Poll rates exceed bus capacity, deadlines will be missed");
+    }
+    
+    int next = pickNextSlave(slaves, slaveCount, millis());
+    if (next < 0) return false;
+    releasedDue = slaveSchedule(slaves[next]).nextPollDue;
+    releasedPeriod = slavePeriodMs(slaves[next]);
+    if (!startSlavePoll(slaves, slaveCount, next)) return false;
+    pollStartMicros = micros();
+  }
+  
+  if (!continueSlavePoll(slaves)) return false;
+  histogramAdd(pollHist, micros() - pollStartMicros);
+  
+  // The poll must finish before the next one falls due
+  ModbusSlave& slave = slaves[currentQueryIndex];
+  SlaveSchedule& schedule = slaveSchedule(slave);
+  unsigned long now = millis();
+  unsigned long deadline = releasedDue + releasedPeriod;
+  schedule.pollCount++;
+  if ((long)(now - deadline) > 0) {
+    schedule.deadlineMisses++;
+    if (now - deadline > schedule.maxLateMs) schedule.maxLateMs = now - deadline;
+  }
+  
+  // A fixed-rate slave's next deadline is one period after this one's;
+  // periods that have gone by entirely are skipped. Otherwise the period
+  // counts from when this poll actually started. A tripped breaker
+  // stretches it to the probe interval either way.
+  bool grid = onGrid(slave) && releasedPeriod == slave.pollMs;
+  recordPollOutcome(slave, slavePollResult());
+  if (onGrid(slave) && grid) {
+    schedule.nextPollDue = releasedDue + slave.pollMs;
+    while ((long)(now - schedule.nextPollDue) >= (long)slave.pollMs) {
+      schedule.nextPollDue += slave.pollMs;
+      schedule.skippedPolls++;
+    }
+  } else {
+    schedule.nextPollDue = queryStartTime + slavePeriodMs(slave);
+    if ((long)(now - schedule.nextPollDue) > 0) schedule.nextPollDue = now;
+  }
+  recordSample(slave, slavePollResult());
+  return true;
+}
+
+// Whether some slave is waiting for the bus
+bool slavePollDue(const ModbusSlave* slaves, uint8_t slaveCount) {
+  return pickNextSlave(slaves, slaveCount, millis()) >= 0;
+}
+
+// Make every slave whose cached registers are stale due immediately (manual
+// "query now"); returns how many that was
+uint8_t pollStaleNow(ModbusSlave* slaves, uint8_t slaveCount) {
+  unsigned long now = millis();
+  uint8_t stale = 0;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    if (slaveCacheFresh(slaves[i])) continue;
+    slaveSchedule(slaves[i]).nextPollDue = now;
+    stale++;
+  }
+  return stale;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Deadline-based polling: every slave has its own pollMs and the slave whose
+// poll has been due the longest goes next (earliest deadline first).
+//
+// Normally the next period counts from when a poll started. A fixedRate
+// slave's deadlines instead sit on a fixed grid (due + pollMs), so its
+// samples stay evenly spaced: such slaves go before others once due, a poll
+// of another slave isn't started when it would still be running at a
+// fixed-rate deadline, and periods missed entirely are skipped, not made
+// up. Every reading is stamped when its first reply frame arrived (wall
+// clock once NTP has synced), and the spacing of successive samples is
+// measured against pollMs as RFC 3550 measures interarrival jitter.
+
+#define JITTER_GAIN_SHIFT 4              // smoothing: 1/16 of each new deviation
+#define JITTER_MAX_PERIOD_MS 2400000UL   // longer periods aren't measured (micros() wraps after 71 min)
+
+// Function declarations
+bool pollSlaves(ModbusSlave* slaves, uint8_t slaveCount);
+uint8_t pollStaleNow(ModbusSlave* slaves, uint8_t slaveCount);
+bool slavePollDue(const ModbusSlave* slaves, uint8_t slaveCount);
+uint16_t scheduleLoadPercent(const ModbusSlave* slaves, uint8_t slaveCount);
+bool fixedRateDueWithin(const ModbusSlave* slaves, uint8_t slaveCount, uint32_t ms);
+void resetSlaveSampling(ModbusSlave& slave);
+uint32_t slaveJitterMicros(const ModbusSlave& slave);
+uint64_t slaveSampleEpochMs(const ModbusSlave& slave);
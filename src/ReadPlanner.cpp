@@ -0,0 +1,147 @@
+#include "ReadPlanner.h"
+#include "RegisterCache.h"
+#include "Logger.h"
+
+ReadBlock readPlan[MAX_READ_BLOCKS];
+uint16_t readPlanCount = 0;
+uint16_t slavePlanFirst[MAX_SLAVES];
+uint8_t slavePlanCount[MAX_SLAVES];
+
+static bool readPlanDirty = true;
+
+// Range 0 is the slave's primary startReg/numRegs, the rest are extraRanges
+uint8_t slaveRangeCount(const ModbusSlave& slave) {
+  return 1 + slave.extraRangeCount;
+}
+
+RegRange slaveRange(const ModbusSlave& slave, uint8_t index) {
+  if (index == 0) return RegRange{slave.startReg, slave.numRegs};
+  return slave.extraRanges[index - 1];
+}
+
+// One readable range: 1-125 registers inside the 16-bit address space
+bool regRangeValid(uint32_t start, uint32_t count) {
+  return count >= 1 && count <= MODBUS_MAX_READ_REGS && start + count <= 0x10000UL;
+}
+
+// Every range valid and all of them together fit one slave image. Shared by
+// the web API and the journal replay; sums in 32 bits so nothing wraps.
+bool slaveRangesValid(const ModbusSlave& slave) {
+  if (slave.extraRangeCount > MAX_EXTRA_RANGES) return false;
+  uint32_t total = 0;
+  for (uint8_t r = 0; r < slaveRangeCount(slave); r++) {
+    RegRange range = slaveRange(slave, r);
+    if (!regRangeValid(range.start, range.count)) return false;
+    total += range.count;
+  }
+  return total <= MAX_REGS_PER_SLAVE;
+}
+
+// Registers of all ranges back to back, in configuration order
+uint16_t slaveImageSize(const ModbusSlave& slave) {
+  uint32_t total = 0;
+  for (uint8_t r = 0; r < slaveRangeCount(slave); r++) total += slaveRange(slave, r).count;
+  return min(total, (uint32_t)0xFFFF);
+}
+
+// Copy whatever part of each configured range this block covered; never
+// writes past the image, even for a slave that skipped validation
+void copyBlockToImage(const ModbusSlave& slave, const ReadBlock& block, uint16_t* image) {
+  uint32_t blockEnd = (uint32_t)block.start + block.count;
+  uint32_t limit = min((uint32_t)slaveImageSize(slave), (uint32_t)MAX_REGS_PER_SLAVE);
+  uint32_t offset = 0;
+  for (uint8_t r = 0; r < slaveRangeCount(slave) && offset < limit; r++) {
+    RegRange range = slaveRange(slave, r);
+    uint32_t from = max((uint32_t)range.start, (uint32_t)block.start);
+    uint32_t to = min((uint32_t)range.start + range.count, blockEnd);
+    to = min(to, (uint32_t)range.start + (limit - offset));
+    for (uint32_t addr = from; addr < to; addr++) {
+      image[offset + (addr - range.start)] = rtuGetResponseRegister(addr - block.start);
+    }
+    offset += range.count;
+  }
+}
+
+static bool appendBlock(uint16_t start, uint16_t count) {
+  if (readPlanCount >= MAX_READ_BLOCKS) return false;
+  readPlan[readPlanCount].start = start;
+  readPlan[readPlanCount].count = count;
+  readPlanCount++;
+  return true;
+}
+
+// Sort one slave's ranges by address, then sweep: overlapping and adjacent
+// ranges always join the open block, ranges up to maxGap registers away join
+// if the block still fits one request, anything else starts a new block.
+static void planSlave(const ModbusSlave& slave) {
+  RegRange sorted[1 + MAX_EXTRA_RANGES];
+  uint8_t n = 0;
+  for (uint8_t r = 0; r < slaveRangeCount(slave); r++) {
+    RegRange range = slaveRange(slave, r);
+    if (range.count == 0) continue;
+    uint8_t i = n++;
+    while (i > 0 && sorted[i - 1].start > range.start) {
+      sorted[i] = sorted[i - 1];
+      i--;
+    }
+    sorted[i] = range;
+  }
+  if (n == 0) return;
+
+  uint32_t blockStart = sorted[0].start;
+  uint32_t blockEnd = blockStart;
+  for (uint8_t i = 0; i < n; i++) {
+    uint32_t start = sorted[i].start;
+    uint32_t end = start + sorted[i].count;
+    if (start <= blockEnd) {
+      blockEnd = max(end, blockEnd);
+    } else if (start - blockEnd <= slave.maxGap && end - blockStart <= MODBUS_MAX_READ_REGS) {
+      blockEnd = end;  // reading the gap is cheaper than another round trip
+    } else {
+      appendBlock(blockStart, blockEnd - blockStart);
+      blockStart = start;
+      blockEnd = end;
+    }
+    // Split at the protocol limit
+    while (blockEnd - blockStart > MODBUS_MAX_READ_REGS) {
+      appendBlock(blockStart, MODBUS_MAX_READ_REGS);
+      blockStart += MODBUS_MAX_READ_REGS;
+    }
+  }
+  appendBlock(blockStart, blockEnd - blockStart);
+}
+
+static void planReads(const ModbusSlave* slaves, uint8_t slaveCount) {
+  uint16_t rangeTotal = 0;
+  readPlanCount = 0;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    slavePlanFirst[i] = readPlanCount;
+    planSlave(slaves[i]);
+    slavePlanCount[i] = readPlanCount - slavePlanFirst[i];
+    rangeTotal += slaveRangeCount(slaves[i]);
+  }
+
+  clearRegisterCache();  // cached ages are per block
+  LOG_INFO("📋 Read plan: %u ranges -> %u transactions per cycle", rangeTotal, readPlanCount);
+  if (readPlanCount >= MAX_READ_BLOCKS) {
+    LOG_WARN("⚠️ Read plan full, some ranges will not be polled");
+  }
+}
+
+// Mark the plan stale; called whenever slaves[] changes
+void invalidateReadPlan() {
+  readPlanDirty = true;
+}
+
+// Whether slaves[] changed since the plan was built
+bool readPlanStale() {
+  return readPlanDirty;
+}
+
+// Rebuild the plan if the slave table changed; true if it was rebuilt
+bool ensureReadPlan(const ModbusSlave* slaves, uint8_t slaveCount) {
+  if (!readPlanDirty) return false;
+  planReads(slaves, slaveCount);
+  readPlanDirty = false;
+  return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Turns each slave's configured register ranges into as few RTU reads as
+// possible. The plan is rebuilt only when the slave table changes.
+
+#define MODBUS_MAX_READ_REGS 125  // FC03/FC04 protocol limit per request
+#define MAX_READ_BLOCKS (MAX_SLAVES + 64)  // one per slave plus some for split ranges
+
+struct ReadBlock {
+  uint16_t start;
+  uint16_t count;
+};
+
+extern ReadBlock readPlan[MAX_READ_BLOCKS];
+extern uint16_t readPlanCount;
+extern uint16_t slavePlanFirst[MAX_SLAVES];  // first block of each slave
+extern uint8_t slavePlanCount[MAX_SLAVES];   // blocks per slave (0 = nothing to read)
+
+// Function declarations
+void invalidateReadPlan();
+bool readPlanStale();
+bool ensureReadPlan(const ModbusSlave* slaves, uint8_t slaveCount);
+uint8_t slaveRangeCount(const ModbusSlave& slave);
+RegRange slaveRange(const ModbusSlave& slave, uint8_t index);
+bool regRangeValid(uint32_t start, uint32_t count);
+bool slaveRangesValid(const ModbusSlave& slave);
+uint16_t slaveImageSize(const ModbusSlave& slave);
+void copyBlockToImage(const ModbusSlave& slave, const ReadBlock& block, uint16_t* image);
@@ -0,0 +1,307 @@
+#include "RegisterCache.h"
+#include "ReadPlanner.h"
+#include "SlaveTable.h"
+#include "SlaveHealth.h"
+#include "LiveData.h"
+#include "WebServerHandler.h"
+#include "Metrics.h"
+#include "Logger.h"
+
+CacheStats cacheStats;
+
+// Age of one read-plan block's values in the slave's last-reading image
+struct BlockAge {
+  unsigned long readAt;    // when the read that filled it started
+  unsigned long failedAt;  // last failed refresh
+  bool valid;
+  bool failed;             // the last refresh failed
+};
+
+// A block to refresh, by address so a rebuilt plan can't misdirect it
+struct CacheFetch {
+  uint8_t slaveId;
+  uint16_t start;
+  uint16_t count;
+};
+
+static BlockAge blockAges[MAX_READ_BLOCKS];
+static uint32_t updateCount = 0;
+
+static CacheFetch fetchQueue[CACHE_FETCH_QUEUE];
+static uint8_t fetchCount = 0;
+static CacheFetch activeFetch;
+static bool fetchActive = false;
+static unsigned long fetchStart = 0;
+static uint16_t fetchTimeoutMs = 0;
+
+// ----------------- Blocks -----------------
+
+static uint8_t slaveIndex(const ModbusSlave& slave) {
+  return &slave - slaves;
+}
+
+// The slave's read block holding reg, or -1
+static int findBlock(uint8_t index, uint16_t reg) {
+  for (uint8_t b = 0; b < slavePlanCount[index]; b++) {
+    const ReadBlock& block = readPlan[slavePlanFirst[index] + b];
+    if (reg >= block.start && reg - block.start < block.count) return slavePlanFirst[index] + b;
+  }
+  return -1;
+}
+
+// The block a fetch was queued for, or -1 if the slave or its plan changed since
+static int fetchBlock(const CacheFetch& fetch, ModbusSlave*& slave) {
+  slave = findSlaveById(fetch.slaveId);
+  if (!slave || readPlanStale()) return -1;
+  uint8_t index = slaveIndex(*slave);
+  for (uint8_t b = 0; b < slavePlanCount[index]; b++) {
+    const ReadBlock& block = readPlan[slavePlanFirst[index] + b];
+    if (block.start == fetch.start && block.count == fetch.count) return slavePlanFirst[index] + b;
+  }
+  return -1;
+}
+
+// Where reg sits in the slave's image (ranges back to back, first match), or -1
+static int imagePosition(const ModbusSlave& slave, uint16_t reg) {
+  uint16_t offset = 0;
+  for (uint8_t r = 0; r < slaveRangeCount(slave); r++) {
+    RegRange range = slaveRange(slave, r);
+    if (reg >= range.start && reg - range.start < range.count) return offset + (reg - range.start);
+    offset += range.count;
+  }
+  return -1;
+}
+
+static bool blockFresh(uint16_t block, uint32_t maxAgeMs) {
+  return blockAges[block].valid && millis() - blockAges[block].readAt <= maxAgeMs;
+}
+
+static void markBlock(uint16_t block, bool ok, unsigned long at) {
+  BlockAge& age = blockAges[block];
+  if (ok) {
+    age.readAt = at;
+    age.valid = true;
+    age.failed = false;
+  } else {
+    age.failedAt = at;
+    age.failed = true;
+  }
+  updateCount++;
+}
+
+// Called whenever the read plan is rebuilt: block numbers have moved
+void clearRegisterCache() {
+  memset(blockAges, 0, sizeof(blockAges));
+  updateCount++;
+}
+
+// Oldest value a read of this slave accepts by default: a poll that runs a
+// little late doesn't make its values stale
+uint32_t slaveCacheMs(const ModbusSlave& slave) {
+  return slave.cacheMs ? slave.cacheMs : slave.pollMs + slave.pollMs / 2;
+}
+
+// Whether every block of the slave is within its cacheMs
+bool slaveCacheFresh(const ModbusSlave& slave) {
+  if (readPlanStale()) return false;
+  uint8_t index = slaveIndex(slave);
+  for (uint8_t b = 0; b < slavePlanCount[index]; b++) {
+    if (!blockFresh(slavePlanFirst[index] + b, slaveCacheMs(slave))) return false;
+  }
+  return true;
+}
+
+// Bumped on every refresh, failure and clear; waiting readers recheck when it moves
+uint32_t cacheUpdates() {
+  return updateCount;
+}
+
+// ----------------- Lookups -----------------
+
+static void requestFetch(uint8_t slaveId, const ReadBlock& block) {
+  CacheFetch fetch = {slaveId, block.start, block.count};
+  auto same = [&](const CacheFetch& f) {
+    return f.slaveId == fetch.slaveId && f.start == fetch.start && f.count == fetch.count;
+  };
+  if (fetchActive && same(activeFetch)) return;
+  for (uint8_t i = 0; i < fetchCount; i++) {
+    if (same(fetchQueue[i])) return;
+  }
+  if (fetchCount >= CACHE_FETCH_QUEUE) return;  // readers ask again on the next update
+  fetchQueue[fetchCount++] = fetch;
+}
+
+// Copies registers start..start+count of the slave into values. ageMs is
+// the oldest block's age, UINT32_MAX if a block was never read (values are
+// then meaningless). On a miss every stale block is queued for a refresh;
+// CACHE_FAILED means a refresh failed after `since`, the reader's arrival.
+// `waiting` marks a recheck of a read that already missed (counted once).
+uint8_t cacheLookup(const ModbusSlave& slave, uint16_t start, uint16_t count, uint32_t maxAgeMs, unsigned long since,
+                    bool waiting, uint16_t* values, uint32_t& ageMs) {
+  ageMs = UINT32_MAX;
+  if ((uint32_t)start + count > 0x10000) return CACHE_UNCACHED;
+  if (readPlanStale()) {
+    if (!waiting) cacheStats.misses++;
+    return CACHE_MISS;  // rebuilt by the next poll, which also clears the cache
+  }
+
+  uint8_t index = slaveIndex(slave);
+  for (uint16_t i = 0; i < count; i++) {
+    if (imagePosition(slave, start + i) < 0 || findBlock(index, start + i) < 0) return CACHE_UNCACHED;
+  }
+
+  // Registers ascend, so each block comes up once, in order
+  const uint16_t* image = slaveLastImage(slave);
+  uint16_t stale[1 + MAX_EXTRA_RANGES];
+  uint8_t staleCount = 0;
+  bool failed = false;
+  bool complete = true;
+  uint32_t oldest = 0;
+  int lastBlock = -1;
+  unsigned long now = millis();
+  for (uint16_t i = 0; i < count; i++) {
+    int block = findBlock(index, start + i);
+    if (block != lastBlock) {
+      lastBlock = block;
+      const BlockAge& age = blockAges[block];
+      if (age.valid) oldest = max(oldest, (uint32_t)(now - age.readAt));
+      else complete = false;
+      if (!blockFresh(block, maxAgeMs)) {
+        if (age.failed && (long)(age.failedAt - since) > 0) failed = true;
+        if (staleCount < sizeof(stale) / sizeof(stale[0])) stale[staleCount++] = block;
+      }
+    }
+    values[i] = image[imagePosition(slave, start + i)];
+  }
+  if (complete) ageMs = oldest;
+
+  if (failed) return CACHE_FAILED;
+  if (staleCount == 0) {
+    if (!waiting) cacheStats.hits++;
+    return CACHE_HIT;
+  }
+  for (uint8_t i = 0; i < staleCount; i++) requestFetch(slave.id, readPlan[stale[i]]);
+  if (!waiting) cacheStats.misses++;
+  return CACHE_MISS;
+}
+
+// After a poll: every block of the slave now holds values from startedAt,
+// or, if the poll failed, none of them was refreshed
+void cacheSlavePolled(uint8_t index, uint8_t result, unsigned long startedAt) {
+  if (readPlanStale()) return;
+  for (uint8_t b = 0; b < slavePlanCount[index]; b++) {
+    markBlock(slavePlanFirst[index] + b, result == RTU_SUCCESS, result == RTU_SUCCESS ? startedAt : millis());
+  }
+}
+
+// ----------------- Bus Side -----------------
+
+bool cacheFetchPending() {
+  return fetchCount > 0;
+}
+
+bool cacheFetchActive() {
+  return fetchActive;
+}
+
+// Puts the oldest queued refresh on the bus; the caller makes sure no poll is
+// running. Refreshes a poll has already done, and those of slaves behind an
+// open breaker (polls probe those), are settled without the bus.
+bool startCacheFetch() {
+  while (!fetchActive && fetchCount > 0 && !rtuBusy()) {
+    CacheFetch fetch = fetchQueue[0];
+    fetchCount--;
+    memmove(fetchQueue, fetchQueue + 1, fetchCount * sizeof(CacheFetch));
+
+    ModbusSlave* slave = nullptr;
+    int block = fetchBlock(fetch, slave);
+    if (block < 0 || blockFresh(block, slaveCacheMs(*slave))) continue;
+    if (slaveHealth(*slave).probeLevel ||
+        !rtuStartRead(slave->id, RTU_FC_READ_INPUT_REGISTERS, fetch.start, fetch.count, slaveTimeoutMs(*slave))) {
+      markBlock(block, false, millis());
+      continue;
+    }
+    activeFetch = fetch;
+    fetchActive = true;
+    fetchStart = millis();
+    fetchTimeoutMs = slaveTimeoutMs(*slave);
+    cacheStats.fetches++;
+    return true;
+  }
+  return false;
+}
+
+// Advances the refresh on the bus; true once it has finished
+bool continueCacheFetch() {
+  if (!fetchActive) return false;
+
+  // Backstop as for polls; an idle engine means the bus settings changed under it
+  uint32_t limitMs = rtuTimeoutMillis(8, 5 + activeFetch.count * 2, fetchTimeoutMs);
+  RtuState state = RTU_IDLE;
+  if (millis() - fetchStart > 2 * limitMs) rtuAbort();
+  else state = rtuPoll();
+  if (state != RTU_IDLE && state != RTU_DONE) return false;
+  fetchActive = false;
+
+  uint8_t result = state == RTU_DONE ? rtuResult() : RTU_RESPONSE_TIMED_OUT;
+  if (state == RTU_DONE) histogramAdd(transactionHist, rtuTransactionMicros());
+  ModbusSlave* slave = nullptr;
+  int block = fetchBlock(activeFetch, slave);
+  if (block < 0) return true;
+  if (state == RTU_DONE && rtuTurnaroundMicros()) recordTurnaround(*slave, rtuTurnaroundMicros());
+  if (result == RTU_SUCCESS) {
+    recordBlockReading(*slave, readPlan[block]);
+    markBlock(block, true, fetchStart);
+  } else {
+    cacheStats.failures++;
+    markBlock(block, false, millis());
+    LOG_DEBUG("Cache refresh of slave %u, %u+%u failed with 0x%02X", slave->id, activeFetch.start, activeFetch.count,
+              result);
+  }
+  return true;
+}
+
+// ----------------- HTTP -----------------
+
+// GET /read?id=1&start=0&count=2[&maxAgeMs=500] ->
+// {"id":1,"start":0,"values":[201,500],"ageMs":840,"fresh":true}. Never
+// waits for the bus: stale values come back with "fresh":false (null if
+// never read) and a refresh is queued, so asking again shortly gets them.
+void handleRead() {
+  long id = server.arg("id").toInt();
+  long start = server.arg("start").toInt();
+  long count = server.hasArg("count") ? server.arg("count").toInt() : 1;
+  ModbusSlave* slave = id >= SLAVE_ID_MIN && id <= SLAVE_ID_MAX ? findSlaveById(id) : nullptr;
+  if (!slave) {
+    server.send(404, "application/json", "{\"error\":\"ID not found\"}");
+    return;
+  }
+  if (start < 0 || count < 1 || count > MODBUS_MAX_READ_REGS || start + count > 0x10000) {
+    server.send(400, "application/json", "{\"error\":\"Invalid register range\"}");
+    return;
+  }
+  uint32_t maxAgeMs = server.hasArg("maxAgeMs") ? server.arg("maxAgeMs").toInt() : slaveCacheMs(*slave);
+
+  uint16_t values[MODBUS_MAX_READ_REGS];
+  uint32_t ageMs;
+  uint8_t lookup = cacheLookup(*slave, start, count, maxAgeMs, millis(), false, values, ageMs);
+  if (lookup == CACHE_UNCACHED) {
+    server.send(404, "application/json", "{\"error\":\"Registers not polled\"}");
+    return;
+  }
+  JsonDocument doc;
+  doc["id"] = id;
+  doc["start"] = start;
+  if (ageMs == UINT32_MAX) {
+    doc["values"] = nullptr;
+    doc["ageMs"] = nullptr;
+  } else {
+    JsonArray array = doc["values"].to<JsonArray>();
+    for (long i = 0; i < count; i++) array.add(values[i]);
+    doc["ageMs"] = ageMs;
+  }
+  doc["fresh"] = lookup == CACHE_HIT;
+  String output;
+  serializeJson(doc, output);
+  server.send(200, "application/json", output);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Input registers as last read, so HTTP, MQTT and Modbus TCP reads don't
+// each cost a bus transaction. The values are the slaves' last-reading
+// images (see LiveData); this module keeps an age per read-plan block.
+// Polls refresh all of a slave's blocks. A read that finds a block older
+// than the slave's cacheMs queues one FC04 read of that block, and every
+// other read waiting for it is answered from the same reply.
+//
+// RAM: 12 bytes per read block (1.2 KB for the ESP8266's 32 slaves, 3.7 KB on
+// the host) plus the fetch queue.
+
+#define CACHE_FETCH_QUEUE 8   // stale blocks waiting for the bus
+
+// What cacheLookup() found
+#define CACHE_HIT 0           // fresh enough, values copied out
+#define CACHE_MISS 1          // a block is too old; a refresh read is queued
+#define CACHE_FAILED 2        // the refresh read failed after `since`
+#define CACHE_UNCACHED 3      // some register isn't in the slave's ranges
+
+struct CacheStats {
+  uint32_t hits;              // reads answered without waiting
+  uint32_t misses;            // reads that had to wait for a refresh
+  uint32_t fetches;           // refresh reads put on the bus
+  uint32_t failures;          // refresh reads that failed
+};
+
+extern CacheStats cacheStats;
+
+// Function declarations
+void clearRegisterCache();
+uint32_t slaveCacheMs(const ModbusSlave& slave);
+bool slaveCacheFresh(const ModbusSlave& slave);
+uint8_t cacheLookup(const ModbusSlave& slave, uint16_t start, uint16_t count, uint32_t maxAgeMs, unsigned long since,
+                    bool waiting, uint16_t* values, uint32_t& ageMs);
+void cacheSlavePolled(uint8_t index, uint8_t result, unsigned long startedAt);
+uint32_t cacheUpdates();
+bool cacheFetchPending();
+bool cacheFetchActive();
+bool startCacheFetch();
+bool continueCacheFetch();
+void handleRead();
@@ -0,0 +1,169 @@
+#include "RegisterMap.h"
+#include "ReadPlanner.h"
+#include "SlaveTable.h"
+
+// ----------------- Field names -----------------
+
+// Names live back to back in one pool and are shared by every slave, so a
+// RegField only carries a one-byte index. The pool only grows; names of
+// deleted slaves stay until the next boot.
+static char namePool[FIELD_NAME_POOL_SIZE] = "temperature\0humidity";
+static uint16_t nameOffsets[MAX_FIELD_NAMES] = {0, 12};
+static uint8_t nameCount = 2;
+static uint16_t poolUsed = 21;
+
+// Keys the encoder already uses for the record itself
+static const char* const reservedNames[] = {"id", "name", "startReg", "numRegs", "error"};
+
+// Returns FIELD_NAME_NONE if the name is invalid or the pool is full
+uint8_t internFieldName(const char* name) {
+  size_t len = strlen(name);
+  if (len == 0 || len > FIELD_NAME_MAX) return FIELD_NAME_NONE;
+  // Names are written into JSON keys verbatim
+  for (const char* p = name; *p; p++) {
+    if (*p == '"' || *p == '\\' || (uint8_t)*p < 0x20) return FIELD_NAME_NONE;
+  }
+  for (const char* reserved : reservedNames) {
+    if (strcmp(name, reserved) == 0) return FIELD_NAME_NONE;
+  }
+  if (strncmp(name, "reg", 3) == 0 && isdigit(name[3])) return FIELD_NAME_NONE;
+
+  for (uint8_t i = 0; i < nameCount; i++) {
+    if (strcmp(namePool + nameOffsets[i], name) == 0) return i;
+  }
+  if (nameCount >= MAX_FIELD_NAMES || poolUsed + len + 1 > FIELD_NAME_POOL_SIZE) return FIELD_NAME_NONE;
+  memcpy(namePool + poolUsed, name, len + 1);
+  nameOffsets[nameCount] = poolUsed;
+  poolUsed += len + 1;
+  return nameCount++;
+}
+
+const char* fieldName(uint8_t index) {
+  return index < nameCount ? namePool + nameOffsets[index] : "";
+}
+
+// ----------------- Field types -----------------
+
+static const char* const typeNames[] = {"u16", "s16", "u32", "s32", "f32"};
+
+bool parseFieldType(const char* text, uint8_t& type) {
+  for (uint8_t t = 0; t < sizeof(typeNames) / sizeof(typeNames[0]); t++) {
+    if (strcmp(text, typeNames[t]) == 0) {
+      type = t;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* fieldTypeName(uint8_t type) {
+  type &= FIELD_TYPE_MASK;
+  return type < FIELD_RAW ? typeNames[type] : "raw";
+}
+
+uint8_t fieldWords(const RegField& field) {
+  uint8_t type = field.type & FIELD_TYPE_MASK;
+  return type == FIELD_U32 || type == FIELD_S32 || type == FIELD_F32 ? 2 : 1;
+}
+
+// ----------------- Compiling -----------------
+
+// Image position of a register address, or -1 if no range covers it
+static int16_t imageIndexOf(const ModbusSlave& slave, uint16_t address, uint8_t& rangeOut) {
+  uint16_t offset = 0;
+  for (uint8_t r = 0; r < slaveRangeCount(slave); r++) {
+    RegRange range = slaveRange(slave, r);
+    if (address >= range.start && address < range.start + range.count) {
+      rangeOut = r;
+      return offset + address - range.start;
+    }
+    offset += range.count;
+  }
+  return -1;
+}
+
+// Resolves every field's register address to its image position. Fails if
+// a field isn't covered by the slave's ranges or its words straddle two ranges.
+bool compileRegisterMap(ModbusSlave& slave) {
+  RegField* fields = slaveFields(slave);
+  for (uint8_t i = 0; i < slave.fieldCount; i++) {
+    RegField& field = fields[i];
+    uint8_t range, lastRange;
+    int16_t index = imageIndexOf(slave, field.reg, range);
+    if (index < 0) return false;
+    if (fieldWords(field) == 2 &&
+        (imageIndexOf(slave, field.reg + 1, lastRange) != index + 1 || lastRange != range)) {
+      return false;
+    }
+    field.index = index;
+  }
+  return true;
+}
+
+// ----------------- Decoding -----------------
+
+// Explicit map, or one entry per register for the implicit layout
+uint8_t slaveFieldCount(const ModbusSlave& slave) {
+  return slave.fieldCount ? slave.fieldCount : slaveImageSize(slave);
+}
+
+// Implicit layout: temperature and humidity in tenths, then raw registers
+// keyed by offset (primary range) or absolute address (extra ranges)
+RegField slaveField(const ModbusSlave& slave, uint8_t i) {
+  if (slave.fieldCount) return slaveFields(slave)[i];
+
+  RegField field = {0, FIELD_RAW, FIELD_NAME_NONE, i, 0, 0.0f, 1.0};
+  if (i == 0 && slave.numRegs >= 1) {
+    field.type = FIELD_S16;
+    field.name = FIELD_NAME_TEMPERATURE;
+  } else if (i == 1 && slave.numRegs >= 2) {
+    field.type = FIELD_U16;
+    field.name = FIELD_NAME_HUMIDITY;
+  }
+  if (field.type != FIELD_RAW) {
+    field.reg = slave.startReg + i;
+    field.decimals = 1;
+    field.scale = 0.1;
+    return field;
+  }
+
+  if (i < slave.numRegs) {
+    field.reg = i;
+    return field;
+  }
+  uint16_t offset = slave.numRegs;
+  for (uint8_t r = 0; r < slave.extraRangeCount; r++) {
+    if (i < offset + slave.extraRanges[r].count) {
+      field.reg = slave.extraRanges[r].start + i - offset;
+      break;
+    }
+    offset += slave.extraRanges[r].count;
+  }
+  return field;
+}
+
+double decodeField(const RegField& field, const uint16_t* image) {
+  const uint16_t* words = image + field.index;
+  uint8_t type = field.type & FIELD_TYPE_MASK;
+  if (type == FIELD_RAW) return words[0];
+
+  uint32_t raw32 = 0;
+  if (fieldWords(field) == 2) {
+    raw32 = (field.type & FIELD_WORD_SWAP) ? ((uint32_t)words[1] << 16) | words[0]
+                                           : ((uint32_t)words[0] << 16) | words[1];
+  }
+  double value;
+  switch (type) {
+    case FIELD_S16: value = (int16_t)words[0]; break;
+    case FIELD_U32: value = raw32; break;
+    case FIELD_S32: value = (int32_t)raw32; break;
+    case FIELD_F32: {
+      float f;
+      memcpy(&f, &raw32, sizeof(f));
+      value = f;
+      break;
+    }
+    default: value = words[0]; break;
+  }
+  return value * field.scale + field.offset;
+}
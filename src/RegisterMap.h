@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Per-slave register maps. Each RegField names one value, its type and
+// scaling; compileRegisterMap() resolves register addresses to positions in
+// the slave's register image once, so decoding a poll is a loop over a fixed
+// descriptor list. Slaves without a map get the implicit one the gateway
+// always had: temperature (s16 / 10), humidity (u16 / 10), then raw regN.
+
+#define FIELD_U16 0
+#define FIELD_S16 1
+#define FIELD_U32 2
+#define FIELD_S32 3
+#define FIELD_F32 4
+#define FIELD_RAW 5             // implicit map only: unconverted register published as reg<reg>
+#define FIELD_TYPE_MASK 0x0F
+#define FIELD_WORD_SWAP 0x80    // 32-bit value with the low word first (CDAB)
+
+#define MAX_FIELD_NAMES 64
+#define FIELD_NAME_POOL_SIZE 768
+#define FIELD_NAME_MAX 24
+#define FIELD_NAME_NONE 0xFF
+#define MAX_FIELD_DECIMALS 6
+
+// Names every pool starts with
+#define FIELD_NAME_TEMPERATURE 0
+#define FIELD_NAME_HUMIDITY 1
+
+// Function declarations
+uint8_t internFieldName(const char* name);
+const char* fieldName(uint8_t index);
+bool parseFieldType(const char* text, uint8_t& type);
+const char* fieldTypeName(uint8_t type);
+bool compileRegisterMap(ModbusSlave& slave);
+uint8_t slaveFieldCount(const ModbusSlave& slave);
+RegField slaveField(const ModbusSlave& slave, uint8_t i);
+uint8_t fieldWords(const RegField& field);
+double decodeField(const RegField& field, const uint16_t* image);
@@ -0,0 +1,490 @@
+#include "ResultEncoder.h"
+#include "ReadPlanner.h"
+#include "RegisterMap.h"
+#include "SlaveTable.h"
+#include "PollScheduler.h"
+#include "Hal.h"
+
+static char resultArena[RESULT_ARENA_SIZE];
+static size_t arenaPos = 0;
+static bool arenaFull = false;
+
+// ----------------- Arena writers -----------------
+
+static void putChar(char c) {
+  if (arenaPos < RESULT_ARENA_SIZE) resultArena[arenaPos++] = c;
+  else arenaFull = true;
+}
+
+static void putRaw(const char* s) {
+  while (*s) putChar(*s++);
+}
+
+static void putUnsigned(uint32_t v) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (n) putChar(digits[--n]);
+}
+
+// Energy counters and epoch milliseconds pass 32 bits: high part, then
+// nine padded digits
+static void putUnsigned64(uint64_t v) {
+  if (v < 1000000000ULL) {
+    putUnsigned(v);
+    return;
+  }
+  putUnsigned(v / 1000000000ULL);
+  uint32_t low = v % 1000000000ULL;
+  for (uint32_t div = 100000000; div; div /= 10) putChar('0' + low / div % 10);
+}
+
+static const double decimalScale[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// Decoded value rounded to the field's decimals, as integer digits; keeps
+// printf's float support out of the build. NaN, infinities and values too
+// large for the digits come out as null.
+static void putDecimal(double value, uint8_t decimals) {
+  double scaled = round(fabs(value) * decimalScale[decimals]);
+  if (!(scaled < 1e15)) {
+    putRaw("null");
+    return;
+  }
+  uint64_t digits = (uint64_t)scaled;
+  uint64_t unit = (uint64_t)decimalScale[decimals];
+  if (value < 0 && digits) putChar('-');
+  putUnsigned64(digits / unit);
+  if (decimals == 0) return;
+  putChar('.');
+  uint32_t fraction = digits % unit;
+  for (uint32_t div = unit / 10; div; div /= 10) putChar('0' + fraction / div % 10);
+}
+
+static void putString(const char* s) {
+  static const char hex[] = "0123456789abcdef";
+  putChar('"');
+  for (; *s; s++) {
+    uint8_t c = *s;
+    if (c == '"' || c == '\\') {
+      putChar('\\');
+      putChar(c);
+    } else if (c < 0x20) {
+      putRaw("\\u00");
+      putChar(hex[c >> 4]);
+      putChar(hex[c & 0xF]);
+    } else {
+      putChar(c);
+    }
+  }
+  putChar('"');
+}
+
+// ,"key": (the comma is skipped for the first member)
+static void putKey(const char* key) {
+  if (resultArena[arenaPos - 1] != '{') putChar(',');
+  putChar('"');
+  putRaw(key);
+  putRaw("\":");
+}
+
+static void putRegKey(uint16_t address) {
+  putChar(',');
+  putRaw("\"reg");
+  putUnsigned(address);
+  putRaw("\":");
+}
+
+// ----------------- MessagePack writers -----------------
+
+static void putPackHeader(uint8_t tiny, uint8_t wide, uint16_t n, uint8_t tinyLimit) {
+  if (n < tinyLimit) {
+    putChar(tiny | n);
+  } else {
+    putChar(wide);
+    putChar(n >> 8);
+    putChar(n & 0xFF);
+  }
+}
+
+static void putPackInt(int32_t v) {
+  if (v >= 0 && v < 128) {
+    putChar(v);                     // positive fixint
+  } else if (v >= -32 && v < 0) {
+    putChar(0xE0 | (v & 0x1F));     // negative fixint
+  } else if (v >= 0 && v < 256) {
+    putChar(0xCC);
+    putChar(v);
+  } else if (v >= 0 && v < 65536) {
+    putChar(0xCD);
+    putChar(v >> 8);
+    putChar(v & 0xFF);
+  } else if (v >= -128 && v < 128) {
+    putChar(0xD0);
+    putChar(v & 0xFF);
+  } else if (v >= -32768 && v < 32768) {
+    putChar(0xD1);
+    putChar((v >> 8) & 0xFF);
+    putChar(v & 0xFF);
+  } else {
+    putChar(0xD2);
+    for (int8_t shift = 24; shift >= 0; shift -= 8) putChar((v >> shift) & 0xFF);
+  }
+}
+
+static void putPackString(const char* s) {
+  size_t len = strlen(s);
+  if (len < 32) {
+    putChar(0xA0 | len);
+  } else {
+    putChar(0xD9);                  // str8; names are far shorter than 256
+    putChar(min(len, (size_t)255));
+    len = min(len, (size_t)255);
+  }
+  while (len--) putChar(*s++);
+}
+
+static void putPackFloat(float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  putChar(0xCA);
+  for (int8_t shift = 24; shift >= 0; shift -= 8) putChar((bits >> shift) & 0xFF);
+}
+
+static void putPackDouble(double v) {
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  putChar(0xCB);
+  for (int8_t shift = 56; shift >= 0; shift -= 8) putChar((bits >> shift) & 0xFF);
+}
+
+// ----------------- Slave result -----------------
+
+static void putFieldKey(const RegField& field) {
+  if ((field.type & FIELD_TYPE_MASK) == FIELD_RAW) putRegKey(field.reg);
+  else putKey(fieldName(field.name));
+}
+
+static void putField(const RegField& field, const uint16_t* image) {
+  putFieldKey(field);
+  if ((field.type & FIELD_TYPE_MASK) == FIELD_RAW) putUnsigned(image[field.index]);
+  else putDecimal(decodeField(field, image), field.decimals);
+}
+
+// N for raw regN, -1/-2 for the built-in temperature/humidity names, the
+// name itself otherwise
+static void putFieldKeyPacked(const RegField& field) {
+  if ((field.type & FIELD_TYPE_MASK) == FIELD_RAW) putPackInt(field.reg);
+  else if (field.name == FIELD_NAME_TEMPERATURE) putPackInt(KEY_TEMPERATURE);
+  else if (field.name == FIELD_NAME_HUMIDITY) putPackInt(KEY_HUMIDITY);
+  else putPackString(fieldName(field.name));
+}
+
+// Integers when they have no fraction after rounding; float32 when the
+// rounded value has at most 7 significant digits (read back with
+// toPrecision(7)); float64 beyond that
+static void putPackNumber(double value, uint8_t decimals) {
+  double scaled = round(value * decimalScale[decimals]);
+  value = scaled / decimalScale[decimals];
+  if (!isfinite(value)) putChar(0xC0);
+  else if (fabs(value) < 2147483647.0 && value == (int32_t)value) putPackInt((int32_t)value);
+  else if (fabs(scaled) < 1e7) putPackFloat(value);
+  else putPackDouble(value);
+}
+
+static void putFieldPacked(const RegField& field, const uint16_t* image) {
+  putFieldKeyPacked(field);
+  if ((field.type & FIELD_TYPE_MASK) == FIELD_RAW) putPackInt(image[field.index]);
+  else putPackNumber(decodeField(field, image), field.decimals);
+}
+
+static void putError(uint8_t result) {
+  static const char hex[] = "0123456789abcdef";
+  putKey("error");
+  if (result == RTU_RESPONSE_TIMED_OUT) {
+    putRaw("\"timeout\"");
+    return;
+  }
+  putRaw("\"0x");
+  if (result >> 4) putChar(hex[result >> 4]);
+  putChar(hex[result & 0xF]);
+  putChar('"');
+}
+
+// Wall-clock capture time in epoch ms, 0 if unknown (clock not synced yet,
+// or taken before the last reboot)
+static uint64_t readingTimestamp(const ModbusSlave& slave, uint32_t ageMs) {
+  if (ageMs == RESULT_AGE_LIVE) return slaveSampleEpochMs(slave);
+  if (ageMs == RESULT_AGE_UNKNOWN) return 0;
+  uint64_t now = halEpochMillis();
+  return now > ageMs ? now - ageMs : 0;
+}
+
+// JSON body: id/name, then the error or the fields selected by mask, then
+// the age of a replayed reading and the capture time
+static void putSlave(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint64_t mask, bool withRanges,
+                     uint32_t ageMs) {
+  putChar('{');
+  putKey("id");
+  putUnsigned(slave.id);
+  putKey("name");
+  putString(slaveName(slave));
+  if (withRanges) {
+    putKey("startReg");
+    putUnsigned(slave.startReg);
+    putKey("numRegs");
+    putUnsigned(slave.numRegs);
+  }
+
+  if (result == RTU_SUCCESS) {
+    uint8_t count = slaveFieldCount(slave);
+    for (uint8_t i = 0; i < count; i++) {
+      if (mask & (1ULL << i)) putField(slaveField(slave, i), image);
+    }
+  } else {
+    putError(result);
+  }
+  if (ageMs != RESULT_AGE_LIVE) {
+    putKey("ageMs");
+    if (ageMs == RESULT_AGE_UNKNOWN) putRaw("null");
+    else putUnsigned(ageMs);
+  }
+  uint64_t ts = readingTimestamp(slave, ageMs);
+  if (ts) {
+    putKey("ts");
+    putUnsigned64(ts);
+  }
+  putChar('}');
+}
+
+// MessagePack record: [id, name, startReg|nil, numRegs|nil, status, {key: value}, ageMs|nil, ts]
+// (ageMs only on replayed readings, nil before ts on live ones; ts as float64,
+// exact for epoch ms, and only once the clock is synced)
+static void putSlavePacked(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint64_t mask,
+                           bool withRanges, uint32_t ageMs) {
+  uint64_t ts = readingTimestamp(slave, ageMs);
+  putPackHeader(0x90, 0xDC, ts ? 8 : ageMs == RESULT_AGE_LIVE ? 6 : 7, 16);
+  putPackInt(slave.id);
+  putPackString(slaveName(slave));
+  if (withRanges) {
+    putPackInt(slave.startReg);
+    putPackInt(slave.numRegs);
+  } else {
+    putChar(0xC0);
+    putChar(0xC0);
+  }
+  putPackInt(result);
+
+  uint8_t fields = result == RTU_SUCCESS ? slaveFieldCount(slave) : 0;
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < fields; i++) {
+    if (mask & (1ULL << i)) count++;
+  }
+  putPackHeader(0x80, 0xDE, count, 16);
+  for (uint8_t i = 0; i < fields; i++) {
+    if (mask & (1ULL << i)) putFieldPacked(slaveField(slave, i), image);
+  }
+  if (ageMs == RESULT_AGE_UNKNOWN || (ageMs == RESULT_AGE_LIVE && ts)) putChar(0xC0);
+  else if (ageMs != RESULT_AGE_LIVE) putPackInt(min(ageMs, (uint32_t)INT32_MAX));
+  if (ts) putPackDouble((double)ts);
+}
+
+static void startArena() {
+  arenaPos = 0;
+  arenaFull = false;
+}
+
+static size_t finishArena() {
+  return arenaFull ? 0 : arenaPos;
+}
+
+// Whole poll: a one-element JSON array (the mqttTopicPub format) or a
+// MessagePack result list; returns the payload length, 0 if it didn't fit
+size_t encodeSlaveResult(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint8_t format,
+                         uint32_t ageMs) {
+  startArena();
+  if (format == PAYLOAD_MSGPACK) {
+    putPackHeader(0x90, 0xDC, 3, 16);
+    putPackInt(PAYLOAD_SCHEMA_VERSION);
+    putPackInt(PAYLOAD_KIND_RESULTS);
+    putSlavePacked(slave, result, image, ~0ULL, true, ageMs);
+  } else {
+    putChar('[');
+    putSlave(slave, result, image, ~0ULL, true, ageMs);
+    putChar(']');
+  }
+  return finishArena();
+}
+
+// Only the fields set in mask, as a single object (per-slave topics)
+size_t encodeSlaveReport(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint64_t mask,
+                         uint8_t format, uint32_t ageMs) {
+  startArena();
+  if (format == PAYLOAD_MSGPACK) {
+    putPackHeader(0x90, 0xDC, 3, 16);
+    putPackInt(PAYLOAD_SCHEMA_VERSION);
+    putPackInt(PAYLOAD_KIND_REPORT);
+    putSlavePacked(slave, result, image, mask, false, ageMs);
+  } else {
+    putSlave(slave, result, image, mask, false, ageMs);
+  }
+  return finishArena();
+}
+
+// The same object as a server-sent event, "data: {...}\n\n" (LiveData's /events)
+size_t encodeSlaveEvent(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint64_t mask,
+                        uint32_t ageMs) {
+  startArena();
+  putRaw("data: ");
+  putSlave(slave, result, image, mask, false, ageMs);
+  putRaw("\n\n");
+  return finishArena();
+}
+
+// ----------------- Window summaries -----------------
+
+// Means get two more digits than the field's own values
+static uint8_t meanDecimals(const RegField& field) {
+  return min(field.decimals + 2, MAX_FIELD_DECIMALS);
+}
+
+// JSON: {"id":1,"name":"s1","windowMs":60000,"start":..,"end":..,"count":N,
+// "errors":N,"temperature":[min,max,mean,last],...}; MessagePack: [2, 2,
+// [id, name, windowMs, count, errors, {key: [min, max, mean, last]}, start|nil,
+// end|nil]]. start/end are epoch ms (float64), left out while the clock
+// isn't synced; a field without a sample in the window is null.
+size_t encodeWindowSummary(const ModbusSlave& slave, const WindowState& window, const WindowField* windows,
+                           uint64_t startEpochMs, uint64_t endEpochMs, uint8_t format) {
+  startArena();
+  if (format == PAYLOAD_MSGPACK) {
+    putPackHeader(0x90, 0xDC, 3, 16);
+    putPackInt(PAYLOAD_SCHEMA_VERSION);
+    putPackInt(PAYLOAD_KIND_WINDOW);
+    putPackHeader(0x90, 0xDC, 8, 16);
+    putPackInt(slave.id);
+    putPackString(slaveName(slave));
+    putPackInt(min(slave.windowMs, (uint32_t)INT32_MAX));
+    putPackInt(min(window.polls, (uint32_t)INT32_MAX));
+    putPackInt(min(window.errors, (uint32_t)INT32_MAX));
+    putPackHeader(0x80, 0xDE, slave.windowFields, 16);
+    for (uint8_t i = 0; i < slave.windowFields; i++) {
+      RegField field = slaveField(slave, i);
+      const WindowField& w = windows[i];
+      putFieldKeyPacked(field);
+      if (!w.count) {
+        putChar(0xC0);
+        continue;
+      }
+      putChar(0x94);
+      putPackNumber(w.min, field.decimals);
+      putPackNumber(w.max, field.decimals);
+      putPackNumber(w.sum / w.count, meanDecimals(field));
+      putPackNumber(w.last, field.decimals);
+    }
+    for (uint64_t ts : {startEpochMs, endEpochMs}) {
+      if (ts) putPackDouble((double)ts);
+      else putChar(0xC0);
+    }
+    return finishArena();
+  }
+
+  putChar('{');
+  putKey("id");
+  putUnsigned(slave.id);
+  putKey("name");
+  putString(slaveName(slave));
+  putKey("windowMs");
+  putUnsigned(slave.windowMs);
+  if (startEpochMs) {
+    putKey("start");
+    putUnsigned64(startEpochMs);
+    putKey("end");
+    putUnsigned64(endEpochMs);
+  }
+  putKey("count");
+  putUnsigned(window.polls);
+  putKey("errors");
+  putUnsigned(window.errors);
+  for (uint8_t i = 0; i < slave.windowFields; i++) {
+    RegField field = slaveField(slave, i);
+    const WindowField& w = windows[i];
+    putFieldKey(field);
+    if (!w.count) {
+      putRaw("null");
+      continue;
+    }
+    putChar('[');
+    putDecimal(w.min, field.decimals);
+    putChar(',');
+    putDecimal(w.max, field.decimals);
+    putChar(',');
+    putDecimal(w.sum / w.count, meanDecimals(field));
+    putChar(',');
+    putDecimal(w.last, field.decimals);
+    putChar(']');
+  }
+  putChar('}');
+  return finishArena();
+}
+
+// ----------------- Batches -----------------
+
+// Several polls in one payload: the mqttTopicPub JSON array with more than
+// one element, or a MessagePack result list. The list header is written as
+// array16 and its count filled in by finishResultBatch().
+static uint16_t batchRecords = 0;
+static uint8_t batchFormat = PAYLOAD_JSON;
+
+void beginResultBatch(uint8_t format) {
+  startArena();
+  batchRecords = 0;
+  batchFormat = format;
+  if (format == PAYLOAD_MSGPACK) {
+    putPackHeader(0x90, 0xDC, 0xFFFF, 0);  // always array16
+    putPackInt(PAYLOAD_SCHEMA_VERSION);
+    putPackInt(PAYLOAD_KIND_RESULTS);
+  } else {
+    putChar('[');
+  }
+}
+
+// Appends one poll; false (and nothing written) if the payload would pass limit
+bool addBatchResult(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint32_t ageMs, size_t limit) {
+  size_t mark = arenaPos;
+  if (batchFormat == PAYLOAD_MSGPACK) {
+    putSlavePacked(slave, result, image, ~0ULL, true, ageMs);
+  } else {
+    if (batchRecords) putChar(',');
+    putSlave(slave, result, image, ~0ULL, true, ageMs);
+  }
+  // +1 for the closing bracket
+  if (arenaFull || arenaPos + 1 > min(limit, (size_t)RESULT_ARENA_SIZE)) {
+    arenaPos = mark;
+    arenaFull = false;
+    return false;
+  }
+  batchRecords++;
+  return true;
+}
+
+uint16_t resultBatchCount() {
+  return batchRecords;
+}
+
+// Returns the payload length, 0 for an empty batch
+size_t finishResultBatch() {
+  if (!batchRecords) return 0;
+  if (batchFormat == PAYLOAD_MSGPACK) {
+    resultArena[1] = (batchRecords + 2) >> 8;
+    resultArena[2] = (batchRecords + 2) & 0xFF;
+  } else {
+    putChar(']');
+  }
+  return finishArena();
+}
+
+const char* resultPayload() {
+  return resultArena;
+}
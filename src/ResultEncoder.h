@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Formats a finished slave poll into one static arena. Nothing is allocated
+// per poll; the arena is handed to publishPayload(), which streams it into
+// the MQTT packet.
+//
+// JSON (default), as published on mqttTopicPub:
+//   [{"id":1,"name":"s1","startReg":0,"numRegs":2,"temperature":25.3,"humidity":62.1,"ts":1767225600123}]
+// or, for per-slave topics, a single object with only the changed values.
+// Batched polls share one array. The web page's /events stream gets the same
+// objects as server-sent events.
+// Members come from the slave's register map (RegisterMap.h); without one
+// they are temperature, humidity and regN as above.
+//
+// MessagePack, schema version 2:
+//   [2, kind, record...]     kind 0 = result list, 1 = single per-slave report,
+//                            2 = window summary (see encodeWindowSummary())
+//   record = [id, name, startReg, numRegs, status, {key: value, ...}]
+// startReg/numRegs are nil in reports; status is 0 or the RTU error code.
+// Batched polls and readings replayed from the offline queue carry "ageMs"
+// (JSON member, seventh record element): milliseconds since capture, null
+// if captured before the last reboot. Once NTP has synced, readings carry
+// "ts" (JSON member, eighth record element after a nil ageMs on live ones,
+// float64): wall-clock capture time in epoch milliseconds, taken when the
+// poll's first reply arrived. Readings from before the last reboot have none.
+// Keys: -1 temperature, -2 humidity, "name" for other mapped fields, N = raw
+// "regN". Values are decoded and rounded to the field's decimals: integers,
+// float32 up to 7 significant digits, float64 beyond. (Version 1 sent
+// temperature/humidity as tenths.)
+// The Node-RED decoder is "NR - Modbus MessagePack Decoder.json".
+
+#define RESULT_ARENA_SIZE 1536  // 64 registers as "regNNNNN":NNNNN plus header and name
+
+#define PAYLOAD_JSON 0
+#define PAYLOAD_MSGPACK 1
+
+#define PAYLOAD_SCHEMA_VERSION 2
+#define PAYLOAD_KIND_RESULTS 0
+#define PAYLOAD_KIND_REPORT 1
+#define PAYLOAD_KIND_WINDOW 2          // summary over a window, see WindowAggregator
+
+#define RESULT_AGE_LIVE 0xFFFFFFFEUL     // published as it was polled, no ageMs
+#define RESULT_AGE_UNKNOWN 0xFFFFFFFFUL  // replayed from before the last reboot
+
+#define KEY_TEMPERATURE -1
+#define KEY_HUMIDITY -2
+
+// Function declarations
+size_t encodeSlaveResult(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint8_t format,
+                         uint32_t ageMs);
+size_t encodeSlaveReport(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint64_t mask,
+                         uint8_t format, uint32_t ageMs);
+size_t encodeSlaveEvent(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint64_t mask,
+                        uint32_t ageMs);
+size_t encodeWindowSummary(const ModbusSlave& slave, const WindowState& window, const WindowField* windows,
+                           uint64_t startEpochMs, uint64_t endEpochMs, uint8_t format);
+void beginResultBatch(uint8_t format);
+bool addBatchResult(const ModbusSlave& slave, uint8_t result, const uint16_t* image, uint32_t ageMs, size_t limit);
+uint16_t resultBatchCount();
+size_t finishResultBatch();
+const char* resultPayload();
@@ -0,0 +1,250 @@
+#include "ResultPublisher.h"
+#include "ReadPlanner.h"
+#include "RegisterMap.h"
+#include "OfflineQueue.h"
+#include "WindowAggregator.h"
+#include "SlaveTable.h"
+#include "MQTTHandler.h"
+#include "Logger.h"
+
+PublishConfig publishConfig;
+uint32_t reportsPublished = 0;
+uint32_t reportsSuppressed = 0;
+
+static unsigned long lastDrainTime = 0;
+static QueuedReading replay;
+
+// Polls waiting for the next batched publish, packed like queued readings
+static uint8_t batchBuffer[BATCH_BUFFER_SIZE];
+static uint16_t batchLength = 0;
+static uint8_t batchSamples = 0;
+static unsigned long batchStartTime = 0;
+
+// <prefix>/<slave name>; wildcard characters can't appear in a publish topic
+static char slaveTopic[MAX_TOPIC_PREFIX + 1 + 48];
+
+static const char* buildSlaveTopic(const ModbusSlave& slave) {
+  size_t n = snprintf(slaveTopic, sizeof(slaveTopic), "%s/", publishConfig.prefix);
+  for (const char* p = slaveName(slave); *p && n < sizeof(slaveTopic) - 1; p++) {
+    slaveTopic[n++] = (*p == '+' || *p == '#') ? '_' : *p;
+  }
+  slaveTopic[n] = '\0';
+  return slaveTopic;
+}
+
+// Register address of an image entry (ranges are laid out back to back)
+static uint16_t imageAddress(const ModbusSlave& slave, uint16_t index) {
+  for (uint8_t r = 0; r < slaveRangeCount(slave); r++) {
+    RegRange range = slaveRange(slave, r);
+    if (index < range.count) return range.start + index;
+    index -= range.count;
+  }
+  return 0;
+}
+
+// A change is reported once it exceeds either configured threshold; with
+// neither set, any change is reported. The absolute deadband counts steps of
+// the field's scale, i.e. raw register counts for 16-bit fields.
+static bool pastDeadband(const ModbusSlave& slave, const RegField& field, const uint16_t* image) {
+  double last = decodeField(field, slaveReportedImage(slave));
+  double delta = fabs(decodeField(field, image) - last);
+  if (!(delta > 0)) return false;
+
+  uint16_t absolute = slave.deadband;
+  uint8_t percent = slave.deadbandPct;
+  uint16_t address = imageAddress(slave, field.index);
+  const RegDeadband* overrides = slaveDeadbands(slave);
+  for (uint8_t i = 0; i < slave.regDeadbandCount; i++) {
+    if (overrides[i].reg == address) {
+      absolute = overrides[i].absolute;
+      percent = overrides[i].percent;
+      break;
+    }
+  }
+
+  if (absolute == 0 && percent == 0) return true;
+  double step = field.scale != 0 ? fabs(field.scale) : 1.0;
+  if (absolute && delta / step > absolute + 1e-6) return true;
+  return percent && delta * 100 > percent * fabs(last);
+}
+
+void resetSlaveReport(ModbusSlave& slave) {
+  slaveReportedReading(slave) = SlaveReading();
+}
+
+static uint8_t readingWords(const ModbusSlave& slave, uint8_t result) {
+  return result == RTU_SUCCESS ? slaveImageSize(slave) : 0;
+}
+
+static void queueLive(const ModbusSlave& slave, uint8_t result, const uint16_t* image) {
+  queueReading(slave.id, result, image, readingWords(slave, result), slaveSampling(slave).sampleTime);
+}
+
+// Deleted or re-ranged since it was taken: the stored image no longer fits
+static ModbusSlave* readingSlave(const QueuedReading& reading) {
+  ModbusSlave* slave = findSlaveById(reading.slaveId);
+  if (!slave || (reading.result == RTU_SUCCESS && reading.words != slaveImageSize(*slave))) return nullptr;
+  return slave;
+}
+
+// ----------------- Batching -----------------
+
+// Publishes the collected polls as one array (several if they pass
+// batchBytes); each keeps its own ageMs. Polls that can't be sent go to the
+// offline queue with their original capture time.
+static void flushBatch() {
+  uint16_t pos = 0;
+  while (pos < batchLength) {
+    uint16_t first = pos;
+    unsigned long now = millis();
+    beginResultBatch(publishConfig.format);
+    while (pos < batchLength) {
+      uint16_t size = unpackReading(batchBuffer + pos, batchLength - pos, replay);
+      ModbusSlave* slave = readingSlave(replay);
+      if (slave && !addBatchResult(*slave, replay.result, replay.image, now - replay.capturedMs, publishConfig.batchBytes)) {
+        if (resultBatchCount()) break;  // starts the next payload
+        // A single poll bigger than batchBytes goes out on its own
+        if (!addBatchResult(*slave, replay.result, replay.image, now - replay.capturedMs, RESULT_ARENA_SIZE)) {
+          LOG_ERROR("❌ Result for slave %u exceeds the encoder arena", slave->id);
+        }
+      }
+      pos += size;
+    }
+
+    size_t length = finishResultBatch();
+    if (length && !(mqttClient.connected() && publishPayload(mqttTopicPub, resultPayload(), length))) {
+      for (pos = first; pos < batchLength;) {
+        pos += unpackReading(batchBuffer + pos, batchLength - pos, replay);
+        queueReading(replay.slaveId, replay.result, replay.image, replay.words, replay.capturedMs);
+      }
+    }
+  }
+  batchLength = 0;
+  batchSamples = 0;
+}
+
+static void batchReading(const ModbusSlave& slave, uint8_t result, const uint16_t* image) {
+  uint8_t words = readingWords(slave, result);
+  unsigned long sampleTime = slaveSampling(slave).sampleTime;
+  uint16_t size = packReading(batchBuffer + batchLength, BATCH_BUFFER_SIZE - batchLength, slave.id, result, image,
+                              words, sampleTime);
+  if (!size) {
+    flushBatch();
+    size = packReading(batchBuffer, BATCH_BUFFER_SIZE, slave.id, result, image, words, sampleTime);
+  }
+  if (batchSamples == 0) batchStartTime = millis();
+  batchLength += size;
+  batchSamples++;
+  if (batchSamples >= publishConfig.batchCount) flushBatch();
+}
+
+// ----------------- Publishing -----------------
+
+// Run once per finished poll. Whatever can't go out right now goes to the
+// offline queue instead. Slaves with a summary window only publish their
+// polls if windowRaw is set.
+void publishSlaveResult(ModbusSlave& slave, uint8_t result, const uint16_t* image) {
+  if (slave.windowMs) {
+    aggregateReading(slave, result, image);
+    if (!slave.windowRaw) return;
+  }
+  if (!publishConfig.perSlave) {
+    if (publishConfig.batchCount > 1) {
+      batchReading(slave, result, image);
+      return;
+    }
+    if (!mqttClient.connected()) {
+      queueLive(slave, result, image);
+      return;
+    }
+    size_t length = encodeSlaveResult(slave, result, image, publishConfig.format, RESULT_AGE_LIVE);
+    if (!length) LOG_ERROR("❌ Result for slave %u exceeds the encoder arena", slave.id);
+    else if (!publishPayload(mqttTopicPub, resultPayload(), length)) queueLive(slave, result, image);
+    return;
+  }
+
+  // Full report on the first poll, on any error-state change and at the
+  // heartbeat; otherwise only fields past their deadband
+  unsigned long now = millis();
+  uint8_t count = slaveFieldCount(slave);
+  SlaveReading& reported = slaveReportedReading(slave);
+  bool full = !reported.valid || result != reported.result || now - reported.time >= publishConfig.heartbeatMs;
+  uint64_t mask = 0;
+  if (result == RTU_SUCCESS) {
+    for (uint8_t i = 0; i < count; i++) {
+      if (full || pastDeadband(slave, slaveField(slave, i), image)) mask |= 1ULL << i;
+    }
+  }
+  if (!full && mask == 0) {
+    reportsSuppressed++;
+    return;
+  }
+
+  // Queued counts as reported: the replay carries the whole reading, and
+  // later changes are measured against it
+  if (mqttClient.connected()) {
+    size_t length = encodeSlaveReport(slave, result, image, mask, publishConfig.format, RESULT_AGE_LIVE);
+    if (!length) {
+      LOG_ERROR("❌ Result for slave %u exceeds the encoder arena", slave.id);
+      return;
+    }
+    if (!publishPayload(buildSlaveTopic(slave), resultPayload(), length)) queueLive(slave, result, image);
+  } else {
+    queueLive(slave, result, image);
+  }
+
+  reportsPublished++;
+  uint16_t* reportedImage = slaveReportedImage(slave);
+  for (uint8_t i = 0; i < count; i++) {
+    if (!(mask & (1ULL << i))) continue;
+    RegField field = slaveField(slave, i);
+    for (uint8_t w = 0; w < fieldWords(field); w++) {
+      reportedImage[field.index + w] = image[field.index + w];
+    }
+  }
+  reported.result = result;
+  reported.valid = true;
+  if (full) reported.time = now;
+}
+
+// ----------------- Between polls -----------------
+
+// Closes summary windows nobody polled past the end of, flushes a batch at
+// its deadline (or once batching is switched off), then
+// replays queued readings in small batches once the broker is back. Replay
+// runs only between polls and at most every QUEUE_DRAIN_INTERVAL_MS, so
+// live polling and publishing keep their share of loop().
+void servicePublishing() {
+  serviceWindows();
+  if (batchSamples && (publishConfig.perSlave || publishConfig.batchCount <= 1 ||
+                       millis() - batchStartTime >= publishConfig.batchMs)) {
+    flushBatch();
+  }
+
+  queueService();
+  if (queueEmpty() || !mqttClient.connected() || rtuBusy()) return;
+  unsigned long now = millis();
+  if (now - lastDrainTime < QUEUE_DRAIN_INTERVAL_MS) return;
+  lastDrainTime = now;
+
+  for (uint8_t n = 0; n < QUEUE_DRAIN_BATCH && queuePeek(replay); n++) {
+    if (replay.result == QUEUE_RESULT_WINDOW) {
+      if (!publishQueuedSummary(replay)) break;
+      queuePop();
+      continue;
+    }
+    ModbusSlave* slave = readingSlave(replay);
+    if (!slave) {
+      queuePop();
+      continue;
+    }
+
+    uint32_t ageMs = queuedAgeMs(replay);
+    size_t length = publishConfig.perSlave
+                        ? encodeSlaveReport(*slave, replay.result, replay.image, ~0ULL, publishConfig.format, ageMs)
+                        : encodeSlaveResult(*slave, replay.result, replay.image, publishConfig.format, ageMs);
+    const char* topic = publishConfig.perSlave ? buildSlaveTopic(*slave) : mqttTopicPub;
+    if (length && !publishPayload(topic, resultPayload(), length)) break;  // try again next pass
+    queuePop();
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+#include "ResultEncoder.h"
+
+// Decides what a finished poll publishes. Default: the whole result on
+// mqttTopicPub, every poll, or batchCount polls at a time in one array. Per-slave mode: <prefix>/<slave name> gets only
+// the values that moved past their deadband, plus a full report every
+// heartbeatMs and whenever the slave's error state changes. Slaves with a
+// summary window publish summaries instead (see WindowAggregator).
+
+#define DEFAULT_HEARTBEAT_MS 300000UL  // full report at least every 5 minutes
+#define MAX_TOPIC_PREFIX 32
+#define DEFAULT_BATCH_MS 1000UL        // oldest poll in a batch waits at most this long
+#define DEFAULT_BATCH_BYTES 1024       // payload size cap per batched publish
+#define MIN_STATS_MS 1000UL
+#define MIN_BATCH_BYTES 128
+#define MAX_BATCH_COUNT 64
+#define BATCH_BUFFER_SIZE 2048         // raw polls held for one batch
+
+struct PublishConfig {
+  bool perSlave = false;
+  char prefix[MAX_TOPIC_PREFIX + 1] = "modbus";
+  uint32_t heartbeatMs = DEFAULT_HEARTBEAT_MS;
+  uint8_t format = PAYLOAD_JSON;  // or PAYLOAD_MSGPACK
+  // Shared-topic mode only: polls per publish (1 = no batching), plus the
+  // deadline and payload size that flush a batch early
+  uint8_t batchCount = 1;
+  uint32_t batchMs = DEFAULT_BATCH_MS;
+  uint16_t batchBytes = DEFAULT_BATCH_BYTES;
+  uint32_t statsMs = 0;           // gateway stats on <prefix>/stats this often, 0 = off (see Metrics)
+};
+
+extern PublishConfig publishConfig;
+extern uint32_t reportsPublished;   // per-slave mode
+extern uint32_t reportsSuppressed;  // polls with nothing past its deadband
+
+// Function declarations
+void publishSlaveResult(ModbusSlave& slave, uint8_t result, const uint16_t* image);
+void resetSlaveReport(ModbusSlave& slave);
+void servicePublishing();
@@ -0,0 +1,325 @@
+#include "RtuMaster.h"
+
+// Engine state
+static RtuState rtuState = RTU_IDLE;
+static uint32_t rtuCharMicros = 1042;   // one 10-bit (8N1) character at 9600 baud
+static uint32_t rtuT15Micros = 1719;    // longest gap allowed inside a frame
+static uint32_t rtuT35Micros = 4010;    // silent interval between frames
+
+// Current transaction
+static uint8_t txFrame[RTU_MAX_FRAME];
+static uint16_t txLength = 0;
+static bool txRegisterRead = false;      // rtuStartRead(): the reply must hold exactly the registers asked for
+static bool txStarted = false;
+static uint16_t txSent = 0;
+static uint32_t txStartMicros = 0;
+static uint32_t txEndMicros = 0;          // when the last byte written so far leaves the wire
+static uint16_t turnaroundTimeoutMs = 0;  // DE release to first reply byte
+static uint32_t waitStartMillis = 0;
+static uint32_t turnaroundMicros = 0;     // DE release to first reply byte, as seen by rtuPoll()
+static uint32_t transactionMicros = 0;    // first request byte to result
+static uint32_t replyMicros = 0;          // when the reply's last byte was seen
+static uint64_t busyMicros = 0;           // all transactions since boot
+
+static uint8_t rxFrame[RTU_MAX_FRAME];
+static uint16_t rxLength = 0;
+static uint16_t rxCrc = 0xFFFF;
+static bool rxGapSeen = false;          // a t1.5 gap split the frame
+static uint32_t lastBusActivityMicros = 0;
+static uint8_t rtuResultCode = RTU_SUCCESS;
+
+// CRC-16/MODBUS, one byte at a time so it can run while bytes arrive
+uint16_t crc16Update(uint16_t crc, uint8_t b) {
+  crc ^= b;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+  }
+  return crc;
+}
+
+// Expected response length once enough of the header is in, 0 if unknown
+// (yet). Functions not listed here end at t3.5 of silence.
+static uint16_t expectedResponseLength() {
+  if (rxLength < 2) return 0;
+  if (rxFrame[1] & 0x80) return 5;  // exception: id, fc, code, crc
+  switch (rxFrame[1]) {
+    case 0x05: case 0x06: case 0x0F: case 0x10:
+      return 8;                     // id, fc, address, value or quantity, crc
+    case 0x16:
+      return 10;                    // id, fc, address, and mask, or mask, crc
+    case 0x01: case 0x02: case 0x03: case 0x04: case 0x0C: case 0x11: case 0x14: case 0x15: case 0x17:
+      if (rxLength < 3) return 0;
+      return 5 + rxFrame[2];        // id, fc, byte count, data, crc
+    default:
+      return 0;
+  }
+}
+
+static void finishTransaction(uint8_t result) {
+  transactionMicros = halMicros() - txStartMicros;
+  busyMicros += transactionMicros;
+  rtuResultCode = result;
+  rtuState = RTU_DONE;
+}
+
+static void validateResponse() {
+  if (rxLength < 5 || rxGapSeen) {
+    finishTransaction(RTU_INVALID_RESPONSE);
+  } else if (rxCrc != 0) {
+    // Running the CRC over a frame including its own CRC leaves zero
+    finishTransaction(RTU_INVALID_CRC);
+  } else if (rxFrame[0] != txFrame[0]) {
+    finishTransaction(RTU_INVALID_SLAVE_ID);
+  } else if ((rxFrame[1] & 0x7F) != txFrame[1]) {
+    finishTransaction(RTU_INVALID_FUNCTION);
+  } else if (rxFrame[1] & 0x80) {
+    finishTransaction(rxFrame[2]);
+  } else if ((expectedResponseLength() && rxLength != expectedResponseLength()) ||
+             (txRegisterRead && rxFrame[2] != txFrame[5] * 2)) {
+    finishTransaction(RTU_INVALID_RESPONSE);
+  } else {
+    finishTransaction(RTU_SUCCESS);
+  }
+}
+
+void rtuBegin(uint32_t baud, uint8_t config, uint8_t dePin) {
+  halBusBegin(baud, config, dePin);
+
+  // Wire time uses the real character (ESP8266 SerialConfig: bit 1 = parity,
+  // bit 5 = two stop bits). The silent intervals use the spec's 11-bit
+  // character and are fixed above 19200 baud.
+  uint32_t bits = 1 + 8 + ((config & 0x02) ? 1 : 0) + ((config & 0x20) ? 2 : 1);
+  rtuCharMicros = (bits * 1000000UL + baud - 1) / baud;
+  uint32_t specCharMicros = (11UL * 1000000UL + baud - 1) / baud;
+  rtuT15Micros = baud > 19200 ? 750 : (specCharMicros * 3) / 2;
+  rtuT35Micros = baud > 19200 ? 1750 : (specCharMicros * 7) / 2;
+
+  rtuState = RTU_IDLE;
+  lastBusActivityMicros = halMicros();
+}
+
+bool rtuStartRead(uint8_t slaveId, uint8_t function, uint16_t startReg, uint16_t numRegs, uint16_t turnaroundMs) {
+  if (numRegs == 0 || numRegs > 125) return false;
+  uint8_t pdu[5] = {function, (uint8_t)(startReg >> 8), (uint8_t)(startReg & 0xFF), (uint8_t)(numRegs >> 8),
+                    (uint8_t)(numRegs & 0xFF)};
+  if (!rtuStartRequest(slaveId, pdu, sizeof(pdu), turnaroundMs)) return false;
+  txRegisterRead = true;
+  return true;
+}
+
+// Any function: the PDU (function code and data) goes out as it is. The
+// reply is checked for address, function, CRC and, where the function
+// defines it, length; rtuResponsePdu() hands it back.
+bool rtuStartRequest(uint8_t slaveId, const uint8_t* pdu, uint8_t pduLength, uint16_t turnaroundMs) {
+  if (rtuBusy() || pduLength == 0 || pduLength > RTU_MAX_FRAME - 3) return false;
+
+  txFrame[0] = slaveId;
+  memcpy(txFrame + 1, pdu, pduLength);
+  txLength = 1 + pduLength;
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < txLength; i++) crc = crc16Update(crc, txFrame[i]);
+  txFrame[txLength++] = crc & 0xFF;
+  txFrame[txLength++] = crc >> 8;
+
+  txRegisterRead = false;
+  txStarted = false;
+  turnaroundTimeoutMs = turnaroundMs;
+  rxLength = 0;
+  rxCrc = 0xFFFF;
+  rxGapSeen = false;
+  turnaroundMicros = 0;
+  rtuResultCode = RTU_SUCCESS;
+  rtuState = RTU_TRANSMIT;
+  return true;
+}
+
+RtuState rtuPoll() {
+  uint32_t nowMicros = halMicros();
+
+  switch (rtuState) {
+    case RTU_TRANSMIT:
+      if (!txStarted) {
+        // Frames must be separated by at least t3.5 of silence
+        if (halBusAvailable() > 0) {
+          // Drop stray bytes (late replies, line noise) before talking
+          uint8_t n = RTU_BYTES_PER_POLL;
+          while (n-- && halBusAvailable() > 0) halBusRead();
+          lastBusActivityMicros = nowMicros;
+          break;
+        }
+        if (nowMicros - lastBusActivityMicros < rtuT35Micros) break;
+
+        halBusSetTransmit(true);
+        txStartMicros = nowMicros;
+        txEndMicros = nowMicros;
+        txSent = 0;
+        txStarted = true;
+      }
+      // Only what fits the UART FIFO is written, so write() never waits; a
+      // frame longer than the FIFO is topped up over the next passes
+      if (txSent < txLength) {
+        uint16_t n = min((uint16_t)max(halBusAvailableForWrite(), 0), (uint16_t)(txLength - txSent));
+        if (n) {
+          halBusWrite(txFrame + txSent, n);
+          txSent += n;
+          if ((int32_t)(nowMicros - txEndMicros) > 0) txEndMicros = nowMicros;
+          txEndMicros += n * rtuCharMicros;
+        }
+        break;
+      }
+      // Release the driver once the last stop bit has left the shift register.
+      // While the FIFO still holds bytes this checks back on later passes;
+      // once it is empty only the character being shifted out is left, and
+      // the last RTU_DE_SPIN_MAX_US of it (never more than one character)
+      // are waited out here so DE drops on time.
+      if (halBusTxQueued() > 0) break;
+      {
+        int32_t remaining = (int32_t)(txEndMicros + rtuCharMicros / 2 - nowMicros);
+        if (remaining > (int32_t)rtuCharMicros) remaining = rtuCharMicros;
+        if (remaining > RTU_DE_SPIN_MAX_US) break;
+        if (remaining > 0) {
+          halDelayMicros(remaining);
+          nowMicros = halMicros();
+        }
+      }
+      halBusSetTransmit(false);
+      lastBusActivityMicros = nowMicros;
+      waitStartMillis = halMillis();
+      rtuState = RTU_WAIT_FIRST_BYTE;
+      break;
+
+    case RTU_WAIT_FIRST_BYTE:
+      if (halBusAvailable() > 0) {
+        turnaroundMicros = nowMicros - lastBusActivityMicros;
+        rtuState = RTU_RECEIVE;
+      } else {
+        if (halMillis() - waitStartMillis >= turnaroundTimeoutMs) {
+          finishTransaction(RTU_RESPONSE_TIMED_OUT);
+        }
+        break;
+      }
+      // Consume the first bytes in this same pass
+      [[fallthrough]];
+
+    case RTU_RECEIVE: {
+      int avail = halBusAvailable();
+      if (avail > 0) {
+        if (avail > RTU_BYTES_PER_POLL) avail = RTU_BYTES_PER_POLL;
+        while (avail--) {
+          uint8_t b = halBusRead();
+          if (rxLength < RTU_MAX_FRAME) {
+            rxFrame[rxLength++] = b;
+            rxCrc = crc16Update(rxCrc, b);
+          }
+        }
+        lastBusActivityMicros = nowMicros;
+        replyMicros = nowMicros;
+        uint16_t expected = expectedResponseLength();
+        if ((expected && rxLength >= expected) || rxLength >= RTU_MAX_FRAME) {
+          rtuState = RTU_FRAME_GAP;
+        }
+      } else {
+        // Bytes are only seen once per pass and one may still be on the wire,
+        // so a gap is proven only after t1.5 plus one character of nothing
+        uint32_t silentMicros = nowMicros - lastBusActivityMicros;
+        if (silentMicros >= rtuT35Micros) {
+          // Slave went quiet before the header said it would: frame is short
+          validateResponse();
+        } else if (silentMicros >= rtuT15Micros + rtuCharMicros) {
+          rxGapSeen = true;
+        }
+      }
+      break;
+    }
+
+    case RTU_FRAME_GAP:
+      if (halBusAvailable() > 0) {
+        // Trailing bytes mean the frame boundary was wrong; keep them so CRC fails
+        rtuState = RTU_RECEIVE;
+        break;
+      }
+      if (nowMicros - lastBusActivityMicros >= rtuT35Micros) validateResponse();
+      break;
+
+    case RTU_IDLE:
+    case RTU_DONE:
+      break;
+  }
+
+  return rtuState;
+}
+
+// Drop the current transaction; the next rtuStartRead() still honours t3.5
+void rtuAbort() {
+  if (rtuState == RTU_TRANSMIT && txStarted) {
+    halBusSetTransmit(false);
+  }
+  if (rtuBusy() && txStarted) busyMicros += halMicros() - txStartMicros;
+  lastBusActivityMicros = halMicros();
+  rtuState = RTU_IDLE;
+}
+
+bool rtuBusy() {
+  return rtuState != RTU_IDLE && rtuState != RTU_DONE;
+}
+
+uint8_t rtuResult() {
+  return rtuResultCode;
+}
+
+// Slave think time of the last transaction (granularity: one rtuPoll() pass);
+// 0 if nothing came back
+uint32_t rtuTurnaroundMicros() {
+  return turnaroundMicros;
+}
+
+// halMicros() when the reply frame finished arriving (valid once RTU_DONE with a reply)
+uint32_t rtuReplyMicros() {
+  return replyMicros;
+}
+
+// Duration of the last transaction, request to result
+uint32_t rtuTransactionMicros() {
+  return transactionMicros;
+}
+
+// Time the bus has been taken up by transactions since boot
+uint64_t rtuBusyMicros() {
+  return busyMicros;
+}
+
+uint8_t rtuResponseRegisterCount() {
+  if (rtuState != RTU_DONE || rtuResultCode != RTU_SUCCESS) return 0;
+  return rxFrame[2] / 2;
+}
+
+// Function code and data of the reply, for a success or an exception; nullptr otherwise
+const uint8_t* rtuResponsePdu(uint16_t& length) {
+  length = 0;
+  if (rtuState != RTU_DONE || rtuResultCode >= RTU_INVALID_SLAVE_ID) return nullptr;
+  length = rxLength - 3;
+  return rxFrame + 1;
+}
+
+uint16_t rtuGetResponseRegister(uint8_t index) {
+  if (index >= rtuResponseRegisterCount()) return 0;
+  return ((uint16_t)rxFrame[3 + index * 2] << 8) | rxFrame[4 + index * 2];
+}
+
+// Expected bus time of one transaction, used for load planning only
+uint32_t rtuEstimateMicros(uint16_t requestBytes, uint16_t responseBytes) {
+  return rtuWireMicros(requestBytes + responseBytes) + 2 * rtuT35Micros + RTU_TYPICAL_TURNAROUND_US;
+}
+
+// Time the given number of characters occupy the line at the current settings
+uint32_t rtuWireMicros(uint16_t bytes) {
+  return (uint32_t)bytes * rtuCharMicros;
+}
+
+// Worst case for one transaction: both frames on the wire, both silent
+// intervals, the slave's turnaround and one more t1.5 per reply byte
+uint32_t rtuTimeoutMillis(uint16_t requestBytes, uint16_t responseBytes, uint16_t turnaroundMs) {
+  uint32_t micros = rtuWireMicros(requestBytes + responseBytes) + 2 * rtuT35Micros +
+                    (uint32_t)responseBytes * rtuT15Micros;
+  return turnaroundMs + (micros + 999) / 1000;
+}
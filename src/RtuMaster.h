@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+#include "Hal.h"
+
+// Byte-driven Modbus RTU master. rtuPoll() is called once per loop() pass
+// and moves at most RTU_BYTES_PER_POLL bytes. Its only wait is for the
+// tail of the request's last character once the TX FIFO has drained (at most
+// RTU_DE_SPIN_MAX_US), so DE drops right after its stop bit.
+
+#define RTU_MAX_FRAME 256       // 5 header/CRC bytes + 250 data bytes, rounded up
+#define RTU_BYTES_PER_POLL 16   // UART bytes consumed per rtuPoll() call
+#define RTU_DE_SPIN_MAX_US 500  // longest busy-wait for the last character before releasing DE
+#define RTU_TYPICAL_TURNAROUND_US 10000  // slave think time assumed when estimating bus load
+
+// Result codes (same values as ModbusMaster so logged errors stay comparable)
+#define RTU_SUCCESS               0x00
+#define RTU_ILLEGAL_FUNCTION      0x01
+#define RTU_ILLEGAL_DATA_ADDRESS  0x02
+#define RTU_ILLEGAL_DATA_VALUE    0x03
+#define RTU_SLAVE_DEVICE_FAILURE  0x04
+#define RTU_INVALID_SLAVE_ID      0xE0
+#define RTU_INVALID_FUNCTION      0xE1
+#define RTU_RESPONSE_TIMED_OUT    0xE2
+#define RTU_INVALID_CRC           0xE3
+#define RTU_INVALID_RESPONSE      0xE4
+
+#define RTU_FC_READ_HOLDING_REGISTERS 0x03
+#define RTU_FC_READ_INPUT_REGISTERS   0x04
+
+enum RtuState {
+  RTU_IDLE,             // nothing in flight
+  RTU_TRANSMIT,         // request queued, waiting for bus silence / TX to drain
+  RTU_WAIT_FIRST_BYTE,  // DE released, waiting for the slave to answer
+  RTU_RECEIVE,          // collecting response bytes
+  RTU_FRAME_GAP,        // frame complete, waiting out t3.5 before validating
+  RTU_DONE              // rtuResult() holds the outcome
+};
+
+// Function declarations
+void rtuBegin(uint32_t baud, uint8_t config, uint8_t dePin);
+bool rtuStartRead(uint8_t slaveId, uint8_t function, uint16_t startReg, uint16_t numRegs, uint16_t turnaroundMs);
+bool rtuStartRequest(uint8_t slaveId, const uint8_t* pdu, uint8_t pduLength, uint16_t turnaroundMs);
+RtuState rtuPoll();
+void rtuAbort();
+bool rtuBusy();
+uint8_t rtuResult();
+uint32_t rtuTurnaroundMicros();
+uint32_t rtuReplyMicros();
+uint32_t rtuTransactionMicros();
+uint64_t rtuBusyMicros();
+uint8_t rtuResponseRegisterCount();
+uint16_t rtuGetResponseRegister(uint8_t index);
+const uint8_t* rtuResponsePdu(uint16_t& length);
+uint32_t rtuEstimateMicros(uint16_t requestBytes, uint16_t responseBytes);
+uint32_t rtuWireMicros(uint16_t bytes);
+uint32_t rtuTimeoutMillis(uint16_t requestBytes, uint16_t responseBytes, uint16_t turnaroundMs);
+uint16_t crc16Update(uint16_t crc, uint8_t b);
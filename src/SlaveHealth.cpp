@@ -0,0 +1,85 @@
+#include "SlaveHealth.h"
+#include "SlaveTable.h"
+#include "Logger.h"
+
+// Back to "nothing known": the configured turnaround and a closed breaker
+void resetSlaveHealth(ModbusSlave& slave) {
+  slaveHealth(slave) = SlaveHealth();
+}
+
+// Reply timeout for the next read; probes and unknown slaves get the full turnaroundMs
+uint16_t slaveTimeoutMs(const ModbusSlave& slave) {
+  const SlaveHealth& health = slaveHealth(slave);
+  if (health.probeLevel || health.timeoutMs == 0) return busConfig.turnaroundMs;
+  return min(health.timeoutMs, busConfig.turnaroundMs);
+}
+
+// Time between polls: the configured period, or the probe interval while the breaker is open
+uint32_t slavePeriodMs(const ModbusSlave& slave) {
+  uint8_t probeLevel = slaveHealth(slave).probeLevel;
+  if (!probeLevel) return slave.pollMs;
+  uint32_t probeMs = min(HEALTH_PROBE_MIN_MS << (probeLevel - 1), HEALTH_PROBE_MAX_MS);
+  return max(probeMs, slave.pollMs);
+}
+
+// One reply's turnaround: srtt += (s - srtt) / 8, rttvar += (|s - srtt| - rttvar) / 4
+void recordTurnaround(ModbusSlave& slave, uint32_t micros) {
+  SlaveHealth& health = slaveHealth(slave);
+  int32_t sample = min(micros / HEALTH_RTT_UNIT_US, (uint32_t)UINT16_MAX);
+  if (health.rttSamples == 0) {
+    health.rttSmooth = sample;
+    health.rttVar = sample / 2;
+  } else {
+    int32_t error = sample - health.rttSmooth;
+    health.rttSmooth += error / 8;
+    health.rttVar += (abs(error) - (int32_t)health.rttVar) / 4;
+  }
+  if (health.rttSamples < HEALTH_MIN_SAMPLES) health.rttSamples++;
+  if (health.rttSamples < HEALTH_MIN_SAMPLES) return;
+
+  uint32_t timeoutUs = ((uint32_t)health.rttSmooth + 4UL * health.rttVar) * HEALTH_RTT_UNIT_US;
+  uint32_t timeoutMs = (timeoutUs + 999) / 1000 + HEALTH_TIMEOUT_MARGIN_MS;
+  health.timeoutMs = min(max(timeoutMs, (uint32_t)HEALTH_MIN_TIMEOUT_MS), (uint32_t)busConfig.turnaroundMs);
+}
+
+// Called once per finished poll: error window, timeout backoff, breaker
+void recordPollOutcome(ModbusSlave& slave, uint8_t result) {
+  SlaveHealth& health = slaveHealth(slave);
+  bool failed = result != RTU_SUCCESS;
+  health.recentFailures = (health.recentFailures << 1) | failed;
+  if (health.recentPolls < 16) health.recentPolls++;
+
+  if (result != RTU_RESPONSE_TIMED_OUT) {
+    // Any answer, even an exception, proves the slave is there
+    if (health.probeLevel) {
+      LOG_INFO("✅ Slave %u (%s) answers again, back to every %lu ms", slave.id, slaveName(slave),
+               (unsigned long)slave.pollMs);
+    }
+    health.timeoutStreak = 0;
+    health.probeLevel = 0;
+    return;
+  }
+
+  // A late reply rather than a dead slave? Give the next one more time
+  if (health.timeoutMs) health.timeoutMs = min((uint32_t)health.timeoutMs * 2, (uint32_t)busConfig.turnaroundMs);
+  if (health.timeoutStreak < UINT8_MAX) health.timeoutStreak++;
+
+  if (health.probeLevel) {
+    if ((HEALTH_PROBE_MIN_MS << (health.probeLevel - 1)) < HEALTH_PROBE_MAX_MS) health.probeLevel++;
+  } else if (health.timeoutStreak >= HEALTH_TRIP_TIMEOUTS) {
+    health.probeLevel = 1;
+    LOG_WARN("⚡ Slave %u (%s) not answering, probing every %lu s", slave.id, slaveName(slave),
+             (unsigned long)(slavePeriodMs(slave) / 1000));
+  }
+}
+
+// Failed polls among the last 16, in percent
+uint8_t slaveErrorPercent(const ModbusSlave& slave) {
+  const SlaveHealth& health = slaveHealth(slave);
+  if (!health.recentPolls) return 0;
+  uint16_t window = health.recentPolls < 16 ? (1 << health.recentPolls) - 1 : 0xFFFF;
+  uint8_t failures = 0;
+  for (uint16_t bits = health.recentFailures & window; bits; bits &= bits - 1) failures++;
+  return failures * 100 / health.recentPolls;
+}
+
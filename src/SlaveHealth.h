@@ -0,0 +1,28 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// Per-slave health: a smoothed turnaround (Jacobson/Karels, as TCP does for
+// its RTO) gives each slave its own reply timeout instead of the bus-wide
+// turnaroundMs, and the outcome of the last 16 polls gives an error rate.
+// A slave that times out HEALTH_TRIP_TIMEOUTS polls in a row trips its
+// breaker: it is only probed, every HEALTH_PROBE_MIN_MS doubling up to
+// HEALTH_PROBE_MAX_MS, with the full turnaroundMs. The first answer closes
+// the breaker again. A dead device then costs one wait per probe instead of
+// one per poll period.
+
+#define HEALTH_RTT_UNIT_US 100            // turnaround stats are kept in 0.1 ms
+#define HEALTH_MIN_SAMPLES 4              // replies before the timeout adapts
+#define HEALTH_MIN_TIMEOUT_MS 20          // loop() granularity plus slack
+#define HEALTH_TIMEOUT_MARGIN_MS 5
+#define HEALTH_TRIP_TIMEOUTS 3
+#define HEALTH_PROBE_MIN_MS 10000UL
+#define HEALTH_PROBE_MAX_MS 300000UL
+
+// Function declarations
+void resetSlaveHealth(ModbusSlave& slave);
+uint16_t slaveTimeoutMs(const ModbusSlave& slave);
+uint32_t slavePeriodMs(const ModbusSlave& slave);
+void recordTurnaround(ModbusSlave& slave, uint32_t micros);
+void recordPollOutcome(ModbusSlave& slave, uint8_t result);
+uint8_t slaveErrorPercent(const ModbusSlave& slave);
@@ -0,0 +1,263 @@
+#include "SlaveTable.h"
+#include "ReadPlanner.h"
+#include "RegisterMap.h"
+#include "Logger.h"
+
+ModbusSlave slaves[MAX_SLAVES];
+uint8_t slaveCount = 0;
+
+// Table position + 1 for each RTU address, 0 = no such slave
+static uint8_t slaveIndex[SLAVE_ID_MAX + 1];
+
+static char nameArena[SLAVE_NAME_ARENA_SIZE];
+static uint16_t imagePool[SLAVE_IMAGE_POOL_WORDS];
+static RegField fieldPool[SLAVE_FIELD_POOL_SIZE];
+static RegDeadband deadbandPool[SLAVE_DEADBAND_POOL_SIZE];
+static WindowField windowPool[SLAVE_WINDOW_POOL_SIZE];
+
+// Runtime state by table position, see ModBusHandler.h
+static SlaveSchedule schedules[MAX_SLAVES];
+static SlaveSampling samplings[MAX_SLAVES];
+static SlaveHealth healths[MAX_SLAVES];
+static WindowState windowStates[MAX_SLAVES];
+static SlaveReading reportedReadings[MAX_SLAVES];
+static SlaveReading lastReadings[MAX_SLAVES];
+
+// ----------------- Pools -----------------
+
+// Runs of items, one per slave, back to back in the order they were
+// added; start names the record member holding a slave's run offset.
+struct SlavePool {
+  uint8_t* data;
+  uint16_t itemSize;
+  uint16_t capacity;               // items
+  uint16_t used;
+  uint16_t ModbusSlave::*start;
+};
+
+static SlavePool namePool = {(uint8_t*)nameArena, 1, SLAVE_NAME_ARENA_SIZE, 0, &ModbusSlave::name};
+static SlavePool imageRuns = {(uint8_t*)imagePool, sizeof(uint16_t), SLAVE_IMAGE_POOL_WORDS, 0, &ModbusSlave::image};
+static SlavePool fieldRuns = {(uint8_t*)fieldPool, sizeof(RegField), SLAVE_FIELD_POOL_SIZE, 0, &ModbusSlave::firstField};
+static SlavePool deadbandRuns = {(uint8_t*)deadbandPool, sizeof(RegDeadband), SLAVE_DEADBAND_POOL_SIZE, 0,
+                                 &ModbusSlave::firstDeadband};
+static SlavePool windowRuns = {(uint8_t*)windowPool, sizeof(WindowField), SLAVE_WINDOW_POOL_SIZE, 0,
+                               &ModbusSlave::firstWindow};
+
+// Closes the gap a run leaves; later runs move down. Only on configuration
+// changes, so the memmove is fine.
+static void poolErase(SlavePool& pool, const ModbusSlave& owner, uint16_t length) {
+  if (length == 0) return;
+  uint16_t start = owner.*pool.start;
+  memmove(pool.data + start * pool.itemSize, pool.data + (start + length) * pool.itemSize,
+          (pool.used - start - length) * pool.itemSize);
+  pool.used -= length;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    if (&slaves[i] != &owner && slaves[i].*pool.start > start) slaves[i].*pool.start -= length;
+  }
+}
+
+// Copies items (or zeros, for nullptr) to the end of the pool
+static bool poolAppend(SlavePool& pool, ModbusSlave& owner, const void* items, uint16_t length) {
+  if (pool.used + length > pool.capacity) return false;
+  owner.*pool.start = pool.used;
+  uint8_t* to = pool.data + pool.used * pool.itemSize;
+  if (items) memcpy(to, items, length * pool.itemSize);
+  else memset(to, 0, length * pool.itemSize);
+  pool.used += length;
+  return true;
+}
+
+static uint16_t nameLength(const ModbusSlave& slave) {
+  return strlen(slaveName(slave)) + 1;
+}
+
+// ----------------- Runtime state -----------------
+
+static void resetSlaveState(uint8_t index) {
+  schedules[index] = SlaveSchedule();
+  samplings[index] = SlaveSampling();
+  healths[index] = SlaveHealth();
+  windowStates[index] = WindowState();
+  reportedReadings[index] = SlaveReading();
+  lastReadings[index] = SlaveReading();
+}
+
+static void moveSlaveState(uint8_t from, uint8_t to) {
+  schedules[to] = schedules[from];
+  samplings[to] = samplings[from];
+  healths[to] = healths[from];
+  windowStates[to] = windowStates[from];
+  reportedReadings[to] = reportedReadings[from];
+  lastReadings[to] = lastReadings[from];
+}
+
+// ----------------- Table -----------------
+
+void clearSlaves() {
+  slaveTableChanged();
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    slaves[i] = ModbusSlave();
+    resetSlaveState(i);
+  }
+  slaveCount = 0;
+  memset(slaveIndex, 0, sizeof(slaveIndex));
+  namePool.used = imageRuns.used = fieldRuns.used = deadbandRuns.used = windowRuns.used = 0;
+}
+
+// New slave at the end of the table with default settings; slave points to
+// it on SLAVE_OK
+uint8_t addSlave(uint8_t id, const char* name, ModbusSlave*& slave) {
+  if (id < SLAVE_ID_MIN || id > SLAVE_ID_MAX || slaveIndex[id]) return SLAVE_ERR_ID;
+  if (strlen(name) > SLAVE_NAME_MAX || slaveNameTaken(name)) return SLAVE_ERR_NAME;
+  if (slaveCount >= MAX_SLAVES) return SLAVE_ERR_FULL;
+
+  ModbusSlave& entry = slaves[slaveCount];
+  entry = ModbusSlave();
+  resetSlaveState(slaveCount);
+  entry.id = id;
+  if (!poolAppend(namePool, entry, name, strlen(name) + 1)) return SLAVE_ERR_FULL;
+  entry.firstField = fieldRuns.used;
+  entry.firstDeadband = deadbandRuns.used;
+  entry.image = imageRuns.used;
+  entry.firstWindow = windowRuns.used;
+  slaveIndex[id] = ++slaveCount;
+  invalidateReadPlan();  // appending doesn't move the slave being polled
+  slave = &entry;
+  return SLAVE_OK;
+}
+
+// Swap-remove: the last entry takes the freed position
+bool removeSlave(uint8_t id) {
+  ModbusSlave* slave = findSlaveById(id);
+  if (!slave) return false;
+  uint8_t index = slave - slaves;
+  uint8_t last = slaveCount - 1;
+  // Dropping the last entry moves nobody, unless it's the one being polled
+  if (index != last || (queryState == Q_QUERYING && currentQueryIndex == index)) cancelSlavePoll();
+  invalidateReadPlan();
+
+  poolErase(namePool, *slave, nameLength(*slave));
+  poolErase(imageRuns, *slave, 2 * slave->imageWords);
+  poolErase(fieldRuns, *slave, slave->fieldCount);
+  poolErase(deadbandRuns, *slave, slave->regDeadbandCount);
+  poolErase(windowRuns, *slave, slave->windowFields);
+
+  slaveIndex[id] = 0;
+  if (index != last) {
+    slaves[index] = slaves[last];
+    moveSlaveState(last, index);
+    slaveIndex[slaves[index].id] = index + 1;
+  }
+  slaves[last] = ModbusSlave();
+  resetSlaveState(last);
+  slaveCount--;
+  return true;
+}
+
+ModbusSlave* findSlaveById(uint8_t id) {
+  if (id > SLAVE_ID_MAX || !slaveIndex[id]) return nullptr;
+  return &slaves[slaveIndex[id] - 1];
+}
+
+// Linear, but only asked when a slave is added
+bool slaveNameTaken(const char* name) {
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    if (strcmp(slaveName(slaves[i]), name) == 0) return true;
+  }
+  return false;
+}
+
+// ----------------- Variable-sized parts -----------------
+
+// Each replaces the slave's run; false (and the part left empty) if the pool
+// has no room
+
+bool setSlaveDeadbands(ModbusSlave& slave, const RegDeadband* deadbands, uint8_t count) {
+  poolErase(deadbandRuns, slave, slave.regDeadbandCount);
+  slave.regDeadbandCount = 0;
+  if (!poolAppend(deadbandRuns, slave, deadbands, count)) return false;
+  slave.regDeadbandCount = count;
+  return true;
+}
+
+bool setSlaveFields(ModbusSlave& slave, const RegField* fields, uint8_t count) {
+  poolErase(fieldRuns, slave, slave.fieldCount);
+  slave.fieldCount = 0;
+  if (!poolAppend(fieldRuns, slave, fields, count)) return false;
+  slave.fieldCount = count;
+  return true;
+}
+
+// Sized from the slave's ranges, so call it once they're set
+bool allocSlaveImages(ModbusSlave& slave) {
+  poolErase(imageRuns, slave, 2 * slave.imageWords);
+  slave.imageWords = 0;
+  uint16_t words = slaveImageSize(slave);
+  if (!poolAppend(imageRuns, slave, nullptr, 2 * words)) return false;
+  slave.imageWords = words;
+  return true;
+}
+
+// One entry per field while windowMs is set, none otherwise; call it once
+// the register map is set. Starts the slave on a fresh window.
+bool allocSlaveWindows(ModbusSlave& slave) {
+  poolErase(windowRuns, slave, slave.windowFields);
+  slave.windowFields = 0;
+  slaveWindowState(slave).open = false;
+  uint8_t count = slave.windowMs ? slaveFieldCount(slave) : 0;
+  if (!poolAppend(windowRuns, slave, nullptr, count)) return false;
+  slave.windowFields = count;
+  return true;
+}
+
+const char* slaveName(const ModbusSlave& slave) {
+  return nameArena + slave.name;
+}
+
+const RegDeadband* slaveDeadbands(const ModbusSlave& slave) {
+  return deadbandPool + slave.firstDeadband;
+}
+
+RegField* slaveFields(const ModbusSlave& slave) {
+  return fieldPool + slave.firstField;
+}
+
+// Registers behind the last published values (report-by-exception)
+uint16_t* slaveReportedImage(const ModbusSlave& slave) {
+  return imagePool + slave.image;
+}
+
+// Registers of the last successful poll (/data, /events)
+uint16_t* slaveLastImage(const ModbusSlave& slave) {
+  return imagePool + slave.image + slave.imageWords;
+}
+
+WindowField* slaveWindows(const ModbusSlave& slave) {
+  return windowPool + slave.firstWindow;
+}
+
+SlaveSchedule& slaveSchedule(const ModbusSlave& slave) {
+  return schedules[&slave - slaves];
+}
+
+SlaveSampling& slaveSampling(const ModbusSlave& slave) {
+  return samplings[&slave - slaves];
+}
+
+SlaveHealth& slaveHealth(const ModbusSlave& slave) {
+  return healths[&slave - slaves];
+}
+
+WindowState& slaveWindowState(const ModbusSlave& slave) {
+  return windowStates[&slave - slaves];
+}
+
+// What report-by-exception last published, with slaveReportedImage()
+SlaveReading& slaveReportedReading(const ModbusSlave& slave) {
+  return reportedReadings[&slave - slaves];
+}
+
+// The last poll, with slaveLastImage()
+SlaveReading& slaveLastReading(const ModbusSlave& slave) {
+  return lastReadings[&slave - slaves];
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+
+// The slave table: slaves[0..slaveCount) stay dense, a 248-entry index maps
+// an RTU address straight to its entry, and deleting swaps the last entry
+// into the hole. Names, register maps, deadband overrides and register images
+// are variable-sized, so each kind lives in one static pool as a run per
+// slave; deleting a slave closes its runs up. Nothing here touches the heap.
+//
+// Runtime state (schedule, sampling, health, summary window, last reported
+// and last polled reading) sits in arrays beside the table, so moving a slave
+// moves that too.
+//
+// RAM at the ESP8266 defaults (32 slaves, 32-bit layout): records 32 x 64 B,
+// runtime state 2.8 KB, index 248 B, names 0.5 KB, images 1 KB, register maps
+// 2.3 KB, deadbands 0.4 KB, summary windows 5 KB, read plan and cache ages
+// 1.6 KB - about 16 KB, none of it on the heap. Every pool grows with
+// MAX_SLAVES; the host build's 247 slaves take about 89 KB.
+
+#define SLAVE_ID_MIN 1
+#define SLAVE_ID_MAX 247               // 0 is broadcast, 248-255 are reserved
+#define SLAVE_NAME_MAX 32
+#define SLAVE_NAME_ARENA_SIZE (MAX_SLAVES * 8 + 256)     // all names with their terminators
+#define SLAVE_IMAGE_POOL_WORDS (MAX_SLAVES * 12 + 128)   // two images (reported, last) per slave
+#define SLAVE_FIELD_POOL_SIZE (MAX_SLAVES * 2 + 32)     // register map entries, 3 per slave at 32 slaves
+#define SLAVE_DEADBAND_POOL_SIZE (MAX_SLAVES + 32)      // deadband overrides, 2 per slave at 32 slaves
+#define SLAVE_WINDOW_POOL_SIZE (MAX_SLAVES * 2 + 64)    // summary window fields, 4 per slave at 32 slaves
+
+// Why addSlave() refused
+#define SLAVE_OK 0
+#define SLAVE_ERR_ID 1                 // out of range or taken
+#define SLAVE_ERR_NAME 2               // too long or taken
+#define SLAVE_ERR_FULL 3               // table or a pool is full
+
+// Function declarations
+void clearSlaves();
+uint8_t addSlave(uint8_t id, const char* name, ModbusSlave*& slave);
+bool removeSlave(uint8_t id);
+ModbusSlave* findSlaveById(uint8_t id);
+bool slaveNameTaken(const char* name);
+bool setSlaveDeadbands(ModbusSlave& slave, const RegDeadband* deadbands, uint8_t count);
+bool setSlaveFields(ModbusSlave& slave, const RegField* fields, uint8_t count);
+bool allocSlaveImages(ModbusSlave& slave);
+bool allocSlaveWindows(ModbusSlave& slave);
+const char* slaveName(const ModbusSlave& slave);
+const RegDeadband* slaveDeadbands(const ModbusSlave& slave);
+RegField* slaveFields(const ModbusSlave& slave);
+uint16_t* slaveReportedImage(const ModbusSlave& slave);
+uint16_t* slaveLastImage(const ModbusSlave& slave);
+WindowField* slaveWindows(const ModbusSlave& slave);
+SlaveSchedule& slaveSchedule(const ModbusSlave& slave);
+SlaveSampling& slaveSampling(const ModbusSlave& slave);
+SlaveHealth& slaveHealth(const ModbusSlave& slave);
+WindowState& slaveWindowState(const ModbusSlave& slave);
+SlaveReading& slaveReportedReading(const ModbusSlave& slave);
+SlaveReading& slaveLastReading(const ModbusSlave& slave);
@@ -2,294 +2,412 @@
 #include <LittleFS.h>
 #include "MQTTHandler.h"
 #include "ModBusHandler.h"
+#include "ReadPlanner.h"
+#include "PollScheduler.h"
+#include "ResultPublisher.h"
+#include "RegisterMap.h"
+#include "OfflineQueue.h"
+#include "LiveData.h"
+#include "RegisterCache.h"
+#include "WriteQueue.h"
+#include "WindowAggregator.h"
+#include "SlaveTable.h"
+#include "SlaveHealth.h"
+#include "Metrics.h"
+#include "ConfigJournal.h"
+#include "Logger.h"
+#include "WebUi.h"
 #include <Arduino.h>
 
 ESP8266WebServer server(80);
 bool savePending = false;
 bool shouldQuerySlaves = false;
 
-// Serve the main configuration page
+// Serve the main configuration page: web/index.html, gzipped into flash at
+// build time (see tools/embed_web.py). A browser holding the current build's
+// page gets a bodyless 304.
 void handleRoot() {
-  String html = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>Modbus Slave Configuration</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        body { font-family: Arial, sans-serif; margin: 20px; background: #f5f5f5; }
-        .container { max-width: 800px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }
-        .form-group { margin-bottom: 15px; }
-        label { display: block; margin-bottom: 5px; font-weight: bold; }
-        input, button { width: 100%; padding: 8px; margin: 5px 0; border: 1px solid #ddd; border-radius: 4px; }
-        button { background: #007cba; color: white; border: none; cursor: pointer; }
-        button:hover { background: #005a87; }
-        button.delete { background: #dc3545; }
-        button.delete:hover { background: #c82333; }
-        table { width: 100%; border-collapse: collapse; margin-top: 20px; }
-        th, td { border: 1px solid #ddd; padding: 8px; text-align: left; }
-        th { background: #f8f9fa; }
-        .section { margin-bottom: 30px; padding: 15px; border: 1px solid #e9ecef; border-radius: 5px; }
-        .status { padding: 10px; margin: 10px 0; border-radius: 4px; }
-        .success { background: #d4edda; color: #155724; }
-        .error { background: #f8d7da; color: #721c24; }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>Modbus Slave Configuration</h1>
-        
-        <div class="section">
-            <h2>Add New Slave</h2>
-            <form id="addForm">
-                <div class="form-group">
-                    <label>Slave ID:</label>
-                    <input type="number" name="id" min="1" max="247" required>
-                </div>
-                <div class="form-group">
-                    <label>Start Register:</label>
-                    <input type="number" name="startReg" value="0" required>
-                </div>
-                <div class="form-group">
-                    <label>Number of Registers:</label>
-                    <input type="number" name="numRegs" value="2" required>
-                </div>
-                <div class="form-group">
-                    <label>Name:</label>
-                    <input type="text" name="name" placeholder="sensor1" required>
-                </div>
-                <button type="submit">Add Slave</button>
-            </form>
-        </div>
-
-        <div class="section">
-            <h2>Current Slaves</h2>
-            <div id="status"></div>
-            <table>
-                <thead>
-                    <tr>
-                        <th>ID</th>
-                        <th>Name</th>
-                        <th>Start Reg</th>
-                        <th>Num Regs</th>
-                        <th>Actions</th>
-                    </tr>
-                </thead>
-                <tbody id="slavesTable"></tbody>
-            </table>
-        </div>
-
-        <div class="section">
-            <h2>Actions</h2>
-            <button onclick="queryAllSlaves()">Query All Slaves Now</button>
-            <button onclick="saveConfiguration()" style="background: #28a745;">Save Configuration</button>
-            <button onclick="loadConfiguration()" style="background: #17a2b8;">Load Configuration</button>
-        </div>
-    </div>
-
-    <script>
-        let currentSlaves = [];
-
-        // Load slaves on page load
-        window.onload = loadSlaves;
-
-        async function loadSlaves() {
-            try {
-                const response = await fetch('/slaves');
-                currentSlaves = await response.json();
-                updateSlavesTable();
-            } catch (error) {
-                showStatus('Error loading slaves: ' + error, 'error');
-            }
-        }
-
-        function updateSlavesTable() {
-            const tbody = document.getElementById('slavesTable');
-            tbody.innerHTML = '';
-            
-            currentSlaves.forEach(slave => {
-                const row = tbody.insertRow();
-                row.innerHTML = `
-                    <td>${slave.id}</td>
-                    <td>${slave.name}</td>
-                    <td>${slave.startReg}</td>
-                    <td>${slave.numRegs}</td>
-                    <td>
-                        <button class="delete" onclick="deleteSlave(${slave.id})">Delete</button>
-                    </td>
-                `;
-            });
-        }
-
-        // Add slave form handler
-        document.getElementById('addForm').addEventListener('submit', async function(e) {
-            e.preventDefault();
-            
-            const formData = new FormData(this);
-            const newSlave = {
-                id: parseInt(formData.get('id')),
-                startReg: parseInt(formData.get('startReg')),
-                numRegs: parseInt(formData.get('numRegs')),
-                name: formData.get('name')
-            };
-
-            // Validate no duplicate ID
-            if (currentSlaves.some(s => s.id === newSlave.id)) {
-                showStatus('Error: Slave ID already exists!', 'error');
-                return;
-            }
-
-            // Validate no duplicate name
-            if (currentSlaves.some(s => s.name === newSlave.name)) {
-                showStatus('Error: Slave name already exists!', 'error');
-                return;
-            }
-
-            try {
-                const response = await fetch('/addSlave', {
-                    method: 'POST',
-                    headers: { 'Content-Type': 'application/json' },
-                    body: JSON.stringify(newSlave)
-                });
-
-                if (response.ok) {
-                    showStatus('Slave added successfully!', 'success');
-                    this.reset();
-                    await loadSlaves();
-                } else {
-                    showStatus('Error adding slave', 'error');
-                }
-            } catch (error) {
-                showStatus('Error: ' + error, 'error');
-            }
-        });
-
-        async function deleteSlave(id) {
-            if (!confirm('Are you sure you want to delete slave ' + id + '?')) {
-                return;
-            }
-
-            try {
-                const response = await fetch('/deleteSlave?id=' + id, {
-                    method: 'POST'
-                });
-
-                if (response.ok) {
-                    showStatus('Slave deleted successfully!', 'success');
-                    await loadSlaves();
-                } else {
-                    showStatus('Error deleting slave', 'error');
-                }
-            } catch (error) {
-                showStatus('Error: ' + error, 'error');
-            }
-        }
-
-        async function queryAllSlaves() {
-            try {
-                showStatus('Querying slaves...', 'success');
-                const response = await fetch('/querySlaves', { method: 'POST' });
-                if (response.ok) {
-                    showStatus('Slaves queried and data sent to MQTT!', 'success');
-                } else {
-                    showStatus('Error querying slaves', 'error');
-                }
-            } catch (error) {
-                showStatus('Error: ' + error, 'error');
-            }
-        }
-
-        async function saveConfiguration() {
-            try {
-                const response = await fetch('/saveSlaves', { method: 'POST' });
-                if (response.ok) {
-                    showStatus('Configuration saved to flash!', 'success');
-                } else {
-                    showStatus('Error saving configuration', 'error');
-                }
-            } catch (error) {
-                showStatus('Error: ' + error, 'error');
-            }
-        }
-
-        async function loadConfiguration() {
-            try {
-                const response = await fetch('/loadSlaves', { method: 'POST' });
-                if (response.ok) {
-                    showStatus('Configuration loaded from flash!', 'success');
-                    await loadSlaves();
-                } else {
-                    showStatus('Error loading configuration', 'error');
-                }
-            } catch (error) {
-                showStatus('Error: ' + error, 'error');
-            }
-        }
-
-        function showStatus(message, type) {
-            const statusDiv = document.getElementById('status');
-            statusDiv.innerHTML = `<div class="status ${type}">${message}</div>`;
-            setTimeout(() => statusDiv.innerHTML = '', 5000);
-        }
-    </script>
-</body>
-</html>
-)rawliteral";
+  server.sendHeader("ETag", WEB_UI_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");  // always revalidate, usually a 304
+  if (server.header("If-None-Match") == WEB_UI_ETAG) {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)WEB_UI_GZ, WEB_UI_GZ_LEN);  // streamed from flash
+}
+
+// Optional per-slave settings; extra ranges travel as [[start, count], ...]
+static void writeSlaveConfig(JsonObject obj, const ModbusSlave& slave) {
+  if (slave.extraRangeCount > 0) {
+    JsonArray ranges = obj["ranges"].to<JsonArray>();
+    for (uint8_t r = 0; r < slave.extraRangeCount; r++) {
+      JsonArray range = ranges.add<JsonArray>();
+      range.add(slave.extraRanges[r].start);
+      range.add(slave.extraRanges[r].count);
+    }
+  }
+  if (slave.maxGap != DEFAULT_MAX_GAP) obj["maxGap"] = slave.maxGap;
+  obj["pollMs"] = slave.pollMs;
+  if (slave.cacheMs) obj["cacheMs"] = slave.cacheMs;
+  if (slave.fixedRate) obj["fixedRate"] = true;
+  if (slave.windowMs) obj["windowMs"] = slave.windowMs;
+  if (slave.windowRaw) obj["windowRaw"] = true;
+  if (slave.deadband) obj["deadband"] = slave.deadband;
+  if (slave.deadbandPct) obj["deadbandPct"] = slave.deadbandPct;
+  if (slave.regDeadbandCount > 0) {
+    JsonArray deadbands = obj["deadbands"].to<JsonArray>();
+    const RegDeadband* overrides = slaveDeadbands(slave);
+    for (uint8_t i = 0; i < slave.regDeadbandCount; i++) {
+      JsonArray db = deadbands.add<JsonArray>();
+      db.add(overrides[i].reg);
+      db.add(overrides[i].absolute);
+      db.add(overrides[i].percent);
+    }
+  }
+  if (slave.fieldCount > 0) {
+    JsonArray fields = obj["fields"].to<JsonArray>();
+    const RegField* map = slaveFields(slave);
+    for (uint8_t i = 0; i < slave.fieldCount; i++) {
+      const RegField& f = map[i];
+      JsonObject field = fields.add<JsonObject>();
+      field["name"] = fieldName(f.name);
+      field["reg"] = f.reg;
+      field["type"] = fieldTypeName(f.type);
+      if (f.type & FIELD_WORD_SWAP) field["swap"] = true;
+      if (f.scale != 1.0) field["scale"] = f.scale;
+      if (f.offset != 0.0f) field["offset"] = f.offset;
+      field["decimals"] = f.decimals;
+    }
+  }
+}
+
+// Digits needed to show one step of the scale (0.1 -> 1, 0.25 -> 2)
+static uint8_t scaleDecimals(double scale) {
+  uint8_t decimals = 0;
+  double step = fabs(scale);
+  while (decimals < MAX_FIELD_DECIMALS && fabs(step - round(step)) > 1e-6 * max(step, 1.0)) {
+    step *= 10;
+    decimals++;
+  }
+  return decimals;
+}
+
+// "fields": [{"name", "reg", "type", "swap", "scale", "offset", "decimals"}, ...]
+static bool readRegisterMap(JsonObject obj, ModbusSlave& slave) {
+  RegField fields[MAX_FIELDS_PER_SLAVE];
+  uint8_t count = 0;
+  for (JsonObject field : obj["fields"].as<JsonArray>()) {
+    if (count >= MAX_FIELDS_PER_SLAVE) return false;
+    RegField& f = fields[count++];
+    const char* type = field["type"] | "u16";
+    if (!parseFieldType(type, f.type)) return false;
+    if (field["swap"] | false) f.type |= FIELD_WORD_SWAP;
+    f.name = internFieldName(field["name"] | "");
+    if (f.name == FIELD_NAME_NONE) return false;
+    f.reg = field["reg"] | 0;
+    f.scale = field["scale"] | 1.0;
+    f.offset = field["offset"] | 0.0f;
+    // Floats keep three digits unless told otherwise
+    uint8_t decimals = scaleDecimals(f.scale);
+    if ((f.type & FIELD_TYPE_MASK) == FIELD_F32) decimals = max(decimals, (uint8_t)3);
+    f.decimals = min((uint8_t)(field["decimals"] | decimals), (uint8_t)MAX_FIELD_DECIMALS);
+  }
+  return setSlaveFields(slave, fields, count) && compileRegisterMap(slave);
+}
+
+// Read as long so out-of-range JSON numbers fail instead of truncating
+static bool readRegRange(JsonVariant start, JsonVariant count, RegRange& range) {
+  long from = start | 0L;
+  long regs = count | 0L;
+  if (from < 0 || regs < 0 || !regRangeValid(from, regs)) return false;
+  range.start = from;
+  range.count = regs;
+  return true;
+}
+
+// Returns false if the ranges, deadbands or register map don't fit the
+// per-slave limits or the slave table's pools. Call once, on a slave fresh
+// from addSlave().
+static bool readSlaveConfig(JsonObject obj, ModbusSlave& slave) {
+  RegRange primary;
+  if (!readRegRange(obj["startReg"], obj["numRegs"], primary)) return false;
+  slave.startReg = primary.start;
+  slave.numRegs = primary.count;
+  slave.extraRangeCount = 0;
+  slave.maxGap = obj["maxGap"] | DEFAULT_MAX_GAP;
+  slave.pollMs = max((uint32_t)(obj["pollMs"] | DEFAULT_POLL_MS), (uint32_t)MIN_POLL_MS);
+  slave.cacheMs = obj["cacheMs"] | 0UL;
+  slave.fixedRate = obj["fixedRate"] | false;
+  slave.windowMs = obj["windowMs"] | 0UL;
+  if (slave.windowMs) slave.windowMs = min(max(slave.windowMs, (uint32_t)MIN_WINDOW_MS), (uint32_t)MAX_WINDOW_MS);
+  slave.windowRaw = obj["windowRaw"] | false;
+  slaveSchedule(slave) = SlaveSchedule();
+  slaveSchedule(slave).nextPollDue = millis();
+  resetSlaveSampling(slave);
+  resetSlaveReport(slave);
+  slaveLastReading(slave).valid = false;  // the image layout may have changed
+  
+  // Report-by-exception thresholds; "deadbands" is [[reg, counts, percent], ...]
+  slave.deadband = obj["deadband"] | 0;
+  slave.deadbandPct = obj["deadbandPct"] | 0;
+  RegDeadband overrides[MAX_DEADBAND_OVERRIDES];
+  uint8_t overrideCount = 0;
+  for (JsonArray db : obj["deadbands"].as<JsonArray>()) {
+    if (overrideCount >= MAX_DEADBAND_OVERRIDES) return false;
+    RegDeadband& d = overrides[overrideCount++];
+    d.reg = db[0];
+    d.absolute = db[1] | 0;
+    d.percent = db[2] | 0;
+  }
+  if (!setSlaveDeadbands(slave, overrides, overrideCount)) return false;
   
-  server.send(200, "text/html", html);
+  for (JsonArray range : obj["ranges"].as<JsonArray>()) {
+    if (slave.extraRangeCount >= MAX_EXTRA_RANGES) return false;
+    if (!readRegRange(range[0], range[1], slave.extraRanges[slave.extraRangeCount++])) return false;
+  }
+  return slaveRangesValid(slave) && allocSlaveImages(slave) && readRegisterMap(obj, slave) &&
+         allocSlaveWindows(slave);
+}
+
+// Bus settings as exchanged on /bus and /config
+static void writeBusConfig(JsonObject obj, const BusConfig& bus) {
+  obj["baud"] = bus.baud;
+  obj["parity"] = String(bus.parity);
+  obj["stopBits"] = bus.stopBits;
+  obj["turnaroundMs"] = bus.turnaroundMs;
+}
+
+static BusConfig readBusConfig(JsonObject obj) {
+  BusConfig bus;
+  bus.baud = obj["baud"] | (uint32_t)DEFAULT_BAUD;
+  const char* parity = obj["parity"] | "N";
+  bus.parity = parity[0];
+  bus.stopBits = obj["stopBits"] | 1;
+  bus.turnaroundMs = obj["turnaroundMs"] | DEFAULT_TURNAROUND_MS;
+  return bus;
+}
+
+// Publish settings as exchanged on /publish and /config
+static void writePublishConfig(JsonObject obj, const PublishConfig& pub) {
+  obj["perSlave"] = pub.perSlave;
+  obj["prefix"] = pub.prefix;
+  obj["heartbeatMs"] = pub.heartbeatMs;
+  obj["format"] = pub.format == PAYLOAD_MSGPACK ? "msgpack" : "json";
+  obj["batchCount"] = pub.batchCount;
+  obj["batchMs"] = pub.batchMs;
+  obj["batchBytes"] = pub.batchBytes;
+  obj["statsMs"] = pub.statsMs;
+}
+
+// Returns false for an empty/oversized prefix, a zero heartbeat, an unknown
+// format, batch limits out of range or a stats interval under a second
+static bool readPublishConfig(JsonObject obj, PublishConfig& pub) {
+  const char* prefix = obj["prefix"] | "modbus";
+  if (!prefix[0] || strlen(prefix) > MAX_TOPIC_PREFIX) return false;
+  pub.perSlave = obj["perSlave"] | false;
+  strcpy(pub.prefix, prefix);
+  pub.heartbeatMs = obj["heartbeatMs"] | DEFAULT_HEARTBEAT_MS;
+  const char* format = obj["format"] | "json";
+  if (strcmp(format, "msgpack") == 0) pub.format = PAYLOAD_MSGPACK;
+  else if (strcmp(format, "json") == 0) pub.format = PAYLOAD_JSON;
+  else return false;
+  uint32_t batchCount = obj["batchCount"] | 1;
+  uint32_t batchBytes = obj["batchBytes"] | DEFAULT_BATCH_BYTES;
+  pub.batchCount = batchCount;
+  pub.batchMs = obj["batchMs"] | DEFAULT_BATCH_MS;
+  pub.batchBytes = batchBytes;
+  pub.statsMs = obj["statsMs"] | 0UL;
+  return pub.heartbeatMs > 0 && (pub.statsMs == 0 || pub.statsMs >= MIN_STATS_MS) && batchCount >= 1 && batchCount <= MAX_BATCH_COUNT && pub.batchMs > 0 &&
+         batchBytes >= MIN_BATCH_BYTES && batchBytes <= RESULT_ARENA_SIZE;
+}
+
+// Switching modes or topics starts every slave over with a full report
+static void applyPublishConfig(const PublishConfig& pub) {
+  publishConfig = pub;
+  for (uint8_t i = 0; i < slaveCount; i++) resetSlaveReport(slaves[i]);
+}
+
+// A slave as listed on /slaves and /config
+static void writeSlave(JsonObject obj, const ModbusSlave& slave) {
+  obj["id"] = slave.id;
+  obj["name"] = slaveName(slave);
+  obj["startReg"] = slave.startReg;
+  obj["numRegs"] = slave.numRegs;
+  writeSlaveConfig(obj, slave);
+}
+
+static void writeSlaveSchedule(JsonObject obj, const ModbusSlave& slave) {
+  obj["id"] = slave.id;
+  obj["name"] = slaveName(slave);
+  obj["pollMs"] = slave.pollMs;
+  const SlaveSchedule& schedule = slaveSchedule(slave);
+  obj["polls"] = schedule.pollCount;
+  obj["deadlineMisses"] = schedule.deadlineMisses;
+  obj["maxLateMs"] = schedule.maxLateMs;
+  obj["dueInMs"] = max(0L, (long)(schedule.nextPollDue - millis()));
+  obj["fixedRate"] = slave.fixedRate;
+  if (slave.fixedRate) obj["skippedPolls"] = schedule.skippedPolls;
+  obj["jitterMs"] = slaveJitterMicros(slave) / 1000.0;
+  obj["maxJitterMs"] = slaveSampling(slave).maxJitterUs / 1000.0;
+  uint64_t sampledAt = slaveSampleEpochMs(slave);
+  if (sampledAt) obj["sampledAt"] = sampledAt;
+  const SlaveHealth& health = slaveHealth(slave);
+  obj["rttMs"] = health.rttSmooth / 10.0;
+  obj["timeoutMs"] = slaveTimeoutMs(slave);
+  obj["errorPct"] = slaveErrorPercent(slave);
+  obj["breaker"] = health.probeLevel ? "open" : "closed";
+  if (health.probeLevel) obj["probeMs"] = slavePeriodMs(slave);
+}
+
+// Chunked response: head, one object per slave, tail. Each slave gets its
+// own small document, so a full table never needs one big JsonDocument.
+static void sendSlaveArray(const char* head, void (*writeOne)(JsonObject, const ModbusSlave&), const char* tail) {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  String chunk;
+  server.sendContent(head);
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    JsonDocument doc;
+    writeOne(doc.to<JsonObject>(), slaves[i]);
+    serializeJson(doc, chunk);
+    if (i) server.sendContent(",", 1);
+    server.sendContent(chunk);
+  }
+  server.sendContent(tail);
+  server.sendContent("");
 }
 
 // Get slaves as JSON (NON-BLOCKING)
 void handleGetSlaves() {
+  sendSlaveArray("[", writeSlave, "]");
+}
+
+// Per-slave scheduling stats (NON-BLOCKING)
+void handleGetSchedule() {
+  char head[40];
+  snprintf(head, sizeof(head), "{\"busLoadPercent\":%u,\"slaves\":[", scheduleLoadPercent(slaves, slaveCount));
+  sendSlaveArray(head, writeSlaveSchedule, "]}");
+}
+
+// Current bus settings (NON-BLOCKING)
+void handleGetBus() {
   JsonDocument doc;
-  JsonArray arr = doc.to<JsonArray>();
-  
-  for (uint8_t i = 0; i < slaveCount; i++) {
-    JsonObject obj = arr.add<JsonObject>();
-    obj["id"] = slaves[i].id;
-    obj["name"] = slaves[i].name;
-    obj["startReg"] = slaves[i].startReg;
-    obj["numRegs"] = slaves[i].numRegs;
+  writeBusConfig(doc.to<JsonObject>(), busConfig);
+  String output;
+  serializeJson(doc, output);
+  server.send(200, "application/json", output);
+}
+
+// Change bus settings; applied at once, persisted by the next save (NON-BLOCKING)
+void handleSetBus() {
+  if (!server.hasArg("plain")) {
+    server.send(400, "application/json", "{\"error\":\"No data\"}");
+    return;
   }
-  
+  JsonDocument doc;
+  if (deserializeJson(doc, server.arg("plain")) || !doc.is<JsonObject>()) {
+    server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");  // don't fall back to defaults
+    return;
+  }
+  if (!applyBusConfig(readBusConfig(doc.as<JsonObject>()))) {
+    server.send(400, "application/json", "{\"error\":\"Invalid bus settings\"}");
+    return;
+  }
+  server.send(200, "application/json", "{\"status\":\"applied\"}");
+}
+
+// Current publish settings (NON-BLOCKING)
+void handleGetPublish() {
+  JsonDocument doc;
+  writePublishConfig(doc.to<JsonObject>(), publishConfig);
+  doc["reportsPublished"] = reportsPublished;
+  doc["reportsSuppressed"] = reportsSuppressed;
+  JsonObject queue = doc["queue"].to<JsonObject>();
+  queue["bytes"] = queueBytes();
+  queue["queued"] = queueStats.queued;
+  queue["replayed"] = queueStats.replayed;
+  queue["dropped"] = queueStats.dropped;
+  queue["flashWrites"] = queueStats.flashWrites;
+  queue["flashBytes"] = queueStats.flashBytes;
   String output;
   serializeJson(doc, output);
   server.send(200, "application/json", output);
 }
 
+// Change publish settings; applied at once, persisted by the next save (NON-BLOCKING)
+void handleSetPublish() {
+  if (!server.hasArg("plain")) {
+    server.send(400, "application/json", "{\"error\":\"No data\"}");
+    return;
+  }
+  JsonDocument doc;
+  if (deserializeJson(doc, server.arg("plain")) || !doc.is<JsonObject>()) {
+    server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");  // don't fall back to defaults
+    return;
+  }
+  PublishConfig pub;
+  if (!readPublishConfig(doc.as<JsonObject>(), pub)) {
+    server.send(400, "application/json", "{\"error\":\"Invalid publish settings\"}");
+    return;
+  }
+  applyPublishConfig(pub);
+  server.send(200, "application/json", "{\"status\":\"applied\"}");
+}
+
+// Recent log lines from the RAM ring, streamed in small chunks (NON-BLOCKING)
+void handleGetLog() {
+  uint32_t pos = logOldest();
+  uint32_t end = logHead();
+  
+  server.sendHeader("X-Log-Dropped", String(logDroppedBytes()));
+  server.setContentLength(end - pos);
+  server.send(200, "text/plain", "");
+  
+  char chunk[256];
+  while (pos != end) {
+    size_t n = logRead(pos, chunk, min((uint32_t)sizeof(chunk), end - pos));
+    if (n == 0) break;
+    server.sendContent(chunk, n);
+    pos += n;
+  }
+}
+
 // Add new slave (NON-BLOCKING)
 void handleAddSlave() {
   if (server.hasArg("plain")) {
     JsonDocument doc;
     deserializeJson(doc, server.arg("plain"));
     
-    if (slaveCount < MAX_SLAVES) {
-      uint8_t newId = doc["id"];
-      String newName = doc["name"].as<String>();
-      
-      // Check for duplicates
-      for (uint8_t i = 0; i < slaveCount; i++) {
-        if (slaves[i].id == newId) {
-          server.send(400, "application/json", "{\"error\":\"Duplicate ID\"}");
-          return;
-        }
-        if (slaves[i].name == newName) {
-          server.send(400, "application/json", "{\"error\":\"Duplicate name\"}");
-          return;
-        }
-      }
-      
-      slaves[slaveCount].id = newId;
-      slaves[slaveCount].startReg = doc["startReg"];
-      slaves[slaveCount].numRegs = doc["numRegs"];
-      slaves[slaveCount].name = newName;
-      slaveCount++;
-      
-      //requestSaveSlaves(); // Schedule async save
-      server.send(200, "application/json", "{\"status\":\"added\"}");
-    } else {
-      server.send(400, "application/json", "{\"error\":\"Max slaves reached\"}");
+    long newId = doc["id"] | 0L;
+    const char* newName = doc["name"] | "";
+    if (newId < SLAVE_ID_MIN || newId > SLAVE_ID_MAX) {
+      server.send(400, "application/json", "{\"error\":\"ID must be 1-247\"}");
+      return;
     }
+    
+    // Check for duplicates (O(1) for the ID)
+    ModbusSlave* slave = nullptr;
+    switch (addSlave(newId, newName, slave)) {
+      case SLAVE_ERR_ID:
+        server.send(400, "application/json", "{\"error\":\"Duplicate ID\"}");
+        return;
+      case SLAVE_ERR_NAME:
+        server.send(400, "application/json", slaveNameTaken(newName) ? "{\"error\":\"Duplicate name\"}"
+                                                                     : "{\"error\":\"Name too long\"}");
+        return;
+      case SLAVE_ERR_FULL:
+        server.send(400, "application/json", "{\"error\":\"Slave table or name space full\"}");
+        return;
+    }
+    if (!readSlaveConfig(doc.as<JsonObject>(), *slave)) {
+      removeSlave(newId);
+      server.send(400, "application/json", "{\"error\":\"Invalid ranges, deadbands or register map\"}");
+      return;
+    }
+    
+    //requestSaveSlaves(); // Schedule async save
+    server.send(200, "application/json", "{\"status\":\"added\"}");
   } else {
     server.send(400, "application/json", "{\"error\":\"No data\"}");
   }
@@ -298,22 +416,10 @@ void handleAddSlave() {
 // Delete slave (NON-BLOCKING)
 void handleDeleteSlave() {
   if (server.hasArg("id")) {
-    uint8_t delId = server.arg("id").toInt();
-    bool found = false;
+    long delId = server.arg("id").toInt();
     
-    for (uint8_t i = 0; i < slaveCount; i++) {
-      if (slaves[i].id == delId) {
-        // Shift array
-        for (uint8_t j = i; j < slaveCount - 1; j++) {
-          slaves[j] = slaves[j + 1];
-        }
-        slaveCount--;
-        found = true;
-        break;
-      }
-    }
-    
-    if (found) {
+    // Swap-remove; the slave table cancels a poll it would disturb
+    if (delId >= SLAVE_ID_MIN && delId <= SLAVE_ID_MAX && removeSlave(delId)) {
       //requestSaveSlaves(); // Schedule async save
       server.send(200, "application/json", "{\"status\":\"deleted\"}");
     } else {
@@ -324,24 +430,53 @@ void handleDeleteSlave() {
   }
 }
 
-// Trigger slave query (NON-BLOCKING)
+// Trigger a query of the slaves whose cached values are stale (NON-BLOCKING)
 void handleQuerySlaves() {
   shouldQuerySlaves = true;
   server.send(200, "application/json", "{\"status\":\"query_started\"}");
 }
 
-// Save slaves to LittleFS (called async)
+// Save the configuration to the journal (called async)
 void handleSaveSlaves() {
   requestSaveSlaves();
   server.send(200, "application/json", "{\"status\":\"save_scheduled\"}");
 }
 
-// Load slaves from LittleFS (NON-BLOCKING)
+// Back to the saved configuration (NON-BLOCKING)
 void handleLoadSlaves() {
-  loadSlavesFromFS();
+  if (!journalLoad()) {
+    server.send(404, "application/json", "{\"error\":\"No saved configuration\"}");
+    return;
+  }
   server.send(200, "application/json", "{\"status\":\"loaded\"}");
 }
 
+// Whole configuration as one JSON document, for backup or another gateway
+void handleGetConfig() {
+  JsonDocument doc;
+  writeBusConfig(doc["bus"].to<JsonObject>(), busConfig);
+  writePublishConfig(doc["publish"].to<JsonObject>(), publishConfig);
+  doc["slaves"].to<JsonArray>();
+  String head;
+  serializeJson(doc, head);
+  head = head.substring(0, head.length() - 2);  // all but the closing "]}"
+  sendSlaveArray(head.c_str(), writeSlave, "]}");
+}
+
+// Replaces the configuration with a /config document; kept until the next
+// save like any other change
+void handleSetConfig() {
+  JsonDocument doc;
+  if (deserializeJson(doc, server.arg("plain")) || !doc.is<JsonObject>()) {
+    server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    return;
+  }
+  uint16_t skipped = importConfigJson(doc);
+  char reply[64];
+  snprintf(reply, sizeof(reply), "{\"status\":\"imported\",\"slaves\":%u,\"skipped\":%u}", slaveCount, skipped);
+  server.send(200, "application/json", reply);
+}
+
 
 // Schedule save for main loop (NON-BLOCKING)
 void requestSaveSlaves() {
@@ -351,29 +486,50 @@ void requestSaveSlaves() {
 // Process pending saves in main loop
 void processPendingSaves() {
   if (savePending) {
-    saveSlavesToFS();
+    journalSave();
     savePending = false;
   }
 }
 
+// A route whose handler time is recorded in webHist
+static void route(const char* uri, HTTPMethod method, void (*handler)()) {
+  server.on(uri, method, [handler]() {
+    uint32_t start = micros();
+    handler();
+    histogramAdd(webHist, micros() - start);
+  });
+}
+
 void setupWebServer() {
-  // ✅ LITTLEFS INITIALIZATION (already done in main, but safe to call again)
-  LittleFS.begin();
-  
-  // Load existing configuration
-  loadSlavesFromFS();
-  
+  // Conditional GET of the page needs the request's If-None-Match
+  static const char* headerKeys[] = {"If-None-Match"};
+  server.collectHeaders(headerKeys, 1);
+
   // Setup web server routes
-  server.on("/", HTTP_GET, handleRoot);
-  server.on("/slaves", HTTP_GET, handleGetSlaves);
-  server.on("/addSlave", HTTP_POST, handleAddSlave);
-  server.on("/deleteSlave", HTTP_POST, handleDeleteSlave);
-  server.on("/querySlaves", HTTP_POST, handleQuerySlaves);
-  server.on("/saveSlaves", HTTP_POST, handleSaveSlaves);
-  server.on("/loadSlaves", HTTP_POST, handleLoadSlaves);
+  route("/", HTTP_GET, handleRoot);
+  route("/slaves", HTTP_GET, handleGetSlaves);
+  route("/schedule", HTTP_GET, handleGetSchedule);
+  route("/log", HTTP_GET, handleGetLog);
+  route("/data", HTTP_GET, handleGetData);
+  route("/read", HTTP_GET, handleRead);
+  route("/write", HTTP_GET, handleGetWrite);
+  route("/write", HTTP_POST, handleWrite);
+  route("/events", HTTP_GET, handleEvents);
+  route("/metrics", HTTP_GET, handleMetrics);
+  route("/bus", HTTP_GET, handleGetBus);
+  route("/bus", HTTP_POST, handleSetBus);
+  route("/publish", HTTP_GET, handleGetPublish);
+  route("/publish", HTTP_POST, handleSetPublish);
+  route("/addSlave", HTTP_POST, handleAddSlave);
+  route("/deleteSlave", HTTP_POST, handleDeleteSlave);
+  route("/querySlaves", HTTP_POST, handleQuerySlaves);
+  route("/saveSlaves", HTTP_POST, handleSaveSlaves);
+  route("/loadSlaves", HTTP_POST, handleLoadSlaves);
+  route("/config", HTTP_GET, handleGetConfig);
+  route("/config", HTTP_POST, handleSetConfig);
   
   server.begin();
-  Serial.println("✅ HTTP server started");
+  LOG_INFO("✅ HTTP server started");
 }
 
 // Handle web client in main loop
@@ -381,57 +537,53 @@ void handleWebServer() {
   server.handleClient();
 }
 
-// Save slaves configuration to LittleFS
-void saveSlavesToFS() {
-  JsonDocument doc;
-  JsonArray arr = doc.to<JsonArray>();
-  
-  for (uint8_t i = 0; i < slaveCount; i++) {
-    JsonObject obj = arr.add<JsonObject>();
-    obj["id"] = slaves[i].id;
-    obj["startReg"] = slaves[i].startReg;
-    obj["numRegs"] = slaves[i].numRegs;
-    obj["name"] = slaves[i].name;
+// Applies a /config document (or a legacy /slaves.json) to the running
+// gateway; returns how many slaves were skipped
+uint16_t importConfigJson(JsonDocument& doc) {
+  clearSlaves();
+
+  // Older files hold just the slave array and no bus settings
+  JsonArray arr = doc.is<JsonArray>() ? doc.as<JsonArray>() : doc["slaves"].as<JsonArray>();
+  if (!doc["bus"].isNull() && !applyBusConfig(readBusConfig(doc["bus"].as<JsonObject>()))) {
+    LOG_WARN("⚠️ Imported bus settings are invalid, keeping current ones");
   }
-  
-  // ✅ LITTLEFS WRITE OPERATION
-  File file = LittleFS.open("/slaves.json", "w");
-  if (file) {
-    serializeJson(doc, file);
-    file.close();
-    Serial.println("✅ Slaves saved to LittleFS");
-  } else {
-    Serial.println("❌ Failed to save slaves to LittleFS");
+  PublishConfig pub;
+  if (!doc["publish"].isNull() && readPublishConfig(doc["publish"].as<JsonObject>(), pub)) {
+    publishConfig = pub;
   }
+  uint16_t skipped = 0;
+  for (JsonObject obj : arr) {
+    ModbusSlave* slave = nullptr;
+    long id = obj["id"] | 0L;
+    if (id < SLAVE_ID_MIN || id > SLAVE_ID_MAX || addSlave(id, obj["name"] | "", slave) != SLAVE_OK) {
+      LOG_WARN("⚠️ Slave %ld skipped (bad or duplicate ID/name, or table full)", id);
+      skipped++;
+      continue;
+    }
+    if (!readSlaveConfig(obj, *slave)) {
+      removeSlave(id);
+      skipped++;
+    }
+  }
+  return skipped;
 }
 
-// Load slaves configuration from LittleFS
-void loadSlavesFromFS() {
-  // ✅ LITTLEFS READ OPERATION
-  if (LittleFS.exists("/slaves.json")) {
-    File file = LittleFS.open("/slaves.json", "r");
-    if (file) {
-      JsonDocument doc;
-      deserializeJson(doc, file);
-      file.close();
-      
-      slaveCount = 0;
-      JsonArray arr = doc.as<JsonArray>();
-      for (JsonObject obj : arr) {
-        if (slaveCount < MAX_SLAVES) {
-          slaves[slaveCount].id = obj["id"];
-          slaves[slaveCount].startReg = obj["startReg"];
-          slaves[slaveCount].numRegs = obj["numRegs"];
-          slaves[slaveCount].name = obj["name"].as<String>();
-          slaveCount++;
-        }
-      }
-      Serial.println("✅ Slaves loaded from LittleFS");
-      Serial.print("Loaded ");
-      Serial.print(slaveCount);
-      Serial.println(" slaves");
-    }
-  } else {
-    Serial.println("⚠️ No saved slaves configuration found");
+// One-time migration: the JSON file earlier firmware saved to. Once it is in
+// the journal it's left alone.
+bool loadLegacyConfig() {
+  File file = LittleFS.open(LEGACY_CONFIG_PATH, "r");
+  if (!file) {
+    LOG_WARN("⚠️ No saved slaves configuration found");
+    return false;
   }
-}
\ No newline at end of file
+  JsonDocument doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  if (err) {
+    LOG_ERROR("❌ %s is not valid JSON", LEGACY_CONFIG_PATH);
+    return false;
+  }
+  importConfigJson(doc);
+  LOG_INFO("✅ Slaves loaded from %s: %u slaves", LEGACY_CONFIG_PATH, slaveCount);
+  return true;
+}
@@ -3,6 +3,7 @@
 #include <ArduinoJson.h>
 #include "ModBusHandler.h"
 
+#define LEGACY_CONFIG_PATH "/slaves.json"   // JSON configuration before ConfigJournal
 
 // Global variables
 extern ESP8266WebServer server;
@@ -14,9 +15,17 @@ void setupWebServer();
 void handleWebServer();
 void handleRoot();
 void handleGetSlaves();
+void handleGetSchedule();
+void handleGetLog();
+void handleGetBus();
+void handleSetBus();
+void handleGetPublish();
+void handleSetPublish();
 void handleAddSlave();
 void handleDeleteSlave();
-void saveSlavesToFS();
-void loadSlavesFromFS();
+void handleGetConfig();
+void handleSetConfig();
+uint16_t importConfigJson(JsonDocument& doc);
+bool loadLegacyConfig();
 void processPendingSaves();
 void requestSaveSlaves();
\ No newline at end of file
@@ -0,0 +1,293 @@
+#pragma once
+// Generated from web/index.html by tools/embed_web.py - do not edit.
+#include <Arduino.h>
+
+#define WEB_UI_ETAG "\"9b615739fcddc9db\""
+#define WEB_UI_GZ_LEN 4537  // 21280 bytes uncompressed
+
+static const uint8_t WEB_UI_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xdd, 0x1c, 0x6b, 0x73, 0xdb, 0xb8,
+  0xf1, 0x7b, 0x7e, 0x05, 0x4e, 0xf7, 0x10, 0xd5, 0xca, 0xd4, 0xc3, 0xd6, 0xd9, 0x27, 0x5b, 0xba,
+  0x49, 0x62, 0xa7, 0x4d, 0x27, 0x4e, 0xdc, 0xd8, 0xd3, 0x4e, 0xc7, 0xe3, 0x99, 0x83, 0x48, 0x48,
+  0x62, 0xcd, 0xd7, 0x11, 0xa0, 0x65, 0x8d, 0xcf, 0xff, 0xbd, 0xbb, 0x00, 0x49, 0xf1, 0x01, 0x4a,
+  0xb2, 0x62, 0x67, 0x72, 0x75, 0x1e, 0x12, 0x01, 0xec, 0x62, 0x5f, 0xd8, 0x5d, 0x2c, 0x40, 0x9f,
+  0x7c, 0x77, 0xfa, 0xe9, 0xed, 0xd5, 0x7f, 0x2e, 0xce, 0xc8, 0x5c, 0x78, 0xee, 0xf8, 0xd5, 0x49,
+  0xfa, 0xc1, 0xa8, 0x3d, 0x7e, 0x45, 0xe0, 0xe7, 0x44, 0x38, 0xc2, 0x65, 0xe3, 0xf3, 0xc0, 0x9e,
+  0xc4, 0x9c, 0x5c, 0xba, 0xf4, 0x8e, 0x91, 0xb7, 0x81, 0x3f, 0x75, 0x66, 0x71, 0x44, 0x85, 0x13,
+  0xf8, 0x27, 0x1d, 0x35, 0x42, 0x8d, 0xf6, 0x98, 0xa0, 0xc4, 0xa7, 0x1e, 0x1b, 0x35, 0xee, 0x1c,
+  0xb6, 0x08, 0x83, 0x48, 0x34, 0x88, 0x15, 0xf8, 0x82, 0xf9, 0x62, 0xd4, 0x58, 0x38, 0xb6, 0x98,
+  0x8f, 0x6c, 0x76, 0xe7, 0x58, 0x6c, 0x4f, 0x3e, 0xb4, 0x89, 0xe3, 0x3b, 0xc2, 0xa1, 0xee, 0x1e,
+  0xb7, 0xa8, 0xcb, 0x46, 0xbd, 0x46, 0x82, 0x88, 0x8b, 0x65, 0x8a, 0x14, 0x7f, 0x26, 0x81, 0xbd,
+  0x24, 0x0f, 0x64, 0x0a, 0x98, 0xf6, 0xa6, 0xd4, 0x73, 0xdc, 0xe5, 0x90, 0xbc, 0x8e, 0x00, 0xae,
+  0x4d, 0x38, 0xf5, 0xf9, 0x1e, 0x67, 0x91, 0x33, 0x3d, 0x26, 0x1e, 0x8d, 0x66, 0x8e, 0x3f, 0x24,
+  0xfd, 0x6e, 0x78, 0x7f, 0x4c, 0x26, 0xd4, 0xba, 0x9d, 0x45, 0x41, 0xec, 0xdb, 0x43, 0xf2, 0xfd,
+  0x74, 0x80, 0x7f, 0x8e, 0xc9, 0x63, 0x86, 0xd3, 0x44, 0xba, 0xa8, 0xe3, 0xb3, 0x08, 0x30, 0x7b,
+  0xf4, 0x5e, 0x51, 0x34, 0x24, 0x47, 0x5d, 0x09, 0x9d, 0xe2, 0xea, 0x12, 0x1a, 0x8b, 0xa0, 0x88,
+  0x6d, 0x31, 0x77, 0x04, 0x3b, 0x26, 0x21, 0xb5, 0x6d, 0xc7, 0x9f, 0x65, 0xf3, 0x05, 0x91, 0xcd,
+  0xa2, 0xbd, 0x88, 0xda, 0x4e, 0xcc, 0x87, 0xa4, 0x97, 0x34, 0xde, 0xef, 0xf1, 0x39, 0xb5, 0x83,
+  0x05, 0xa2, 0xea, 0x87, 0xf7, 0xb2, 0x9d, 0x44, 0xb3, 0x09, 0x35, 0xba, 0x6d, 0xf9, 0xc7, 0xec,
+  0xb5, 0x0a, 0x74, 0x4d, 0x83, 0xc8, 0xdb, 0xc3, 0xa9, 0x42, 0x49, 0x18, 0x92, 0xb1, 0x37, 0x09,
+  0x84, 0x08, 0x3c, 0x40, 0x3a, 0x40, 0xa4, 0xab, 0xc1, 0x2e, 0x9d, 0x30, 0x17, 0x86, 0xd9, 0x0e,
+  0x0f, 0x5d, 0x0a, 0x52, 0x99, 0xb8, 0x81, 0x75, 0x7b, 0x5c, 0x06, 0x93, 0x50, 0x52, 0x7a, 0x0b,
+  0xe6, 0xcc, 0xe6, 0x02, 0xc6, 0x05, 0xae, 0x9d, 0x47, 0xe4, 0xf8, 0x61, 0x2c, 0x40, 0x9a, 0xcc,
+  0x65, 0x16, 0x7c, 0x4e, 0x62, 0x00, 0xf4, 0x01, 0x71, 0x22, 0x94, 0x5e, 0xb7, 0xfb, 0x63, 0x8e,
+  0xe1, 0xa3, 0xbc, 0x84, 0x00, 0x39, 0xe9, 0xa6, 0xec, 0xc3, 0x50, 0x78, 0xe4, 0x81, 0xeb, 0xd8,
+  0xe4, 0x7b, 0xdb, 0xb6, 0x2b, 0x62, 0x39, 0x28, 0x32, 0x90, 0x4d, 0x54, 0xd0, 0x56, 0xb7, 0x7b,
+  0x68, 0x4d, 0xe8, 0x31, 0x98, 0x8e, 0x1b, 0x44, 0x99, 0xbc, 0xd3, 0x19, 0xfc, 0xc0, 0x87, 0x27,
+  0x2b, 0x8e, 0x38, 0x76, 0x86, 0x81, 0x03, 0xf6, 0x15, 0x55, 0x91, 0x0e, 0xe7, 0xc1, 0x9d, 0x54,
+  0x6e, 0x09, 0xf5, 0x80, 0x1e, 0x1d, 0x56, 0x47, 0x9b, 0x36, 0xb0, 0x2e, 0x58, 0x79, 0xb8, 0x6d,
+  0xed, 0x0f, 0x0e, 0x06, 0xb5, 0xc3, 0xf5, 0x73, 0x58, 0x47, 0xfd, 0xfd, 0xfd, 0xfd, 0x3c, 0x90,
+  0xa0, 0x13, 0x97, 0x95, 0xc5, 0x99, 0x48, 0x06, 0x98, 0x74, 0x69, 0xc8, 0xd9, 0x90, 0xa4, 0xdf,
+  0x32, 0xfd, 0x89, 0x20, 0x4c, 0xad, 0x2b, 0x87, 0x0b, 0x96, 0x8d, 0xb0, 0x71, 0xce, 0x1a, 0x89,
+  0x17, 0xd5, 0x24, 0xd8, 0xbd, 0xd8, 0xa3, 0xae, 0x33, 0x03, 0x55, 0xb9, 0x6c, 0x2a, 0x8a, 0xa8,
+  0xca, 0xa4, 0x4f, 0x8f, 0xa6, 0xbf, 0x4c, 0x69, 0xc1, 0x1e, 0x39, 0x58, 0x84, 0x23, 0x75, 0x54,
+  0xb2, 0xaa, 0x7d, 0x49, 0x58, 0x36, 0x9b, 0xb2, 0x4d, 0x0d, 0x51, 0xec, 0x17, 0x66, 0xb1, 0x69,
+  0xc5, 0x12, 0x4a, 0xa6, 0x6c, 0x72, 0x41, 0x05, 0x38, 0x99, 0x87, 0x1c, 0xc6, 0xc2, 0x4a, 0x94,
+  0x0b, 0xa7, 0xbb, 0xc9, 0xa0, 0x4c, 0x1e, 0x5b, 0x16, 0xe3, 0xbc, 0xa2, 0xc8, 0x03, 0x66, 0xdb,
+  0x2b, 0x93, 0xfa, 0xbe, 0x37, 0x18, 0x1c, 0xf6, 0x0f, 0x0a, 0x90, 0x2c, 0x8a, 0x82, 0xa8, 0x2a,
+  0x10, 0xfb, 0x30, 0x0f, 0x77, 0xd8, 0xef, 0x59, 0x2b, 0xb8, 0x93, 0x4e, 0xe2, 0xa9, 0x4e, 0x3a,
+  0xca, 0x69, 0x9e, 0xa0, 0xab, 0x4a, 0x9c, 0x98, 0xed, 0xdc, 0x11, 0xcb, 0xa5, 0x9c, 0x8f, 0x1a,
+  0x99, 0xaf, 0x69, 0xac, 0x9c, 0xda, 0xc9, 0xbc, 0xb7, 0xd6, 0xb1, 0x42, 0x77, 0x36, 0x76, 0x05,
+  0x94, 0x43, 0x9a, 0x28, 0x26, 0x87, 0x52, 0xa1, 0xed, 0x8f, 0x5f, 0xdb, 0x36, 0xf9, 0xc8, 0x16,
+  0x0a, 0x2f, 0x60, 0xea, 0x97, 0x86, 0xa0, 0x8b, 0x21, 0x8e, 0x3d, 0x6a, 0x80, 0xa4, 0xdf, 0xc1,
+  0xf7, 0x12, 0x8a, 0xf2, 0x44, 0x2b, 0x8f, 0xa4, 0x19, 0x28, 0x07, 0x4b, 0x3f, 0x34, 0x56, 0x6c,
+  0xbc, 0x3f, 0x1d, 0x9e, 0x74, 0x54, 0x83, 0x7e, 0xb0, 0xf4, 0x35, 0x44, 0x2c, 0x43, 0x08, 0x13,
+  0x7e, 0xec, 0x4d, 0x40, 0x2a, 0x49, 0xd0, 0x70, 0xec, 0x06, 0xf1, 0x1c, 0x7f, 0xd4, 0xe8, 0x35,
+  0xd0, 0x25, 0x8f, 0x1a, 0xfd, 0x83, 0xc3, 0x06, 0x89, 0xd8, 0xef, 0xb1, 0x13, 0x31, 0x5b, 0x43,
+  0x64, 0x07, 0xa8, 0x7c, 0x26, 0xda, 0x05, 0x8d, 0x04, 0xf9, 0xcc, 0x66, 0x0e, 0x07, 0x6f, 0xb2,
+  0x33, 0x07, 0x1c, 0xd1, 0x00, 0x96, 0x06, 0xb9, 0xa3, 0x6e, 0x0c, 0x0d, 0xdd, 0xaf, 0x44, 0xff,
+  0x47, 0x49, 0x06, 0x09, 0xa6, 0x19, 0x0f, 0x7c, 0x67, 0x26, 0xe0, 0x09, 0x90, 0xf0, 0x8c, 0x87,
+  0xfe, 0x57, 0xe2, 0xe1, 0x02, 0xfc, 0x1f, 0x79, 0x8f, 0xde, 0x1c, 0x26, 0x26, 0x86, 0xc7, 0x5b,
+  0x3b, 0xb3, 0x10, 0x02, 0xaa, 0xf3, 0x15, 0x07, 0xfb, 0xdd, 0x6e, 0x37, 0x35, 0xad, 0xee, 0xd7,
+  0x52, 0xc9, 0x5b, 0x6a, 0xcd, 0x19, 0x39, 0xa7, 0xf7, 0xe4, 0xf5, 0x8c, 0x21, 0x3b, 0x6d, 0x12,
+  0x84, 0xb8, 0x62, 0x31, 0x6f, 0xb1, 0xd9, 0x94, 0xc6, 0xae, 0x20, 0x3d, 0x73, 0x40, 0x7e, 0x12,
+  0x8e, 0xc7, 0x38, 0xb8, 0x52, 0xe4, 0xdf, 0x49, 0xf8, 0xdf, 0x9d, 0x77, 0x0b, 0xe7, 0x45, 0xe6,
+  0x25, 0xbf, 0xc0, 0x2d, 0xa4, 0x06, 0x16, 0x9b, 0x43, 0xc4, 0x67, 0xd1, 0xa8, 0x71, 0x30, 0x00,
+  0x01, 0xbc, 0x28, 0xdf, 0x05, 0xd2, 0x80, 0x14, 0xeb, 0x16, 0xb2, 0xa0, 0x94, 0xb8, 0xa9, 0x73,
+  0xcf, 0xec, 0xcf, 0x54, 0xb0, 0xc6, 0x98, 0xbc, 0xc3, 0xef, 0x04, 0xfc, 0x1d, 0x48, 0x87, 0xdd,
+  0x31, 0xdf, 0x5d, 0x12, 0x1e, 0x02, 0xa9, 0x36, 0x64, 0x75, 0x5e, 0xe8, 0x32, 0xde, 0xaa, 0x15,
+  0xc1, 0x73, 0xae, 0xfc, 0xd8, 0x83, 0x10, 0xb3, 0x24, 0xff, 0x76, 0x7c, 0x48, 0xd3, 0x8a, 0x7a,
+  0x82, 0xf4, 0x22, 0x9e, 0xb8, 0x0e, 0x9f, 0xa3, 0x2c, 0x3b, 0xe0, 0x92, 0x3a, 0x1e, 0xa3, 0x3e,
+  0x10, 0xc5, 0x05, 0x28, 0x0a, 0x56, 0x19, 0xb5, 0x71, 0xc9, 0x01, 0xf1, 0x80, 0x00, 0xd5, 0xb7,
+  0xbb, 0xd6, 0x16, 0x72, 0xfa, 0x4c, 0x6d, 0x3d, 0x69, 0xb1, 0x05, 0xcd, 0xfd, 0xdc, 0xed, 0x6a,
+  0x55, 0xb7, 0xad, 0xe8, 0xd5, 0x0c, 0x9f, 0xe9, 0x02, 0x44, 0x7f, 0x91, 0xb0, 0xb5, 0xa2, 0x9c,
+  0x50, 0x4e, 0x16, 0xcc, 0x75, 0xbf, 0x86, 0xc8, 0x4f, 0x41, 0x6e, 0x13, 0xea, 0xdb, 0xc4, 0x88,
+  0xe8, 0x02, 0x42, 0x6b, 0xec, 0x0b, 0x4e, 0x3a, 0xe4, 0xc7, 0x36, 0x09, 0x21, 0xb2, 0x73, 0x19,
+  0x46, 0x20, 0xf7, 0x71, 0x2c, 0x4e, 0x02, 0xb0, 0x8a, 0xa7, 0x08, 0x15, 0xd3, 0x9d, 0x94, 0x61,
+  0x3b, 0x99, 0xa6, 0x24, 0xc7, 0x01, 0x81, 0x30, 0x3f, 0xe8, 0xf4, 0xf1, 0xa3, 0xd3, 0x7f, 0xd9,
+  0xb5, 0x70, 0x76, 0x2f, 0x22, 0x4a, 0x3e, 0x53, 0x7f, 0xc6, 0x38, 0x31, 0x64, 0x74, 0x18, 0x4a,
+  0x7e, 0x57, 0x36, 0xb6, 0x2b, 0x77, 0x91, 0x44, 0x5a, 0xe2, 0xad, 0xd7, 0x1d, 0x1e, 0xb4, 0xc9,
+  0x41, 0x77, 0xf8, 0xc2, 0x7c, 0xa5, 0x41, 0x06, 0xdc, 0x5b, 0x48, 0x8c, 0x7f, 0x5c, 0x7e, 0xfa,
+  0xf8, 0xe5, 0x0c, 0x4d, 0x1d, 0xe6, 0xda, 0x25, 0x86, 0x9a, 0xd7, 0x0f, 0x0d, 0xec, 0x6d, 0x0c,
+  0x1b, 0x77, 0x81, 0x2b, 0xe8, 0x8c, 0x35, 0xda, 0x8d, 0x08, 0xe2, 0xeb, 0xb0, 0xdb, 0x6e, 0x20,
+  0x0a, 0xe8, 0x98, 0xee, 0xf7, 0xa1, 0x91, 0x2f, 0x68, 0xd8, 0x18, 0x8a, 0x28, 0x66, 0x8f, 0x6d,
+  0x92, 0x01, 0x31, 0xc8, 0xb9, 0x66, 0xcb, 0x14, 0xa6, 0x9f, 0xc1, 0xc4, 0x0a, 0x06, 0x77, 0x9d,
+  0x80, 0xca, 0xec, 0xf6, 0x1e, 0x6f, 0x9a, 0x2f, 0x1b, 0x9f, 0x81, 0x9e, 0x1d, 0xe5, 0x22, 0x59,
+  0x29, 0xaa, 0x99, 0x33, 0x1f, 0x36, 0x3f, 0xbd, 0x5d, 0x02, 0x59, 0xb2, 0xe3, 0x52, 0xd3, 0xf0,
+  0x78, 0xe2, 0x39, 0xa2, 0x21, 0x13, 0xc6, 0x24, 0x59, 0x54, 0xfd, 0xa5, 0x84, 0xb1, 0x83, 0x6c,
+  0xe6, 0x52, 0x57, 0x85, 0xfb, 0x89, 0x59, 0xe9, 0x1b, 0xcc, 0x74, 0x99, 0x10, 0x90, 0xdb, 0xf3,
+  0x75, 0x49, 0x29, 0x64, 0xc4, 0xcf, 0x98, 0x94, 0xbe, 0xa1, 0xb1, 0x4d, 0x30, 0xe0, 0x6c, 0x90,
+  0xbe, 0xda, 0xfa, 0x26, 0x22, 0x9f, 0x00, 0x50, 0x0d, 0x5a, 0x39, 0x58, 0x99, 0xfa, 0xf8, 0xe0,
+  0xa8, 0xdb, 0x3d, 0xe9, 0x24, 0x0f, 0x69, 0xe3, 0x2f, 0x3f, 0x6b, 0x1a, 0x7b, 0xbf, 0xf4, 0x73,
+  0xad, 0x1b, 0x11, 0xef, 0x1f, 0x1d, 0x68, 0x90, 0x0c, 0x0e, 0xb5, 0xa8, 0x7b, 0x83, 0x8d, 0xb8,
+  0x61, 0x9f, 0x22, 0xd9, 0x7b, 0xd9, 0xf4, 0x8d, 0x46, 0x8e, 0x58, 0x82, 0x1f, 0xbf, 0x04, 0xdf,
+  0x4d, 0xde, 0x38, 0x82, 0x3f, 0x45, 0xe4, 0x38, 0x0b, 0x15, 0x9b, 0x85, 0x9e, 0xa6, 0x74, 0x1f,
+  0x7b, 0x8d, 0xf1, 0xd1, 0xc7, 0x5e, 0x59, 0x1c, 0x59, 0x77, 0x1f, 0xbb, 0xfb, 0x5b, 0x8b, 0x3c,
+  0x85, 0x3b, 0x43, 0xb4, 0x67, 0xb5, 0x68, 0x3f, 0x61, 0xf7, 0xa7, 0xde, 0x37, 0x20, 0x6d, 0xb5,
+  0xd9, 0xba, 0x8a, 0x23, 0x9f, 0xca, 0xbd, 0x2a, 0xb9, 0x82, 0x24, 0x32, 0x00, 0x07, 0xf2, 0x45,
+  0x79, 0xb3, 0xc8, 0xf0, 0xe5, 0x32, 0x91, 0x64, 0x33, 0x36, 0xe8, 0xee, 0x96, 0x3a, 0xeb, 0x3d,
+  0x4e, 0x18, 0x42, 0xba, 0x57, 0x74, 0x09, 0x2f, 0xe7, 0x7a, 0x92, 0x74, 0x07, 0xa6, 0x59, 0xe7,
+  0x78, 0x92, 0x5c, 0xef, 0x19, 0x9d, 0x0f, 0xec, 0xef, 0x9f, 0xe4, 0x77, 0x20, 0xfd, 0x91, 0x7a,
+  0xdd, 0x7e, 0x19, 0x40, 0x42, 0x78, 0x96, 0xe5, 0x70, 0x6d, 0x42, 0x21, 0x91, 0x93, 0xf9, 0x13,
+  0x66, 0x4e, 0xf0, 0x37, 0xc9, 0xa3, 0x9e, 0xbc, 0x0c, 0xc0, 0xcc, 0x2f, 0x4a, 0xa9, 0x58, 0x9b,
+  0x58, 0x73, 0x95, 0xc7, 0x60, 0x4e, 0xf6, 0x4d, 0xf8, 0x9b, 0xa5, 0x1b, 0x40, 0x02, 0xfe, 0x4e,
+  0x7a, 0x8e, 0x97, 0xf4, 0x35, 0xff, 0xe5, 0x68, 0x55, 0x98, 0xe5, 0x3c, 0x59, 0x90, 0x1e, 0x9f,
+  0xc1, 0x96, 0xe6, 0xb6, 0x31, 0x3e, 0x67, 0x9c, 0x43, 0xfa, 0x72, 0x01, 0x0f, 0xc4, 0x98, 0x38,
+  0xb0, 0xca, 0x96, 0x58, 0x6f, 0x65, 0xe4, 0x23, 0xd8, 0xc8, 0xde, 0xe7, 0xb3, 0x53, 0xd8, 0x12,
+  0x5a, 0xf0, 0x35, 0x6a, 0x7d, 0x03, 0xa2, 0xbd, 0x42, 0x8d, 0x93, 0x8b, 0x88, 0xc1, 0x76, 0x8d,
+  0x18, 0xab, 0xa4, 0xdc, 0x03, 0x02, 0x77, 0x4d, 0xef, 0x42, 0x89, 0x4d, 0xfa, 0x12, 0x97, 0xf9,
+  0x33, 0x31, 0x87, 0x6d, 0xf9, 0x0b, 0x67, 0xa9, 0x7f, 0x67, 0x90, 0x6f, 0x4f, 0x18, 0x05, 0xa7,
+  0xf8, 0x05, 0x3e, 0x71, 0x9e, 0x62, 0xb9, 0xcc, 0xaa, 0x53, 0x2f, 0x4a, 0xf5, 0x1b, 0x2a, 0xac,
+  0x39, 0x31, 0x60, 0xf1, 0xee, 0xc9, 0x95, 0x97, 0x48, 0x5d, 0xae, 0x70, 0xdc, 0x26, 0x81, 0x00,
+  0xc9, 0x82, 0x3a, 0x82, 0x78, 0xe9, 0xd3, 0x64, 0x29, 0x18, 0xdf, 0x51, 0x2d, 0x13, 0x9c, 0xad,
+  0xbc, 0x8b, 0x20, 0x23, 0xd8, 0xd6, 0x4e, 0xdb, 0x84, 0x99, 0x33, 0x93, 0xf4, 0xbb, 0x30, 0x0d,
+  0xee, 0x47, 0xe5, 0x47, 0xff, 0xe0, 0x65, 0xb9, 0xff, 0x1b, 0xa4, 0x6a, 0x0b, 0xba, 0x24, 0x58,
+  0x0e, 0x96, 0x4e, 0xec, 0x27, 0x57, 0x1c, 0x2b, 0xdb, 0xf9, 0x69, 0x26, 0x8e, 0x3b, 0xaa, 0x5d,
+  0xed, 0x5b, 0x0d, 0x70, 0x4a, 0x5d, 0x45, 0x6b, 0xeb, 0x4b, 0x4a, 0x76, 0x82, 0x5f, 0x66, 0xd5,
+  0x92, 0x67, 0x89, 0x6b, 0xf9, 0x78, 0xf3, 0x72, 0x51, 0xed, 0x6d, 0x1c, 0x45, 0xcc, 0x17, 0x2a,
+  0x73, 0xd7, 0xa5, 0xd4, 0x88, 0x05, 0x03, 0x9b, 0x2a, 0xad, 0x37, 0xc6, 0x1a, 0x4e, 0x4e, 0xe4,
+  0xd1, 0x84, 0x86, 0x3b, 0xb1, 0x3a, 0x05, 0xac, 0xf6, 0x45, 0x6b, 0xfc, 0x9f, 0x98, 0x8f, 0xdf,
+  0x9f, 0x9e, 0x74, 0xe0, 0x63, 0xed, 0x18, 0xdc, 0x10, 0x6d, 0x1e, 0x95, 0x95, 0x65, 0xb7, 0x40,
+  0x18, 0x7b, 0x38, 0x90, 0x6f, 0x1e, 0x99, 0xdf, 0x94, 0x6f, 0x1e, 0x2d, 0xab, 0x92, 0x98, 0x54,
+  0x6d, 0x1e, 0x9a, 0xd6, 0x35, 0x36, 0x8f, 0x7c, 0x27, 0xf7, 0xba, 0x9b, 0xc7, 0xbd, 0x96, 0xba,
+  0x5f, 0x33, 0x10, 0x7a, 0x22, 0x9d, 0xc9, 0xd6, 0xa8, 0xef, 0x44, 0xc8, 0xb3, 0x54, 0x69, 0x14,
+  0xd2, 0x6a, 0xae, 0x50, 0xfd, 0x68, 0x19, 0x62, 0x75, 0x72, 0x91, 0xc3, 0x52, 0x34, 0x8e, 0xdd,
+  0xcc, 0xf4, 0x83, 0x03, 0x91, 0xe3, 0x94, 0x0a, 0xaa, 0xb1, 0xd0, 0x6f, 0xdb, 0xfa, 0xfe, 0x85,
+  0x31, 0x7c, 0x1b, 0x2d, 0x61, 0x7d, 0x77, 0x9d, 0x81, 0xec, 0xae, 0x25, 0x17, 0x84, 0xf7, 0x15,
+  0x74, 0x94, 0xd9, 0x59, 0x45, 0x43, 0x89, 0x97, 0x0b, 0x7c, 0xcb, 0x75, 0xac, 0xdb, 0x51, 0xe3,
+  0xf7, 0x18, 0x3c, 0xef, 0x6b, 0xd7, 0x55, 0x4e, 0xc7, 0x68, 0x35, 0xc6, 0xff, 0xc4, 0x16, 0x02,
+  0x4d, 0x89, 0x23, 0x82, 0x8c, 0x66, 0x51, 0xe3, 0xf6, 0xca, 0xc8, 0x38, 0x8c, 0x2f, 0x1c, 0x7b,
+  0x01, 0x3e, 0x22, 0x8f, 0xd4, 0x30, 0x30, 0xe5, 0x8e, 0xe1, 0xfa, 0x47, 0xf4, 0xf0, 0x60, 0x70,
+  0xdc, 0x18, 0x5f, 0x6a, 0x4e, 0xca, 0xb6, 0x9a, 0x0a, 0x53, 0xc5, 0xad, 0xa6, 0xea, 0x1d, 0xd2,
+  0xfe, 0xe4, 0x08, 0xa6, 0xfa, 0x80, 0xc9, 0xe5, 0x86, 0xa9, 0x72, 0x1e, 0x35, 0x2f, 0xf8, 0x13,
+  0x6e, 0x45, 0x4e, 0x98, 0xcb, 0xd1, 0x5c, 0x26, 0xf0, 0xc4, 0x1a, 0xdd, 0x75, 0x22, 0xa4, 0x11,
+  0xb9, 0xbe, 0x39, 0x2e, 0xf4, 0xa3, 0xaa, 0x71, 0x99, 0x40, 0xd7, 0xc3, 0xe3, 0xf1, 0x4a, 0x83,
+  0x9d, 0x0e, 0x91, 0xa4, 0x24, 0x79, 0x3d, 0xd6, 0x4d, 0xf1, 0xd0, 0x90, 0x27, 0xfb, 0x26, 0x8c,
+  0x91, 0x21, 0x64, 0x96, 0x04, 0x39, 0xcc, 0x80, 0x54, 0xb1, 0xd7, 0x84, 0x54, 0x1d, 0x41, 0x47,
+  0xc4, 0x68, 0x91, 0xd1, 0x98, 0x3c, 0xc8, 0x41, 0xa9, 0xea, 0x8e, 0xe5, 0x13, 0xec, 0xc1, 0xd2,
+  0xaf, 0x49, 0xd8, 0x4a, 0x1f, 0x3f, 0x24, 0x04, 0xe1, 0x73, 0x89, 0xa0, 0x4b, 0x9f, 0x86, 0x7c,
+  0x1e, 0x08, 0x32, 0x8d, 0x02, 0x8f, 0x74, 0x6c, 0x18, 0xd5, 0x26, 0x60, 0xcd, 0x7e, 0xb2, 0x49,
+  0xb0, 0x55, 0xfe, 0xcb, 0x49, 0x18, 0xf3, 0x39, 0x3c, 0x01, 0x8d, 0x1d, 0x2c, 0xf1, 0x0b, 0x9e,
+  0x61, 0xa1, 0x7c, 0xe9, 0x5b, 0x64, 0x1a, 0xfb, 0xea, 0x78, 0xb9, 0x38, 0x21, 0x79, 0x28, 0x68,
+  0x53, 0x80, 0x81, 0x3d, 0x54, 0x96, 0x89, 0x05, 0x16, 0x2b, 0x88, 0xad, 0x44, 0x46, 0x65, 0x4a,
+  0x64, 0xa8, 0x8f, 0x29, 0x83, 0xa4, 0xc6, 0x68, 0x4a, 0xba, 0x9a, 0xad, 0x96, 0x89, 0x09, 0x3c,
+  0x70, 0x51, 0xc1, 0x80, 0xfd, 0xa6, 0x92, 0x2b, 0xde, 0xbb, 0x38, 0xa3, 0x00, 0xc5, 0xa5, 0xa0,
+  0xb4, 0xcb, 0xd8, 0x99, 0xc2, 0x32, 0x37, 0x41, 0xd6, 0xe7, 0x9c, 0x7c, 0x37, 0x1a, 0x11, 0x3f,
+  0x76, 0xdd, 0x16, 0xf1, 0x58, 0x34, 0x63, 0x48, 0x3a, 0xa6, 0x23, 0x40, 0x3e, 0x33, 0xfd, 0x60,
+  0x01, 0x2c, 0xec, 0x91, 0x64, 0xac, 0x66, 0xe2, 0xc7, 0x52, 0xdb, 0x23, 0xb1, 0x54, 0xd6, 0x27,
+  0x0f, 0xa1, 0x5b, 0x9a, 0xf9, 0x41, 0xda, 0x8b, 0x4b, 0x19, 0xc7, 0x8d, 0xe6, 0x99, 0x3c, 0xa9,
+  0x46, 0x89, 0x81, 0x01, 0x48, 0xbb, 0x91, 0x9c, 0x0c, 0x49, 0x93, 0xfc, 0x95, 0x48, 0x0c, 0x6d,
+  0xd2, 0x94, 0x9f, 0xcd, 0xf2, 0x3c, 0xaf, 0xaa, 0x02, 0x54, 0x7a, 0x01, 0x11, 0xfa, 0x6c, 0x41,
+  0xce, 0xf0, 0xe1, 0x32, 0x88, 0x23, 0x8b, 0x81, 0xfc, 0x54, 0x57, 0x19, 0x89, 0x6a, 0x05, 0xdb,
+  0xf2, 0xd4, 0x9e, 0x06, 0x40, 0x99, 0x5e, 0x68, 0x6a, 0x02, 0xc4, 0x8d, 0x9b, 0x27, 0x33, 0xa4,
+  0x11, 0x67, 0x06, 0x33, 0x91, 0x58, 0x8d, 0x50, 0xea, 0x05, 0x99, 0x49, 0xfd, 0x8f, 0x3f, 0x48,
+  0xb7, 0x55, 0xe6, 0xa9, 0xf8, 0x08, 0xeb, 0x22, 0x3d, 0x43, 0x34, 0xe2, 0x10, 0xa6, 0x92, 0x28,
+  0xa5, 0x0f, 0x6d, 0xcb, 0x34, 0x36, 0x07, 0xfe, 0xb8, 0x32, 0xea, 0xcc, 0x10, 0x57, 0x54, 0x28,
+  0x68, 0xb0, 0x6b, 0xc7, 0x63, 0x65, 0x95, 0x24, 0xa2, 0xf3, 0xd1, 0x32, 0x47, 0xd9, 0xd2, 0xbd,
+  0x56, 0x20, 0xa6, 0x63, 0xdf, 0x20, 0xa9, 0x86, 0xae, 0x1d, 0x56, 0x77, 0xb2, 0x38, 0x86, 0xb0,
+  0xce, 0x2b, 0x96, 0x20, 0x51, 0x9a, 0x98, 0x9a, 0xc2, 0xc8, 0x04, 0x0c, 0x9f, 0x74, 0xa3, 0x90,
+  0x30, 0x18, 0x85, 0x1f, 0xba, 0x6e, 0x75, 0xa1, 0x21, 0xc3, 0x22, 0x1f, 0x8b, 0xe3, 0xc0, 0xe6,
+  0x89, 0xa1, 0x58, 0xb9, 0xbe, 0x65, 0xb0, 0x21, 0x95, 0x84, 0xdd, 0xe0, 0x99, 0xd6, 0xa7, 0xc9,
+  0x7f, 0x21, 0x5a, 0x98, 0x88, 0xc9, 0x01, 0x67, 0xa1, 0x70, 0xb4, 0x74, 0x96, 0x89, 0xab, 0xe2,
+  0xbb, 0xeb, 0xa6, 0x63, 0x37, 0xc1, 0xea, 0x90, 0xd4, 0x66, 0x66, 0x7d, 0xf0, 0x45, 0xea, 0x0d,
+  0xbf, 0x80, 0x1d, 0xdd, 0x98, 0x0e, 0xb8, 0xe3, 0xd8, 0x06, 0x7c, 0x30, 0x1b, 0x20, 0x53, 0x74,
+  0x2a, 0x69, 0x20, 0x01, 0x28, 0x1d, 0xf9, 0xb4, 0xce, 0x6a, 0x4b, 0x4a, 0x35, 0x36, 0xe8, 0xb3,
+  0x32, 0x5c, 0xab, 0x49, 0x15, 0x71, 0x47, 0xc4, 0x0e, 0xac, 0xd8, 0x03, 0xb2, 0xcc, 0x19, 0x13,
+  0x67, 0x2e, 0xc3, 0xaf, 0x6f, 0x96, 0xef, 0x6d, 0xa3, 0x99, 0x05, 0xe2, 0xf2, 0x6a, 0x90, 0x90,
+  0xc0, 0x98, 0xcf, 0xa2, 0xbf, 0x5f, 0x9d, 0x7f, 0x00, 0x1c, 0xcd, 0x66, 0x71, 0x44, 0x22, 0x4a,
+  0xe0, 0x8f, 0x67, 0x16, 0xd1, 0xca, 0xfc, 0x8d, 0x63, 0xaf, 0x5b, 0x3b, 0x15, 0x0b, 0x03, 0x13,
+  0x3a, 0xae, 0x19, 0x9b, 0xb8, 0xdc, 0x51, 0x41, 0xfd, 0xbf, 0x26, 0xba, 0x50, 0xbe, 0x61, 0xd5,
+  0xa1, 0x75, 0x70, 0xc3, 0xb2, 0xda, 0xf3, 0x0a, 0x6a, 0x99, 0x1e, 0x0d, 0x0d, 0xe3, 0xfa, 0x16,
+  0xcc, 0xe4, 0x46, 0x86, 0x93, 0x5b, 0x40, 0xd9, 0x54, 0x5e, 0xe7, 0x0e, 0x9c, 0x6c, 0xe0, 0xf8,
+  0x06, 0x6a, 0x5a, 0xb3, 0xb4, 0x53, 0x21, 0x71, 0x16, 0x89, 0xcf, 0xb8, 0xa8, 0x0b, 0x02, 0xfb,
+  0xad, 0x26, 0xd1, 0xb3, 0xc7, 0x3f, 0x3c, 0x38, 0xf6, 0x23, 0xe4, 0x38, 0xb5, 0xb9, 0x20, 0x0e,
+  0x59, 0x2d, 0x99, 0x8d, 0x43, 0x15, 0x27, 0x1b, 0x87, 0x9d, 0x53, 0x31, 0x07, 0x6e, 0xef, 0x8d,
+  0x6e, 0x9b, 0xc8, 0xef, 0x32, 0x39, 0x30, 0x8c, 0x82, 0x53, 0x5a, 0xad, 0xc1, 0x56, 0xb2, 0x41,
+  0x6e, 0xb5, 0x6a, 0x30, 0xff, 0x56, 0xb2, 0x67, 0xbd, 0xc9, 0x6a, 0x22, 0x62, 0x16, 0x91, 0x9f,
+  0x10, 0x10, 0xc3, 0x78, 0x52, 0x17, 0x0f, 0x93, 0x0a, 0xe7, 0xba, 0x90, 0xa8, 0x70, 0xc8, 0x9a,
+  0xe8, 0x9a, 0xd5, 0x90, 0x2b, 0x95, 0xea, 0xd4, 0x8d, 0xe0, 0x66, 0x5a, 0xcc, 0x54, 0xe6, 0x03,
+  0xd8, 0x00, 0x28, 0x6b, 0x44, 0xbb, 0xec, 0x35, 0xc1, 0xe0, 0x9a, 0xdd, 0x66, 0x1d, 0xbc, 0xdc,
+  0xf4, 0x17, 0xa1, 0x65, 0x53, 0xcd, 0x78, 0x55, 0xd5, 0x2b, 0x8c, 0x57, 0x4d, 0x35, 0xe3, 0x57,
+  0x75, 0x9d, 0x0c, 0x26, 0xa7, 0x6b, 0x04, 0xcf, 0x46, 0x9c, 0xf3, 0x54, 0xc3, 0x35, 0xb8, 0x64,
+  0x15, 0xa5, 0x30, 0xb5, 0x6c, 0x79, 0x8b, 0x47, 0xbd, 0xb8, 0x48, 0x00, 0x1c, 0x57, 0x49, 0xd6,
+  0x01, 0x08, 0x35, 0xad, 0x6f, 0xb0, 0x8e, 0x53, 0x33, 0x83, 0x2a, 0x53, 0xd4, 0x51, 0x2a, 0x7b,
+  0xeb, 0xa8, 0xfc, 0x92, 0xe4, 0x22, 0xbd, 0xff, 0x90, 0x66, 0x9b, 0x4f, 0xca, 0x31, 0x72, 0xb6,
+  0xbd, 0x9d, 0x25, 0x99, 0xd4, 0xb6, 0x65, 0x06, 0xf2, 0x01, 0x4f, 0x97, 0xc1, 0x41, 0x18, 0x4d,
+  0x55, 0x58, 0x01, 0xb7, 0x52, 0x5c, 0x1d, 0x46, 0x25, 0x22, 0x33, 0xb4, 0x0e, 0x84, 0x3d, 0x55,
+  0x57, 0x6b, 0xca, 0xc6, 0x9d, 0x5f, 0x1c, 0x55, 0x09, 0xa4, 0x76, 0x39, 0x84, 0x2c, 0xd6, 0xe1,
+  0x15, 0xdb, 0x85, 0x64, 0x0f, 0xcc, 0xb5, 0x5d, 0x05, 0x93, 0x06, 0x99, 0x02, 0xe5, 0x0c, 0xb6,
+  0xad, 0xd5, 0x22, 0x15, 0xc9, 0xd0, 0xbc, 0xad, 0x56, 0x87, 0xe6, 0xec, 0x6e, 0x48, 0x64, 0xd2,
+  0x04, 0x19, 0x8d, 0x21, 0x01, 0xcb, 0x46, 0xdb, 0x22, 0x7f, 0x91, 0x2a, 0xaf, 0x22, 0x49, 0x4c,
+  0x62, 0x48, 0x8c, 0x22, 0x86, 0xbc, 0x21, 0xb5, 0x54, 0x42, 0x95, 0xe0, 0x58, 0x97, 0x55, 0x41,
+  0xce, 0xdf, 0xa8, 0x14, 0x02, 0xc9, 0xde, 0x18, 0xab, 0x83, 0xb2, 0x30, 0xa9, 0x72, 0x2b, 0xe2,
+  0xc9, 0x2f, 0xfd, 0x03, 0x55, 0x93, 0x3c, 0x26, 0x9e, 0xc3, 0xb9, 0xb4, 0x23, 0x20, 0x9b, 0x93,
+  0x5b, 0xc6, 0x42, 0xdc, 0x26, 0x38, 0x51, 0x7a, 0x01, 0x8a, 0x6b, 0x74, 0x24, 0xd7, 0x02, 0xe6,
+  0x35, 0x48, 0x6e, 0x6e, 0x65, 0x99, 0x3c, 0x74, 0x1d, 0x01, 0x6e, 0xac, 0xa9, 0x42, 0x91, 0x8f,
+  0x31, 0x28, 0x63, 0xce, 0x2f, 0xe7, 0x85, 0x32, 0x2f, 0x71, 0xf8, 0x47, 0xfa, 0xd1, 0x90, 0x48,
+  0xae, 0xbb, 0x37, 0x90, 0x72, 0x94, 0xd6, 0xe6, 0x88, 0xa4, 0x7d, 0x1b, 0x80, 0x7b, 0x05, 0xe0,
+  0x73, 0x9e, 0x41, 0xf6, 0x36, 0x41, 0xf6, 0x0b, 0x90, 0x72, 0x8d, 0x67, 0xc0, 0xfd, 0x12, 0xf0,
+  0x3a, 0xbf, 0x1e, 0x31, 0x1e, 0xc2, 0x17, 0x96, 0x39, 0xf7, 0xb2, 0x57, 0x6f, 0xd7, 0x6c, 0x5b,
+  0x3c, 0x26, 0xe6, 0x01, 0x6c, 0x6d, 0x9b, 0x17, 0x9f, 0x2e, 0xaf, 0x34, 0x46, 0x9c, 0x98, 0x9c,
+  0x8d, 0x77, 0x06, 0x21, 0x39, 0x6d, 0xbe, 0x55, 0x37, 0xf6, 0xf7, 0xae, 0x96, 0x21, 0xc3, 0xf0,
+  0x4e, 0x43, 0x90, 0xbb, 0x25, 0x77, 0xc0, 0x1d, 0x0c, 0x1b, 0x4d, 0xf2, 0xa8, 0x47, 0x82, 0x41,
+  0x7e, 0xa8, 0x52, 0x7d, 0x0e, 0xf9, 0x83, 0x3f, 0x73, 0xa6, 0x4b, 0x74, 0x4f, 0xad, 0x8d, 0xfb,
+  0x9f, 0x92, 0x13, 0x4a, 0x59, 0x35, 0x83, 0x5b, 0x0c, 0x14, 0x17, 0x25, 0x27, 0x44, 0x24, 0x45,
+  0xb0, 0xad, 0x34, 0xb8, 0x3a, 0x9f, 0xca, 0x0c, 0xcb, 0x6b, 0xc9, 0x98, 0xf2, 0xde, 0x07, 0x83,
+  0x81, 0xc4, 0xaa, 0xec, 0xbd, 0x6a, 0x98, 0x4f, 0x7e, 0x4a, 0xb3, 0x26, 0x37, 0x89, 0x25, 0x42,
+  0xbd, 0xa3, 0x7b, 0xba, 0x5f, 0x7d, 0x9a, 0xfb, 0x6c, 0x1d, 0xaf, 0x4d, 0x0e, 0xe4, 0xce, 0xfd,
+  0x09, 0x89, 0x01, 0x56, 0x0d, 0x6a, 0x12, 0x03, 0xe8, 0xfa, 0xf2, 0xa4, 0x20, 0xb9, 0xb8, 0xd1,
+  0xac, 0x0f, 0x92, 0xb1, 0x9d, 0x05, 0x30, 0x18, 0x2c, 0x1b, 0xb6, 0x0b, 0xe6, 0x38, 0x3a, 0x54,
+  0xf7, 0x0b, 0xfe, 0x2a, 0x1f, 0xb8, 0x08, 0x42, 0xbc, 0x62, 0x50, 0x03, 0x9e, 0x3f, 0xc7, 0x2e,
+  0x20, 0xc9, 0x77, 0x3c, 0x5f, 0x94, 0xcc, 0xd7, 0x63, 0x9e, 0x3d, 0x42, 0x66, 0x62, 0x7d, 0xf9,
+  0xe8, 0xa8, 0x2c, 0xa4, 0xca, 0x39, 0x2a, 0xaa, 0x1c, 0x89, 0x56, 0xda, 0x6c, 0x69, 0xe2, 0xa2,
+  0xd4, 0x95, 0x26, 0xd8, 0x81, 0xa3, 0xd5, 0x85, 0x2a, 0xa5, 0xcc, 0xf2, 0x14, 0x05, 0x40, 0x70,
+  0xc0, 0x55, 0xc8, 0xbc, 0x3a, 0xcb, 0xd0, 0x55, 0x1b, 0x68, 0xad, 0x8b, 0x70, 0x3b, 0xb9, 0x5e,
+  0x5c, 0x37, 0xdf, 0xa6, 0xdb, 0x05, 0xca, 0xbe, 0xd4, 0xed, 0xbe, 0xc9, 0x57, 0x19, 0xb7, 0x75,
+  0xb9, 0xf9, 0xa5, 0xf0, 0xff, 0xe5, 0x6e, 0xd3, 0xb2, 0xe9, 0x13, 0x3c, 0x6e, 0xad, 0xdd, 0xa8,
+  0x9a, 0xa3, 0xce, 0x53, 0x96, 0xab, 0xc4, 0x0a, 0x2e, 0x93, 0x55, 0x9d, 0x87, 0x56, 0x55, 0x8e,
+  0xcb, 0xd5, 0x99, 0x8e, 0xf1, 0x8c, 0x9b, 0x00, 0x45, 0xed, 0xae, 0x8e, 0xad, 0x54, 0x89, 0x29,
+  0xd0, 0xb8, 0x5b, 0x2d, 0x26, 0x77, 0x74, 0xf5, 0xf4, 0x6a, 0xcc, 0xab, 0x5a, 0x69, 0xaf, 0x4a,
+  0xc0, 0x72, 0x87, 0xba, 0xa6, 0x2a, 0x13, 0x05, 0x0b, 0xcc, 0x4f, 0xcb, 0x45, 0x8d, 0xaa, 0x5a,
+  0x60, 0xe0, 0xd6, 0x95, 0x0e, 0x39, 0xab, 0xb9, 0x45, 0xbd, 0x43, 0x0d, 0xdc, 0xaa, 0xde, 0xa1,
+  0x86, 0xa6, 0x6f, 0xa5, 0x6c, 0x8b, 0x59, 0xbd, 0xff, 0xb1, 0x71, 0xb4, 0x92, 0x93, 0xa9, 0x2e,
+  0x22, 0xe3, 0x4e, 0xe2, 0xfa, 0x46, 0x25, 0xe6, 0x11, 0xca, 0x2e, 0x02, 0x57, 0x2f, 0xeb, 0x43,
+  0x68, 0x35, 0x11, 0xba, 0xef, 0x5c, 0x85, 0x68, 0x4b, 0x4a, 0xd4, 0x6b, 0x1c, 0x8f, 0xe9, 0x63,
+  0xf6, 0xf2, 0x00, 0xfa, 0x0b, 0x22, 0x9f, 0xa4, 0xbb, 0x68, 0x66, 0x23, 0xd2, 0x5b, 0xf4, 0x72,
+  0x80, 0xa1, 0x9e, 0xa4, 0xd9, 0x96, 0xba, 0x81, 0xae, 0x56, 0x09, 0x34, 0x79, 0x6d, 0x42, 0x41,
+  0xca, 0x87, 0x1c, 0x60, 0xda, 0x99, 0x83, 0xdb, 0x8e, 0x83, 0xf4, 0x0e, 0xba, 0xdc, 0x68, 0x3d,
+  0x96, 0x5b, 0x2f, 0x2c, 0x21, 0xe7, 0xeb, 0xe4, 0xa6, 0xca, 0xf7, 0xc1, 0x74, 0x3f, 0x6e, 0x39,
+  0x9d, 0x91, 0x8a, 0x08, 0x0f, 0x96, 0xf3, 0xca, 0x98, 0xa2, 0x32, 0xa6, 0xaa, 0xa2, 0x9c, 0xaa,
+  0x63, 0x6a, 0xe2, 0xad, 0x85, 0xbc, 0x42, 0x10, 0xa2, 0x29, 0x98, 0x07, 0x1b, 0x5f, 0xf0, 0x00,
+  0x11, 0x6b, 0x93, 0x79, 0xec, 0x39, 0x36, 0x04, 0xf1, 0x4d, 0x53, 0xd7, 0x9f, 0x8c, 0x26, 0x47,
+  0x70, 0xc9, 0xe1, 0xa3, 0x7a, 0x63, 0xb2, 0xb1, 0x3a, 0x91, 0x53, 0x0d, 0x72, 0xe9, 0x19, 0x39,
+  0xeb, 0x6f, 0x35, 0xc6, 0xa7, 0xb2, 0x47, 0x7f, 0xb0, 0x97, 0x3b, 0xf8, 0xdc, 0xb9, 0xd0, 0x06,
+  0x9b, 0x59, 0xbc, 0xf1, 0xac, 0x96, 0xb9, 0xcc, 0x6a, 0xe7, 0x20, 0x70, 0x97, 0x45, 0x9b, 0x93,
+  0xb1, 0xe4, 0x8d, 0xb9, 0x97, 0x4d, 0xc6, 0x5e, 0xe9, 0x73, 0xef, 0xe4, 0x70, 0x10, 0x8f, 0x69,
+  0xde, 0x25, 0x8f, 0x32, 0xd3, 0xd1, 0xa6, 0x72, 0x30, 0x4a, 0x15, 0xda, 0x74, 0xf9, 0x9c, 0x93,
+  0xcf, 0xe6, 0x52, 0xd4, 0xc8, 0xab, 0x81, 0x65, 0xfc, 0x56, 0x4b, 0x5b, 0x4d, 0x90, 0x2e, 0xa4,
+  0x16, 0x2e, 0x1d, 0xa0, 0x85, 0x4e, 0x3c, 0x4a, 0x2d, 0x70, 0xd2, 0xaf, 0x85, 0x55, 0x3e, 0xa0,
+  0x16, 0x54, 0x75, 0xeb, 0x67, 0xc5, 0x3b, 0xf7, 0xa4, 0x34, 0x13, 0x9e, 0x4f, 0x54, 0xf2, 0xc0,
+  0x4a, 0xa9, 0x23, 0xf7, 0x1e, 0x05, 0x16, 0x39, 0xae, 0xaf, 0x7b, 0xdd, 0xf6, 0xc1, 0x4d, 0xfb,
+  0xfa, 0xa0, 0xdb, 0xee, 0xdf, 0xdc, 0x68, 0xc4, 0x9d, 0x38, 0xc1, 0x51, 0x69, 0x3a, 0xd5, 0x0c,
+  0xd6, 0x92, 0x94, 0x2e, 0xda, 0xcd, 0x6a, 0x52, 0x96, 0x73, 0x99, 0x26, 0xa4, 0x6f, 0x9e, 0x01,
+  0x1b, 0xb1, 0xa9, 0xe3, 0x0a, 0x30, 0xa9, 0xa4, 0x55, 0xdd, 0x97, 0x5b, 0x0f, 0x99, 0x4c, 0x30,
+  0xac, 0xab, 0x8d, 0x68, 0x8a, 0x23, 0x8a, 0x38, 0x93, 0x07, 0x1e, 0x2b, 0xce, 0x24, 0x0f, 0x37,
+  0xfb, 0xe8, 0x12, 0x22, 0xd5, 0x2b, 0xcb, 0x19, 0xad, 0xd6, 0x96, 0x39, 0x57, 0x22, 0x0b, 0x2f,
+  0x06, 0xb9, 0xb8, 0x01, 0x64, 0x77, 0xae, 0x73, 0xcb, 0xc8, 0x4a, 0xa4, 0xcd, 0xba, 0xf4, 0x41,
+  0x65, 0x85, 0x98, 0xb7, 0xaf, 0x3b, 0xff, 0xc9, 0x91, 0x9e, 0x08, 0x26, 0x33, 0x76, 0x33, 0x53,
+  0x83, 0xfa, 0x52, 0xe5, 0xb9, 0xa8, 0x9e, 0xc4, 0xad, 0x83, 0xf5, 0xac, 0x50, 0xa4, 0xae, 0x7e,
+  0x54, 0x67, 0x71, 0x2b, 0xa0, 0x4d, 0xe8, 0xb3, 0x78, 0x55, 0x98, 0x60, 0x15, 0xc5, 0x20, 0x85,
+  0x88, 0xca, 0x67, 0x5d, 0x55, 0x2c, 0x69, 0xd0, 0x2a, 0x20, 0xc9, 0x22, 0x59, 0x2d, 0x99, 0x39,
+  0xb0, 0xed, 0x66, 0xf8, 0x4c, 0x17, 0x9a, 0x29, 0xa0, 0x35, 0xa3, 0xb3, 0xb2, 0x4c, 0x06, 0x72,
+  0x75, 0x0c, 0x92, 0x57, 0xb8, 0xda, 0xd0, 0xd0, 0xe9, 0x17, 0x9a, 0xf0, 0x1d, 0xab, 0x3e, 0xbe,
+  0xd8, 0xd5, 0x48, 0x3a, 0xe0, 0x41, 0xb3, 0x7a, 0xb2, 0x28, 0x59, 0x5e, 0x3f, 0x69, 0xc7, 0x6a,
+  0x05, 0x75, 0x9a, 0x1a, 0x76, 0xd2, 0x61, 0x58, 0xe2, 0x5b, 0x31, 0x90, 0xc3, 0x9a, 0xc9, 0x28,
+  0x3f, 0x72, 0x0d, 0x9e, 0x9e, 0x0e, 0x0f, 0x46, 0x64, 0x1d, 0xaa, 0xde, 0x4d, 0xab, 0x2a, 0x9b,
+  0xec, 0x0d, 0x29, 0x58, 0x8d, 0x43, 0x72, 0xfd, 0x80, 0x8e, 0xa7, 0x0d, 0xd6, 0x3d, 0x6b, 0xcb,
+  0x1b, 0x83, 0x43, 0x12, 0xf7, 0x7e, 0xfe, 0x83, 0xc3, 0xbf, 0x78, 0xbf, 0xff, 0x07, 0x87, 0x7f,
+  0xd3, 0xfd, 0x7e, 0x9b, 0xe0, 0x5b, 0x4c, 0xf0, 0x3f, 0xbe, 0x97, 0xd4, 0xc6, 0x6b, 0x8d, 0xb0,
+  0x93, 0xc2, 0x77, 0x45, 0x2d, 0xc7, 0xa3, 0x2e, 0x7f, 0xd4, 0x39, 0x9e, 0x24, 0xe0, 0x97, 0x05,
+  0xa7, 0x9a, 0x41, 0x6c, 0xca, 0xa3, 0x68, 0x2c, 0x40, 0x0e, 0xd0, 0xad, 0x68, 0xfd, 0x86, 0x46,
+  0x3a, 0xd4, 0x95, 0x09, 0x27, 0x93, 0xe6, 0x8e, 0xf5, 0x13, 0x84, 0x9a, 0xbb, 0x0e, 0xb9, 0x9d,
+  0x47, 0xab, 0x06, 0xb3, 0xce, 0x8b, 0xe4, 0x04, 0x48, 0x1c, 0x4e, 0xfc, 0x40, 0x9e, 0x70, 0xc2,
+  0x16, 0x13, 0x27, 0x5d, 0xeb, 0x43, 0xea, 0xfc, 0x48, 0xd5, 0x97, 0x3c, 0x56, 0xf4, 0xf6, 0x2f,
+  0x9c, 0x02, 0x17, 0xa7, 0x1f, 0x10, 0x3b, 0x56, 0x3b, 0x70, 0x7c, 0xa9, 0xbd, 0x22, 0xc0, 0xe2,
+  0xd6, 0x41, 0xba, 0x49, 0x79, 0x75, 0x84, 0x9b, 0x78, 0xa2, 0x3b, 0x1a, 0xad, 0xa4, 0xe5, 0xd8,
+  0xdb, 0x7a, 0xce, 0xf4, 0x0d, 0x7a, 0x42, 0xdd, 0x08, 0xac, 0x6b, 0x49, 0xd8, 0x3d, 0xc8, 0x80,
+  0x7f, 0xb7, 0x83, 0xc7, 0xdc, 0x8e, 0x2f, 0xb4, 0xca, 0x27, 0x70, 0xa6, 0xae, 0x25, 0xe4, 0x79,
+  0xc3, 0x96, 0xa7, 0x71, 0x27, 0x71, 0x3c, 0x33, 0x7f, 0x3b, 0xed, 0xc1, 0x21, 0x81, 0x93, 0x14,
+  0x7d, 0xa3, 0x05, 0x9c, 0x54, 0xc4, 0xfa, 0x2a, 0x8e, 0xf6, 0x16, 0x46, 0xae, 0xa2, 0xb2, 0xcd,
+  0x42, 0x53, 0xfa, 0x00, 0x31, 0xe0, 0x1b, 0xd7, 0xaa, 0xfa, 0x32, 0x8d, 0x5d, 0x77, 0x29, 0xd5,
+  0x91, 0x96, 0x63, 0x6a, 0x96, 0x97, 0xac, 0xb0, 0xc1, 0x7c, 0x4c, 0x18, 0x35, 0x23, 0x94, 0xb0,
+  0x0b, 0xf7, 0xcd, 0x34, 0xae, 0x81, 0xb9, 0xa0, 0x99, 0x2d, 0x7d, 0x02, 0x51, 0xbf, 0x18, 0x44,
+  0xe5, 0xed, 0x6b, 0x4d, 0xe6, 0xf1, 0x9b, 0x29, 0x1c, 0xe5, 0x37, 0x39, 0xe0, 0x07, 0x4a, 0x73,
+  0xcb, 0xb3, 0x22, 0x0b, 0xaf, 0x18, 0x46, 0x9e, 0xd1, 0x7c, 0x1d, 0x31, 0xb2, 0x0c, 0x62, 0xd0,
+  0x45, 0xf2, 0x65, 0x41, 0x7d, 0x81, 0xa5, 0xb6, 0xe4, 0x77, 0xd3, 0xa8, 0xfd, 0x0a, 0x12, 0x06,
+  0x1e, 0x06, 0xb6, 0x72, 0xbf, 0x36, 0xb5, 0x2b, 0xef, 0xa5, 0xd6, 0x4b, 0x8e, 0x95, 0x5f, 0x1d,
+  0x7b, 0xa4, 0xe8, 0xd8, 0x6e, 0xed, 0xbc, 0xb0, 0x09, 0x2b, 0xca, 0x9e, 0x6e, 0xc4, 0x2f, 0x60,
+  0xa2, 0x92, 0x94, 0x6f, 0xd2, 0x48, 0x6b, 0x4d, 0xb4, 0x7c, 0xa3, 0x77, 0xab, 0xfa, 0x66, 0x9e,
+  0x18, 0x79, 0x01, 0x78, 0x55, 0x27, 0x34, 0x4d, 0x73, 0x83, 0xec, 0x37, 0x18, 0x9a, 0x24, 0x48,
+  0x51, 0x83, 0xbe, 0xb9, 0x64, 0x4b, 0xda, 0x22, 0xf6, 0xae, 0xa6, 0xc3, 0x25, 0xf7, 0x58, 0xd7,
+  0xc6, 0x3c, 0x51, 0x5e, 0x25, 0xe5, 0x4c, 0x2d, 0xba, 0xf3, 0x7f, 0x5e, 0x5d, 0x6d, 0x32, 0xa2,
+  0x27, 0x1a, 0xc7, 0xef, 0x45, 0x41, 0xfd, 0x29, 0xac, 0x43, 0x73, 0x45, 0xfb, 0x59, 0x0a, 0xe0,
+  0x80, 0xf6, 0xc5, 0x55, 0x5c, 0xa0, 0x5b, 0x72, 0x62, 0xa3, 0x66, 0xa7, 0x2e, 0xe5, 0xf3, 0x67,
+  0x56, 0x2d, 0x20, 0x47, 0xc5, 0x5a, 0xf9, 0x19, 0xff, 0x14, 0xfa, 0xd5, 0xdc, 0x8b, 0x7f, 0x0e,
+  0xfd, 0xae, 0x9c, 0xea, 0x57, 0xd3, 0x2f, 0x4e, 0x09, 0x0a, 0x96, 0x37, 0xd2, 0xb7, 0x52, 0xf1,
+  0x0b, 0x85, 0x80, 0xf4, 0xd4, 0xe4, 0x4f, 0x60, 0x0b, 0xab, 0x55, 0xbe, 0xc2, 0x98, 0x5c, 0xea,
+  0x56, 0xdb, 0x54, 0xfd, 0x01, 0x8d, 0x7a, 0x9f, 0xec, 0xd4, 0xb9, 0x5b, 0x7b, 0x48, 0x23, 0x07,
+  0x95, 0xc9, 0xc8, 0x40, 0x8b, 0xc7, 0x22, 0x85, 0xb7, 0x54, 0xd4, 0x2f, 0x82, 0xfb, 0xe1, 0x01,
+  0x09, 0x78, 0x6c, 0x8c, 0x7f, 0x78, 0x48, 0x48, 0x7a, 0x54, 0xaf, 0x58, 0xfc, 0x56, 0xb9, 0xef,
+  0x9d, 0xbc, 0xfa, 0x6e, 0xa8, 0x97, 0x1c, 0xf4, 0x53, 0x34, 0x41, 0x03, 0x83, 0xf2, 0xed, 0x6f,
+  0x55, 0x48, 0x4e, 0x5f, 0xd6, 0x38, 0xe9, 0xa8, 0xf7, 0x6b, 0x4e, 0x3a, 0xea, 0x17, 0x61, 0xfe,
+  0x0f, 0x78, 0x4b, 0x92, 0x19, 0x20, 0x53, 0x00, 0x00,
+};
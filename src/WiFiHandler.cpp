@@ -1,5 +1,7 @@
 #include "WiFiHandler.h"
 #include <ArduinoOTA.h>
+#include "Hal.h"
+#include "Logger.h"
 
 const char* ssidSTA = "Tanand_Hardware";
 const char* passwordSTA = "202040406060808010102020";
@@ -8,30 +10,48 @@ const char* ssidAP = "ESP8266_AP";
 const char* passwordAP = "12345678";
 
 bool otaInitialized = false;
-unsigned long previousWiFiCheck = 0;
-const unsigned long wifiCheckInterval = 10000;
+static bool staConnected = false;
+static unsigned long staLostAt = 0;
+static unsigned long rebeginMs = WIFI_REBEGIN_MIN_MS;
+static bool clockSynced = false;
 
 void setupWiFi() {
+    WiFi.persistent(false);        // don't rewrite the flash config on every begin()
+    WiFi.setAutoReconnect(true);   // the SDK rejoins on its own after a drop
     WiFi.mode(WIFI_AP_STA);
     WiFi.begin(ssidSTA, passwordSTA);
     WiFi.softAP(ssidAP, passwordAP);
-    Serial.print("AP IP: "); Serial.println(WiFi.softAPIP());
-    Serial.print("STA IP: "); Serial.println(WiFi.localIP());
+    halClockBegin(NTP_SERVER);     // SNTP starts once the link is up and resyncs by itself
+    LOG_INFO("AP IP: %s", WiFi.softAPIP().toString().c_str());
+    LOG_INFO("STA IP: %s", WiFi.localIP().toString().c_str());
 }
 
+// Only watches the link: the SDK reconnects by itself, so begin() is repeated
+// only when that hasn't worked for a while, since each call restarts the join
 void checkWiFi() {
     unsigned long now = millis();
-    if (now - previousWiFiCheck >= wifiCheckInterval) {
-        previousWiFiCheck = now;
-        if (WiFi.status() != WL_CONNECTED) {
-            Serial.println("Reconnecting STA...");
-            WiFi.begin(ssidSTA, passwordSTA);
-            otaInitialized = false;
-        } else if (!otaInitialized) {
+    bool connected = WiFi.status() == WL_CONNECTED;
+    if (!clockSynced && halEpochMillis()) {
+        clockSynced = true;
+        LOG_INFO("🕒 Clock synced from %s", NTP_SERVER);
+    }
+    if (connected && !staConnected) {
+        staConnected = true;
+        rebeginMs = WIFI_REBEGIN_MIN_MS;
+        LOG_INFO("STA connected, IP: %s", WiFi.localIP().toString().c_str());
+        if (!otaInitialized) {
             ArduinoOTA.begin();
             otaInitialized = true;
-            Serial.print("STA connected, IP: ");
-            Serial.println(WiFi.localIP());
         }
+    } else if (!connected && staConnected) {
+        staConnected = false;
+        staLostAt = now;
+        otaInitialized = false;
+        LOG_WARN("STA link lost, waiting for auto-reconnect...");
+    } else if (!connected && now - staLostAt >= rebeginMs) {
+        staLostAt = now;
+        rebeginMs = min(rebeginMs * 2, WIFI_REBEGIN_MAX_MS);
+        LOG_WARN("Reconnecting STA, next attempt in %lu s", rebeginMs / 1000);
+        WiFi.begin(ssidSTA, passwordSTA);
     }
 }
@@ -1,6 +1,13 @@
 #pragma once
 #include <ESP8266WiFi.h>
 
+#define WIFI_REBEGIN_MIN_MS 30000UL    // down this long despite auto-reconnect: start over...
+#define WIFI_REBEGIN_MAX_MS 300000UL   // ...and back off doubling up to this
+
+#ifndef NTP_SERVER
+#define NTP_SERVER "pool.ntp.org"      // readings' timestamps, e.g. -DNTP_SERVER=\"192.168.1.1\"
+#endif
+
 extern bool otaInitialized;
 
 void setupWiFi();
@@ -0,0 +1,168 @@
+#include "WindowAggregator.h"
+#include "ResultPublisher.h"
+#include "ResultEncoder.h"
+#include "RegisterMap.h"
+#include "SlaveTable.h"
+#include "MQTTHandler.h"
+#include "OfflineQueue.h"
+#include "Hal.h"
+#include "Logger.h"
+
+WindowStats windowStats = {};
+
+// Ends on the next multiple of windowMs in UTC when the clock is known
+static void openWindow(ModbusSlave& slave, unsigned long at) {
+  WindowState& window = slaveWindowState(slave);
+  uint64_t epochMs = halEpochMillis();
+  uint32_t offset = epochMs ? (epochMs - (millis() - at)) % slave.windowMs : 0;
+  window.end = at - offset + slave.windowMs;
+  window.polls = 0;
+  window.errors = 0;
+  memset(slaveWindows(slave), 0, slave.windowFields * sizeof(WindowField));
+  window.open = true;
+}
+
+// Queued summary: start and end epoch ms (0 while the clock isn't synced),
+// polls, errors, then min, max, mean and last per field as float32 (NaN
+// for a field without samples), all as little-endian word pairs
+static void putWords(uint16_t* p, uint32_t v) {
+  p[0] = v & 0xFFFF;
+  p[1] = v >> 16;
+}
+
+static uint32_t getWords(const uint16_t* p) {
+  return p[0] | (uint32_t)p[1] << 16;
+}
+
+static void putFloatWords(uint16_t* p, double value) {
+  float f = value;
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  putWords(p, v);
+}
+
+static double getFloatWords(const uint16_t* p) {
+  uint32_t v = getWords(p);
+  float f;
+  memcpy(&f, &v, sizeof(f));
+  return f;
+}
+
+static void queueSummary(const ModbusSlave& slave, uint64_t startEpochMs, uint64_t endEpochMs) {
+  static uint16_t record[QUEUE_MAX_WORDS];
+  const WindowState& window = slaveWindowState(slave);
+  const WindowField* windows = slaveWindows(slave);
+  putWords(record, startEpochMs);
+  putWords(record + 2, startEpochMs >> 32);
+  putWords(record + 4, endEpochMs);
+  putWords(record + 6, endEpochMs >> 32);
+  putWords(record + 8, window.polls);
+  putWords(record + 10, window.errors);
+  for (uint8_t i = 0; i < slave.windowFields; i++) {
+    const WindowField& w = windows[i];
+    uint16_t* p = record + QUEUE_WINDOW_WORDS(i);
+    putFloatWords(p, w.count ? w.min : NAN);
+    putFloatWords(p + 2, w.count ? w.max : NAN);
+    putFloatWords(p + 4, w.count ? w.sum / w.count : NAN);
+    putFloatWords(p + 6, w.count ? w.last : NAN);
+  }
+  queueReading(slave.id, QUEUE_RESULT_WINDOW, record, QUEUE_WINDOW_WORDS(slave.windowFields), window.end);
+  windowStats.queued++;
+}
+
+static void closeWindow(ModbusSlave& slave) {
+  WindowState& window = slaveWindowState(slave);
+  window.open = false;
+  uint64_t epochMs = halEpochMillis();
+  uint64_t endEpochMs = epochMs ? epochMs - (millis() - window.end) : 0;
+  uint64_t startEpochMs = endEpochMs ? endEpochMs - slave.windowMs : 0;
+
+  char topic[MAX_TOPIC_PREFIX + 8];
+  snprintf(topic, sizeof(topic), "%s/window", publishConfig.prefix);
+  size_t length = encodeWindowSummary(slave, window, slaveWindows(slave), startEpochMs, endEpochMs,
+                                      publishConfig.format);
+  if (!length) {
+    LOG_ERROR("❌ Window summary for slave %u exceeds the encoder arena", slave.id);
+    windowStats.dropped++;
+  } else if (mqttClient.connected() && publishPayload(topic, resultPayload(), length)) {
+    windowStats.published++;
+  } else {
+    queueSummary(slave, startEpochMs, endEpochMs);
+  }
+}
+
+// Replays a summary from the offline queue; false if the broker didn't take
+// it (try again later). One whose slave was deleted or remapped since is
+// dropped.
+bool publishQueuedSummary(const QueuedReading& record) {
+  ModbusSlave* slave = findSlaveById(record.slaveId);
+  if (!slave || record.words != QUEUE_WINDOW_WORDS(slave->windowFields)) {
+    windowStats.dropped++;
+    return true;
+  }
+  WindowState window = {};
+  window.polls = getWords(record.image + 8);
+  window.errors = getWords(record.image + 10);
+  WindowField windows[MAX_FIELDS_PER_SLAVE] = {};
+  for (uint8_t i = 0; i < slave->windowFields; i++) {
+    const uint16_t* p = record.image + QUEUE_WINDOW_WORDS(i);
+    WindowField& w = windows[i];
+    w.sum = getFloatWords(p + 4);
+    if (isnan(w.sum)) continue;
+    w.min = getFloatWords(p);
+    w.max = getFloatWords(p + 2);
+    w.last = getFloatWords(p + 6);
+    w.count = 1;  // sum holds the mean
+  }
+  uint64_t startEpochMs = getWords(record.image) | (uint64_t)getWords(record.image + 2) << 32;
+  uint64_t endEpochMs = getWords(record.image + 4) | (uint64_t)getWords(record.image + 6) << 32;
+
+  char topic[MAX_TOPIC_PREFIX + 8];
+  snprintf(topic, sizeof(topic), "%s/window", publishConfig.prefix);
+  size_t length = encodeWindowSummary(*slave, window, windows, startEpochMs, endEpochMs, publishConfig.format);
+  if (!length) {
+    windowStats.dropped++;
+    return true;
+  }
+  if (!publishPayload(topic, resultPayload(), length)) return false;
+  windowStats.published++;
+  return true;
+}
+
+// Run once per finished poll of a slave with windowMs set
+void aggregateReading(ModbusSlave& slave, uint8_t result, const uint16_t* image) {
+  WindowState& window = slaveWindowState(slave);
+  unsigned long sampleTime = slaveSampling(slave).sampleTime;
+  if (window.open && (long)(sampleTime - window.end) >= 0) closeWindow(slave);
+  if (!window.open) openWindow(slave, sampleTime);
+  windowStats.samples++;
+  if (result != RTU_SUCCESS) {
+    window.errors++;
+    return;
+  }
+  window.polls++;
+  WindowField* windows = slaveWindows(slave);
+  for (uint8_t i = 0; i < slave.windowFields; i++) {
+    double value = decodeField(slaveField(slave, i), image);
+    if (!isfinite(value)) continue;
+    WindowField& w = windows[i];
+    if (!w.count || value < w.min) w.min = value;
+    if (!w.count || value > w.max) w.max = value;
+    w.sum += value;
+    w.last = value;
+    w.count++;
+  }
+}
+
+// Run from loop(): closes windows nobody polled past the end of, e.g.
+// behind an open breaker, but not while the slave's poll is on the bus
+void serviceWindows() {
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    ModbusSlave& slave = slaves[i];
+    const WindowState& window = slaveWindowState(slave);
+    if (!window.open || (long)(now - window.end) < 0) continue;
+    if (queryState == Q_QUERYING && currentQueryIndex == i) continue;
+    closeWindow(slave);
+  }
+}
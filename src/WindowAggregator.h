@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+#include "ModBusHandler.h"
+#include "OfflineQueue.h"
+
+// Summaries over fixed windows, for slaves polled fast whose values are only
+// needed as, say, one-minute figures upstream. A slave with windowMs set
+// keeps a running min, max, sum and last value per field (one WindowField
+// in the slave table's pool, 40 bytes), updated in O(1) per poll with no
+// samples kept. When the window ends its summary goes out on
+// <prefix>/window (see encodeWindowSummary()) and the polls themselves
+// aren't published, unless windowRaw is set.
+//
+// Windows line up with multiples of windowMs in UTC once the clock is
+// synced (on the minute for 60000), else they count from the first poll.
+// A window closes with the first poll past its end, or from
+// serviceWindows() when none comes. A summary that can't be published right
+// away goes to the offline queue like a poll would, with its values as
+// float32, and is replayed on <prefix>/window once the broker is back.
+
+#define MIN_WINDOW_MS 1000UL
+#define MAX_WINDOW_MS 86400000UL  // a day
+
+struct WindowStats {
+  uint32_t samples;      // polls folded into windows
+  uint32_t published;    // summaries sent, live or replayed
+  uint32_t queued;       // summaries handed to the offline queue
+  uint32_t dropped;      // summaries lost: too big for the encoder, or slave changed before replay
+};
+
+extern WindowStats windowStats;
+
+// Function declarations
+void aggregateReading(ModbusSlave& slave, uint8_t result, const uint16_t* image);
+void serviceWindows();
+bool publishQueuedSummary(const QueuedReading& record);
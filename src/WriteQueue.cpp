@@ -0,0 +1,439 @@
+#include "WriteQueue.h"
+#include "RtuMaster.h"
+#include "SlaveTable.h"
+#include "SlaveHealth.h"
+#include "MQTTHandler.h"
+#include "ResultPublisher.h"
+#include "WebServerHandler.h"
+#include "Metrics.h"
+#include "Logger.h"
+
+WriteStats writeStats;
+
+// One coil or register value waiting for the bus
+struct WriteEntry {
+  uint8_t slaveId;
+  uint8_t request;       // index into requests
+  bool coil;
+  bool inFlight;         // part of the write on the bus
+  uint16_t address;
+  uint16_t value;        // 0/1 for coils
+};
+
+// A request until all its values are settled, then a history record
+struct WriteRequest {
+  uint32_t seq;          // 0 = free slot
+  uint8_t slaveId;
+  uint8_t open;          // values not settled yet
+  uint8_t status;        // worst outcome so far
+  uint8_t error;         // RTU result behind a failure
+  bool reported;         // published on <prefix>/write/status
+  unsigned long queuedAt;
+  uint32_t ms;           // queued to settled
+  const char* reason;    // why it was rejected
+  char ref[WRITE_REF_MAX + 1];
+};
+
+static WriteEntry queue[WRITE_QUEUE_SIZE];
+static uint8_t queueCount = 0;
+static WriteRequest requests[WRITE_MAX_REQUESTS];
+static WriteRequest history[WRITE_HISTORY];
+static uint8_t historyNext = 0;
+static uint32_t nextSeq = 1;
+
+// The write on the bus: entries marked inFlight, sent as txPdu
+enum WritePhase : uint8_t { WRITE_IDLE, WRITE_SENDING, WRITE_VERIFYING };
+static WritePhase phase = WRITE_IDLE;
+static uint8_t batchSlave = 0;
+static bool batchCoil = false;
+static uint16_t batchStart = 0;
+static uint16_t batchCount = 0;
+static uint8_t txPdu[6 + WRITE_MAX_VALUES * 2];
+static uint8_t txLength = 0;
+static unsigned long phaseStart = 0;
+static uint16_t phaseTimeoutMs = 0;
+
+const char* writeStatusName(uint8_t status) {
+  static const char* const names[] = {"pending", "ok", "superseded", "unverified", "mismatch", "failed", "rejected"};
+  return status <= WRITE_REJECTED ? names[status] : "?";
+}
+
+// ----------------- Requests -----------------
+
+static void keepRecord(const WriteRequest& request) {
+  history[historyNext] = request;
+  historyNext = (historyNext + 1) % WRITE_HISTORY;
+  writeStats.outcomes[request.status]++;
+}
+
+static void finishRequest(WriteRequest& request) {
+  request.ms = millis() - request.queuedAt;
+  request.reported = false;
+  histogramAdd(writeHist, request.ms * 1000);
+  if (request.status >= WRITE_UNVERIFIED) {
+    LOG_WARN("⚠️ Write #%lu to slave %u: %s (0x%02X)", (unsigned long)request.seq, request.slaveId,
+             writeStatusName(request.status), request.error);
+  } else {
+    LOG_DEBUG("Write #%lu to slave %u: %s in %lu ms", (unsigned long)request.seq, request.slaveId,
+              writeStatusName(request.status), (unsigned long)request.ms);
+  }
+  keepRecord(request);
+  request.seq = 0;
+}
+
+// One value of the request has its outcome
+static void settle(uint8_t index, uint8_t status, uint8_t error) {
+  WriteRequest& request = requests[index];
+  if (status > request.status) {
+    request.status = status;
+    request.error = error;
+  }
+  if (--request.open == 0) finishRequest(request);
+}
+
+static void reject(uint8_t slaveId, const char* ref, const char* reason) {
+  WriteRequest record = {};
+  record.seq = nextSeq++;
+  record.slaveId = slaveId;
+  record.status = WRITE_REJECTED;
+  record.reason = reason;
+  strncpy(record.ref, ref, WRITE_REF_MAX);
+  keepRecord(record);
+  LOG_WARN("⚠️ Write to slave %u rejected: %s", slaveId, reason);
+}
+
+// The queued (not yet sent) entry for this coil/register, or -1
+static int findQueued(uint8_t slaveId, bool coil, uint16_t address) {
+  for (uint8_t i = 0; i < queueCount; i++) {
+    const WriteEntry& entry = queue[i];
+    if (!entry.inFlight && entry.slaveId == slaveId && entry.coil == coil && entry.address == address) return i;
+  }
+  return -1;
+}
+
+// Parses values into out[]; coils take true/false or 0/1, registers
+// -32768..65535 (negative ones as two's complement)
+static uint8_t parseValues(JsonObject request, bool coil, uint16_t* out, const char*& error) {
+  JsonArray array = request["values"].as<JsonArray>();
+  uint8_t count = 0;
+  auto take = [&](JsonVariant v) {
+    if (count >= WRITE_MAX_VALUES) {
+      error = "too many values";
+      return false;
+    }
+    if (coil && v.is<bool>()) {
+      out[count++] = v.as<bool>() ? 1 : 0;
+      return true;
+    }
+    long value = v.as<long>();
+    if (!v.is<long>() || (coil && value != 0 && value != 1) || value < -32768 || value > 65535) {
+      error = "bad value";
+      return false;
+    }
+    out[count++] = (uint16_t)value;
+    return true;
+  };
+  if (!array.isNull()) {
+    for (JsonVariant v : array) {
+      if (!take(v)) return 0;
+    }
+  } else if (!request["value"].isNull()) {
+    if (!take(request["value"])) return 0;
+  }
+  if (count == 0 && !error) error = "no value";
+  return count;
+}
+
+// Queues {"id":1,"register":10,"value":5} or {"id":1,"coil":3,"values":[true,false]}
+// (values go to consecutive addresses), with an optional "ref". Returns the
+// request's sequence number, or 0 with error set if it was rejected.
+uint32_t queueWriteJson(JsonObject request, const char*& error) {
+  error = nullptr;
+  long id = request["id"] | 0L;
+  const char* ref = request["ref"] | "";
+  bool coil = !request["coil"].isNull();
+  long address = coil ? request["coil"] | -1L : request["register"] | -1L;
+  uint16_t values[WRITE_MAX_VALUES];
+  uint8_t count = 0;
+  if (id < SLAVE_ID_MIN || id > SLAVE_ID_MAX) {
+    error = "bad slave ID";
+  } else if (coil && !request["register"].isNull()) {
+    error = "give register or coil, not both";
+  } else if (address < 0 || address > 0xFFFF) {
+    error = "bad address";
+  } else {
+    count = parseValues(request, coil, values, error);
+    if (count && address + count > 0x10000) error = "bad address";
+  }
+
+  // Room for the request and for the values that don't replace queued ones
+  uint8_t slot = WRITE_MAX_REQUESTS;
+  if (!error) {
+    uint8_t added = 0;
+    for (uint8_t i = 0; i < count; i++) added += findQueued(id, coil, address + i) < 0;
+    for (uint8_t i = 0; i < WRITE_MAX_REQUESTS && slot == WRITE_MAX_REQUESTS; i++) {
+      if (!requests[i].seq) slot = i;
+    }
+    if (slot == WRITE_MAX_REQUESTS || queueCount + added > WRITE_QUEUE_SIZE) error = "queue full";
+  }
+  if (error) {
+    reject(id, ref, error);
+    return 0;
+  }
+
+  WriteRequest& req = requests[slot];
+  req = WriteRequest();
+  req.seq = nextSeq++;
+  req.slaveId = id;
+  req.open = count;
+  req.status = WRITE_PENDING;
+  req.queuedAt = millis();
+  strncpy(req.ref, ref, WRITE_REF_MAX);
+  writeStats.requests++;
+
+  for (uint8_t i = 0; i < count; i++) {
+    int found = findQueued(id, coil, address + i);
+    if (found >= 0) {
+      // Only the latest value matters; the older request keeps its place in line
+      writeStats.superseded++;
+      settle(queue[found].request, WRITE_SUPERSEDED, RTU_SUCCESS);
+      queue[found].request = slot;
+      queue[found].value = values[i];
+    } else {
+      queue[queueCount++] = {(uint8_t)id, slot, coil, false, (uint16_t)(address + i), values[i]};
+    }
+  }
+  LOG_DEBUG("Write #%lu: slave %u, %s %ld, %u value(s), %u queued", (unsigned long)req.seq, req.slaveId,
+            coil ? "coil" : "register", address, count, queueCount);
+  return req.seq;
+}
+
+uint8_t writeQueueLength() {
+  return queueCount;
+}
+
+// ----------------- Bus Side -----------------
+
+bool writePending() {
+  return phase == WRITE_IDLE && queueCount > 0;
+}
+
+bool writeActive() {
+  return phase != WRITE_IDLE;
+}
+
+// Settles every value of the write on the bus and drops it from the queue.
+// With a read-back reply each value is compared, otherwise all get status.
+static void settleBatch(uint8_t status, uint8_t error, const uint8_t* readBack) {
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < queueCount; i++) {
+    WriteEntry entry = queue[i];
+    if (!entry.inFlight) {
+      queue[kept++] = entry;
+      continue;
+    }
+    uint8_t outcome = status;
+    if (readBack) {
+      uint16_t offset = entry.address - batchStart;
+      uint16_t value = batchCoil ? (readBack[2 + offset / 8] >> (offset % 8)) & 1
+                                 : (readBack[2 + offset * 2] << 8) | readBack[3 + offset * 2];
+      outcome = value == entry.value ? WRITE_OK : WRITE_MISMATCH;
+    }
+    settle(entry.request, outcome, error);
+  }
+  queueCount = kept;
+  phase = WRITE_IDLE;
+}
+
+// FC05/FC06 for one value, FC15/FC16 for a run of neighbours
+static void buildWritePdu() {
+  uint8_t values[WRITE_MAX_VALUES * 2] = {};
+  for (uint8_t i = 0; i < queueCount; i++) {
+    const WriteEntry& entry = queue[i];
+    if (!entry.inFlight) continue;
+    uint16_t offset = entry.address - batchStart;
+    if (batchCoil) {
+      values[offset / 8] |= entry.value << (offset % 8);
+    } else {
+      values[offset * 2] = entry.value >> 8;
+      values[offset * 2 + 1] = entry.value & 0xFF;
+    }
+  }
+  txPdu[1] = batchStart >> 8;
+  txPdu[2] = batchStart & 0xFF;
+  if (batchCount == 1) {
+    txPdu[0] = batchCoil ? 0x05 : 0x06;
+    txPdu[3] = batchCoil ? (values[0] ? 0xFF : 0x00) : values[0];
+    txPdu[4] = batchCoil ? 0x00 : values[1];
+    txLength = 5;
+    return;
+  }
+  uint8_t bytes = batchCoil ? (batchCount + 7) / 8 : batchCount * 2;
+  txPdu[0] = batchCoil ? 0x0F : 0x10;
+  txPdu[3] = batchCount >> 8;
+  txPdu[4] = batchCount & 0xFF;
+  txPdu[5] = bytes;
+  memcpy(txPdu + 6, values, bytes);
+  txLength = 6 + bytes;
+}
+
+// Puts the oldest queued value on the bus, with every queued neighbour of it
+// (same slave and kind, consecutive addresses) up to WRITE_MAX_VALUES. The
+// caller makes sure no poll is running. Writes to a slave behind an open
+// breaker fail without the bus.
+bool startWrite() {
+  while (phase == WRITE_IDLE && queueCount > 0 && !rtuBusy()) {
+    const WriteEntry& first = queue[0];
+    batchSlave = first.slaveId;
+    batchCoil = first.coil;
+    batchStart = first.address;
+    batchCount = 1;
+    while (batchCount < WRITE_MAX_VALUES && batchStart > 0 && findQueued(batchSlave, batchCoil, batchStart - 1) >= 0) {
+      batchStart--;
+      batchCount++;
+    }
+    while (batchCount < WRITE_MAX_VALUES && (uint32_t)batchStart + batchCount <= 0xFFFF &&
+           findQueued(batchSlave, batchCoil, batchStart + batchCount) >= 0) {
+      batchCount++;
+    }
+    for (uint16_t i = 0; i < batchCount; i++) queue[findQueued(batchSlave, batchCoil, batchStart + i)].inFlight = true;
+    buildWritePdu();
+
+    ModbusSlave* slave = findSlaveById(batchSlave);
+    phaseTimeoutMs = slave ? slaveTimeoutMs(*slave) : busConfig.turnaroundMs;
+    if ((slave && slaveHealth(*slave).probeLevel) || !rtuStartRequest(batchSlave, txPdu, txLength, phaseTimeoutMs)) {
+      settleBatch(WRITE_FAILED, RTU_RESPONSE_TIMED_OUT, nullptr);
+      continue;
+    }
+    phase = WRITE_SENDING;
+    phaseStart = millis();
+    writeStats.transactions++;
+    writeStats.values += batchCount;
+    return true;
+  }
+  return false;
+}
+
+// Reads the written coils/registers back (FC01/FC03)
+static bool startReadBack() {
+  uint8_t pdu[5] = {(uint8_t)(batchCoil ? 0x01 : 0x03), (uint8_t)(batchStart >> 8), (uint8_t)(batchStart & 0xFF),
+                    (uint8_t)(batchCount >> 8), (uint8_t)(batchCount & 0xFF)};
+  if (!rtuStartRequest(batchSlave, pdu, sizeof(pdu), phaseTimeoutMs)) return false;
+  phase = WRITE_VERIFYING;
+  phaseStart = millis();
+  return true;
+}
+
+// Advances the write and its read-back; true once both have finished
+bool continueWrite() {
+  if (phase == WRITE_IDLE) return false;
+
+  // Backstop as for polls; an idle engine means the bus settings changed under it
+  uint32_t limitMs = rtuTimeoutMillis(txLength + 3, RTU_MAX_FRAME, phaseTimeoutMs);
+  RtuState state = RTU_IDLE;
+  if (millis() - phaseStart > 2 * limitMs) rtuAbort();
+  else state = rtuPoll();
+  if (state != RTU_IDLE && state != RTU_DONE) return false;
+
+  uint8_t result = state == RTU_DONE ? rtuResult() : RTU_RESPONSE_TIMED_OUT;
+  if (state == RTU_DONE) {
+    histogramAdd(transactionHist, rtuTransactionMicros());
+    ModbusSlave* slave = findSlaveById(batchSlave);
+    if (slave && rtuTurnaroundMicros()) recordTurnaround(*slave, rtuTurnaroundMicros());
+  }
+  uint16_t length = 0;
+  const uint8_t* pdu = result == RTU_SUCCESS ? rtuResponsePdu(length) : nullptr;
+
+  if (phase == WRITE_SENDING) {
+    // The reply echoes address and value (single) or quantity (multiple)
+    if (!pdu || length != 5 || memcmp(pdu + 1, txPdu + 1, 4) != 0) {
+      settleBatch(WRITE_FAILED, result == RTU_SUCCESS ? RTU_INVALID_RESPONSE : result, nullptr);
+      return true;
+    }
+    if (startReadBack()) return false;
+    settleBatch(WRITE_UNVERIFIED, RTU_SUCCESS, nullptr);
+    return true;
+  }
+
+  uint8_t bytes = batchCoil ? (batchCount + 7) / 8 : batchCount * 2;
+  if (pdu && length == 2 + bytes && pdu[1] == bytes) {
+    settleBatch(WRITE_OK, RTU_SUCCESS, pdu);
+  } else {
+    settleBatch(WRITE_UNVERIFIED, result == RTU_SUCCESS ? RTU_INVALID_RESPONSE : result, nullptr);
+  }
+  return true;
+}
+
+// ----------------- Status -----------------
+
+static void writeRecord(JsonObject out, const WriteRequest& request) {
+  out["seq"] = request.seq;
+  if (request.ref[0]) out["ref"] = request.ref;
+  out["id"] = request.slaveId;
+  out["status"] = writeStatusName(request.status);
+  if (request.status == WRITE_REJECTED) out["reason"] = request.reason;
+  else if (request.status != WRITE_PENDING) out["ms"] = request.ms;
+  if (request.status == WRITE_FAILED || (request.status == WRITE_UNVERIFIED && request.error)) {
+    out["error"] = request.error;
+  }
+}
+
+// Run from loop(): publishes settled requests on <prefix>/write/status
+void reportWriteStatus() {
+  if (!mqttClient.connected()) return;
+  char topic[MAX_TOPIC_PREFIX + 16];
+  snprintf(topic, sizeof(topic), "%s/write/status", publishConfig.prefix);
+  for (uint8_t i = 0; i < WRITE_HISTORY; i++) {
+    WriteRequest& record = history[(historyNext + i) % WRITE_HISTORY];
+    if (!record.seq || record.reported) continue;
+    JsonDocument doc;
+    writeRecord(doc.to<JsonObject>(), record);
+    char payload[96 + WRITE_REF_MAX];
+    size_t length = serializeJson(doc, payload, sizeof(payload));
+    if (!publishPayload(topic, payload, length)) return;  // try again next time
+    record.reported = true;
+  }
+}
+
+// ----------------- HTTP -----------------
+
+// POST /write with a queueWriteJson() body -> 202 {"status":"queued","seq":7}.
+// The outcome follows on <prefix>/write/status and from GET /write?seq=7.
+void handleWrite() {
+  JsonDocument doc;
+  if (deserializeJson(doc, server.arg("plain")) || !doc.is<JsonObject>()) {
+    server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    return;
+  }
+  const char* error = nullptr;
+  uint32_t seq = queueWriteJson(doc.as<JsonObject>(), error);
+  char reply[64];
+  if (!seq) {
+    snprintf(reply, sizeof(reply), "{\"error\":\"%s\"}", error);
+    server.send(strcmp(error, "queue full") == 0 ? 503 : 400, "application/json", reply);
+    return;
+  }
+  snprintf(reply, sizeof(reply), "{\"status\":\"queued\",\"seq\":%lu}", (unsigned long)seq);
+  server.send(202, "application/json", reply);
+}
+
+// GET /write?seq=7 -> the request's status record; 404 once it has left the history
+void handleGetWrite() {
+  uint32_t seq = server.arg("seq").toInt();
+  const WriteRequest* found = nullptr;
+  for (uint8_t i = 0; seq && i < WRITE_MAX_REQUESTS && !found; i++) {
+    if (requests[i].seq == seq) found = &requests[i];
+  }
+  for (uint8_t i = 0; seq && i < WRITE_HISTORY && !found; i++) {
+    if (history[i].seq == seq) found = &history[i];
+  }
+  if (!found) {
+    server.send(404, "application/json", "{\"error\":\"Unknown write\"}");
+    return;
+  }
+  JsonDocument doc;
+  writeRecord(doc.to<JsonObject>(), *found);
+  String output;
+  serializeJson(doc, output);
+  server.send(200, "application/json", output);
+}
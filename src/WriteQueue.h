@@ -0,0 +1,55 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Writes to slaves (FC05/06/15/16), from POST /write and <prefix>/write.
+// Every value waits as its own entry per coil or register: a newer value for
+// an address that hasn't gone out yet replaces the queued one, and queued
+// values for neighbouring addresses of one slave go out together as one
+// FC15/FC16 write. The bus task serves writes before reads and polls (a due
+// poll goes first after WRITE_BURST writes in a row). Each write is read back
+// (FC01/FC03) and compared. A request's outcome, known once all its values
+// are settled, is kept for GET /write and published on <prefix>/write/status:
+//   {"seq":7,"ref":"a1","id":1,"status":"ok","ms":48}
+//
+// RAM: 8 bytes per queue entry, ~50 per tracked request (2 KB at the defaults).
+
+#define WRITE_QUEUE_SIZE 64      // coils/registers waiting
+#define WRITE_MAX_REQUESTS 16    // requests not settled yet
+#define WRITE_MAX_VALUES 32      // per request, and per bus write
+#define WRITE_HISTORY 16         // settled requests kept for GET /write
+#define WRITE_BURST 4            // writes in a row before a due poll goes first
+#define WRITE_REF_MAX 32         // longer "ref"s are cut
+
+// Outcome of a request: the worst of its values'
+enum WriteStatus : uint8_t {
+  WRITE_PENDING,
+  WRITE_OK,           // written and read back
+  WRITE_SUPERSEDED,   // a newer value for the address went out instead
+  WRITE_UNVERIFIED,   // written, but the read-back failed
+  WRITE_MISMATCH,     // written, but read back different (clamped by the device?)
+  WRITE_FAILED,       // refused or not answered
+  WRITE_REJECTED      // never queued (bad request, queue full)
+};
+
+struct WriteStats {
+  uint32_t requests;      // requests queued
+  uint32_t superseded;    // values replaced by a newer one before going out
+  uint32_t transactions;  // writes put on the bus
+  uint32_t values;        // values those carried
+  uint32_t outcomes[WRITE_REJECTED + 1];  // settled requests by status
+};
+
+extern WriteStats writeStats;
+
+// Function declarations
+const char* writeStatusName(uint8_t status);
+uint32_t queueWriteJson(JsonObject request, const char*& error);
+uint8_t writeQueueLength();
+bool writePending();
+bool writeActive();
+bool startWrite();
+bool continueWrite();
+void reportWriteStatus();
+void handleWrite();
+void handleGetWrite();
@@ -3,85 +3,138 @@
 #include "WiFiHandler.h"
 #include "MQTTHandler.h"
 #include <LittleFS.h> 
-#include "ModbusHandler.h"    // ✅ This defines ModbusSlave struct
+#include "ModBusHandler.h"    // ✅ This defines ModbusSlave struct
+#include "PollScheduler.h"
+#include "ResultPublisher.h"
+#include "OfflineQueue.h"
+#include "LiveData.h"
+#include "RegisterCache.h"
+#include "MqttCommands.h"
+#include "WriteQueue.h"
+#include "ConfigJournal.h"
+#include "Metrics.h"
+#include "LoopTasks.h"
+#include "ModbusTcpServer.h"
 #include "WebServerHandler.h" // ✅ This uses the shared struct
+#include "Logger.h"
+
+// ----------------- Loop Tasks -----------------
+
+// Polls and on-demand reads (cache refreshes, Modbus TCP requests) take
+// turns when both are waiting
+static bool demandTurn = false;
+// Writes go before both, but a due poll gets the bus after WRITE_BURST of them
+static uint8_t writeStreak = 0;
+// Smoothed length of a write or on-demand read; none starts when a
+// fixed-rate slave falls due sooner than that
+static uint32_t demandMs = 0;
+static unsigned long demandStart = 0;
+
+static void demandFinished() {
+  demandMs = (3 * demandMs + (millis() - demandStart)) / 4;
+}
+
+// Manual queries, writes, on-demand reads and scheduled polling; each slave
+// runs at its own pollMs and ResultPublisher decides what goes out
+static void serviceBus() {
+  if (shouldQuerySlaves) {
+    shouldQuerySlaves = false;
+    LOG_INFO("Manual query started: %u of %u slaves stale", pollStaleNow(slaves, slaveCount), slaveCount);
+  }
+  if (writeActive()) {
+    if (continueWrite()) demandFinished();
+    return;
+  }
+  bool demandFits = !fixedRateDueWithin(slaves, slaveCount, demandMs);
+  if (queryState == Q_IDLE && demandFits && writePending() &&
+      (writeStreak < WRITE_BURST || !slavePollDue(slaves, slaveCount))) {
+    demandStart = millis();
+    if (startWrite()) writeStreak++;
+    return;
+  }
+  if (cacheFetchActive()) {
+    if (continueCacheFetch()) {
+      demandTurn = false;
+      demandFinished();
+    }
+    return;
+  }
+  if (tcpRequestActive()) {
+    if (continueTcpRequest()) {
+      demandTurn = false;
+      demandFinished();
+    }
+    return;
+  }
+  if (queryState == Q_IDLE && demandFits && (cacheFetchPending() || tcpRequestPending()) &&
+      (demandTurn || !slavePollDue(slaves, slaveCount))) {
+    demandStart = millis();
+    if (!startCacheFetch()) startTcpRequest();  // one refresh can answer many readers
+    return;
+  }
+  if (pollSlaves(slaves, slaveCount)) {
+    recordSlaveReading(slaves[currentQueryIndex], slavePollResult(), slavePollImage());
+    cacheSlavePolled(currentQueryIndex, slavePollResult(), queryStartTime);
+    publishSlaveResult(slaves[currentQueryIndex], slavePollResult(), slavePollImage());
+    resetQueryState();
+    demandTurn = true;
+    writeStreak = 0;
+  }
+}
 
-// Timer for periodic Modbus polling
-unsigned long previousMillis = 0;
-const unsigned long interval = 3000; // 3 seconds
+static void serviceOta() {
+  if (otaInitialized) ArduinoOTA.handle();
+}
 
 void setup() {
-  Serial.begin(9600, SERIAL_8N1);
+  // Serial belongs to the Modbus bus (opened in setupModbus); logs go to Serial1
+  logBegin();
 
-  Serial.println("Mounting LittleFS...");
+  LOG_INFO("Mounting LittleFS...");
   if (!LittleFS.begin()) {
-    Serial.println("❌ LittleFS mount failed!");
+    LOG_ERROR("❌ LittleFS mount failed!");
   } else {
-    Serial.println("✅ LittleFS mounted successfully");
+    LOG_INFO("✅ LittleFS mounted successfully");
+    queueBegin();  // readings left over from before a reboot
+    // Configuration from the journal; first boot after an upgrade converts the old JSON file
+    if (!journalLoad() && loadLegacyConfig()) journalSave();
   }
 
   // ----------------- Setup Wi-Fi -----------------
   setupWiFi();
   mqttClient.setServer(mqttServer, mqttPort);
+  setupMqttCommands();
 
   // ----------------- Setup Modbus -----------------
   setupModbus();
 
+  // ----------------- Setup Modbus TCP -----------------
+  setupModbusTcp();
+
   // ----------------- Setup Web Server -----------------
   setupWebServer();  // ✅ Now this will use the shared ModbusSlave struct
 
   // ----------------- Setup OTA -----------------
   ArduinoOTA.begin();
 
-  Serial.println("ESP8266 Modbus RTU Master with Web Server Started");
+  // ----------------- Loop Tasks: name, priority, budget (us), period (ms) -----------------
+  addLoopTask("bus", serviceBus, TASK_BUS, 5000);
+  addLoopTask("mqtt", serviceMQTT, TASK_HIGH, 5000);
+  addLoopTask("web", handleWebServer, TASK_HIGH, 20000);
+  addLoopTask("modbusTcp", serviceModbusTcp, TASK_HIGH, 5000);
+  addLoopTask("publish", servicePublishing, TASK_NORMAL, 10000);  // batch deadlines, offline queue replay
+  addLoopTask("events", serviceEvents, TASK_NORMAL, 5000);
+  addLoopTask("commands", serviceMqttCommands, TASK_NORMAL, 5000);  // MQTT reads and writes, write status
+  addLoopTask("wifi", checkWiFi, TASK_NORMAL, 1000, 100);
+  addLoopTask("saves", processPendingSaves, TASK_LOW, 50000);     // journal appends write flash
+  addLoopTask("metrics", serviceMetrics, TASK_LOW, 5000, 100);
+  addLoopTask("log", logDrain, TASK_LOW, 2000);                   // drains only while the bus is idle
+  addLoopTask("ota", serviceOta, TASK_LOW, 5000);
+
+  LOG_INFO("ESP8266 Modbus RTU Master with Web Server Started");
 }
 
 void loop() {
-  // ----------------- Keep Wi-Fi Alive -----------------
-  checkWiFi();
-
-  // ----------------- Keep MQTT Alive -----------------
-  if (!mqttClient.connected()) reconnectMQTT();
-  mqttClient.loop();
-
-  // ----------------- Handle Web Server -----------------
-  handleWebServer();
-
-  // ----------------- Process Pending Saves -----------------
-  processPendingSaves();
-
-  // ----------------- Handle Manual Queries -----------------
-  if (shouldQuerySlaves) {
-    shouldQuerySlaves = false;
-    // Start non-blocking query using the shared slaves array
-    if (startNonBlockingQuery(slaves, slaveCount)) {
-      Serial.println("Manual query started");
-    }
-  }
-
-  // ----------------- Continue Non-Blocking Queries -----------------
-  if (queryState == Q_QUERYING) {
-    if (continueNonBlockingQuery(slaves, slaveCount)) {
-      // Query completed
-      String results = getQueryResults();
-      publishMessage(mqttTopicPub, results.c_str());
-      resetQueryState();
-    }
-  }
-
-  // ----------------- Periodic Auto Polling -----------------
-  // unsigned long currentMillis = millis();
-  // if (currentMillis - previousMillis >= interval && slaveCount > 0) {
-  //   previousMillis = currentMillis;
-    
-  //   // Start non-blocking auto-query using the shared slaves array
-  //   if (queryState == Q_IDLE) {
-  //     startNonBlockingQuery(slaves, slaveCount);
-  //   }
-  // }
-
-  // ----------------- Handle OTA Updates -----------------
-  if(otaInitialized){
-    ArduinoOTA.handle();
-  }
-}
\ No newline at end of file
+  metricsLoopTick();
+  runLoopTasks();
+}
@@ -0,0 +1,81 @@
+// Host implementation of Hal.h: virtual clock plus the simulated RS485 bus.
+#include "../Hal.h"
+#include "../RtuMaster.h"
+#include "NativeClock.h"
+#include "SimBus.h"
+#include <ESP8266WiFi.h>
+#include "../MQTTHandler.h"
+
+uint64_t nativeNowMicros = 0;
+
+void nativeClockAdvance(uint64_t micros) { nativeNowMicros += micros; }
+
+uint32_t halMillis() { return (uint32_t)(nativeNowMicros / 1000); }
+uint32_t halMicros() { return (uint32_t)nativeNowMicros; }
+void halDelayMicros(uint32_t us) { nativeClockAdvance(us); }
+
+// Synced from the start: the virtual clock runs from 2026-01-01 00:00 UTC
+#define NATIVE_EPOCH_MS 1767225600000ULL
+void halClockBegin(const char* ntpServer) {}
+uint64_t halEpochMillis() { return NATIVE_EPOCH_MS + nativeNowMicros / 1000; }
+
+void halBusBegin(uint32_t baud, uint8_t config, uint8_t dePin) { simBusBegin(baud, config); }
+int halBusAvailable() { return simBusAvailable(); }
+int halBusRead() { return simBusRead(); }
+size_t halBusWrite(const uint8_t* data, size_t len) { return simBusWrite(data, len); }
+int halBusAvailableForWrite() { return RTU_MAX_FRAME; }  // the simulated line takes a frame in one write
+int halBusTxQueued() { return simBusTxQueued(); }
+void halBusSetTransmit(bool transmit) { simBusSetTransmit(transmit); }
+
+// ----------------- Network -----------------
+// Names resolve on the first poll. The broker answers a connect after
+// NATIVE_CONNECT_RTT_US while the harness has it up and Wi-Fi linked;
+// otherwise the connect stays pending, like a host that drops SYNs.
+#define NATIVE_CONNECT_RTT_US 2000
+
+static uint8_t resolveState = HAL_FAILED;
+static uint8_t connectState = HAL_FAILED;
+static uint64_t connectStarted = 0;
+
+uint8_t halResolveStart(const char* host, uint32_t& ip) {
+  IPAddress literal;
+  if (literal.fromString(host)) {
+    ip = literal;
+    return resolveState = HAL_DONE;
+  }
+  return resolveState = HAL_PENDING;
+}
+
+uint8_t halResolvePoll(uint32_t& ip) {
+  if (resolveState == HAL_PENDING) {
+    ip = IPAddress(127, 0, 0, 1);
+    resolveState = HAL_DONE;
+  }
+  return resolveState;
+}
+
+void halResolveCancel() { resolveState = HAL_FAILED; }
+
+uint8_t halConnectStart(uint32_t ip, uint16_t port) {
+  connectStarted = nativeNowMicros;
+  return connectState = HAL_PENDING;
+}
+
+uint8_t halConnectPoll() {
+  if (connectState == HAL_PENDING && WiFi.nativeLinkUp && mqttClient.nativeBrokerUp &&
+      nativeNowMicros - connectStarted >= NATIVE_CONNECT_RTT_US) {
+    connectState = HAL_DONE;
+  }
+  return connectState;
+}
+
+void halConnectCancel() { connectState = HAL_FAILED; }
+
+bool halConnectTake(WiFiClient& client) {
+  if (connectState != HAL_DONE) return false;
+  connectState = HAL_FAILED;
+  auto socket = std::make_shared<NativeSocket>();
+  socket->fresh = true;
+  client = WiFiClient(socket);
+  return true;
+}
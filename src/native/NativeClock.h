@@ -0,0 +1,9 @@
+#pragma once
+#include <stdint.h>
+
+// Virtual time for [env:native]. millis()/micros() and halMillis()/halMicros()
+// all read this counter; the harness advances it between loop() passes and
+// delay() advances it too, so blocking calls show up as loop latency.
+extern uint64_t nativeNowMicros;
+
+void nativeClockAdvance(uint64_t micros);
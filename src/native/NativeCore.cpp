@@ -0,0 +1,264 @@
+// Host implementations of the Arduino / ESP8266 stand-ins in include/.
+#include <Arduino.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <ESP8266WiFi.h>
+#include <ArduinoOTA.h>
+#include <PubSubClient.h>
+#include <LittleFS.h>
+#include <ESP8266WebServer.h>
+#include "NativeClock.h"
+
+bool nativeConsoleEcho = false;
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+ESP8266WiFiClass WiFi;
+EspClass ESP;
+ArduinoOTAClass ArduinoOTA;
+fs::FS LittleFS;
+
+// ----------------- Core -----------------
+unsigned long millis() { return (unsigned long)(nativeNowMicros / 1000); }
+unsigned long micros() { return (unsigned long)nativeNowMicros; }
+void delay(unsigned long ms) { nativeClockAdvance((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { nativeClockAdvance(us); }
+void yield() {}
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+
+size_t Print::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof buf, fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  return write((const uint8_t*)buf, std::min<size_t>(n, sizeof buf - 1));
+}
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  bytesWritten += n;
+  if (nativeConsoleEcho) fwrite(buf, 1, n, stdout);
+  return n;
+}
+
+// ----------------- PubSubClient -----------------
+// 2.8: connect the socket unless it already is, send CONNECT in one write,
+// spin on available() until the socket timeout, then read the 4-byte CONNACK
+// through read() and accept return code 0. The spin never ends on the
+// virtual clock, so it is counted and treated as a timeout instead.
+bool PubSubClient::connect(const char* id) {
+  if (connected()) return true;
+  if (!client_->connected() && !client_->connect(IPAddress(), 0)) return false;
+  uint8_t packet[MQTT_MAX_PACKET_SIZE];
+  uint8_t idLength = strlen(id);
+  size_t n = 0;
+  packet[n++] = 0x10;
+  packet[n++] = 12 + idLength;
+  memcpy(packet + n, "\0\4MQTT\4\2", 8);
+  n += 8;
+  packet[n++] = MQTT_KEEPALIVE >> 8;
+  packet[n++] = MQTT_KEEPALIVE & 0xFF;
+  packet[n++] = 0;
+  packet[n++] = idLength;
+  memcpy(packet + n, id, idLength);
+  client_->write(packet, n + idLength);
+  if (!client_->available()) {
+    blockingWaits++;
+    client_->stop();
+    return false;
+  }
+  uint8_t connack[4];
+  for (uint8_t i = 0; i < sizeof(connack); i++) connack[i] = client_->read();
+  connected_ = nativeBrokerUp && connack[1] == 2 && connack[3] == 0;
+  if (!connected_) client_->stop();
+  return connected_;
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int len, bool) {
+  if (!connected()) return false;
+  // Same limit as the real client: header + topic + payload must fit the buffer
+  if (5 + 2 + strlen(topic) + len > bufferSize_) {
+    droppedCount++;
+    return false;
+  }
+  publishCount++;
+  publishBytes += len;
+  lastTopic = topic;
+  lastPayload.assign((const char*)payload, len);
+  return true;
+}
+
+bool PubSubClient::beginPublish(const char* topic, unsigned int len, bool) {
+  if (!connected()) return false;
+  lastTopic = topic;
+  lastPayload.clear();
+  streamExpected_ = len;
+  return true;
+}
+
+size_t PubSubClient::write(uint8_t c) {
+  lastPayload.push_back((char)c);
+  return 1;
+}
+
+size_t PubSubClient::write(const uint8_t* buf, size_t n) {
+  lastPayload.append((const char*)buf, n);
+  return n;
+}
+
+int PubSubClient::endPublish() {
+  if (lastPayload.size() != streamExpected_) {
+    droppedCount++;
+    return 0;
+  }
+  publishCount++;
+  publishBytes += lastPayload.size();
+  return 1;
+}
+
+void PubSubClient::nativeDeliver(const char* topic, const uint8_t* payload, unsigned int len) {
+  if (!callback_) return;
+  std::string t(topic);
+  std::string p((const char*)payload, len);
+  callback_(&t[0], (uint8_t*)&p[0], len);
+}
+
+// ----------------- LittleFS -----------------
+namespace fs {
+
+size_t File::size() const {
+  if (!f_) return 0;
+  long pos = ftell(f_.get());
+  fseek(f_.get(), 0, SEEK_END);
+  long end = ftell(f_.get());
+  fseek(f_.get(), pos, SEEK_SET);
+  return end;
+}
+
+std::string FS::hostPath(const char* path) const {
+  return std::string(nativeRoot.c_str()) + (path[0] == '/' ? "" : "/") + path;
+}
+
+bool FS::begin() {
+  mkdir(nativeRoot.c_str(), 0755);
+  return true;
+}
+
+File FS::open(const char* path, const char* mode) {
+  std::string m(mode);
+  if (m == "r+" && !exists(path)) return File();
+  FILE* f = fopen(hostPath(path).c_str(), (m + "b").c_str());
+  return f ? File(f, path) : File();
+}
+
+bool FS::exists(const char* path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) { return ::remove(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char* from, const char* to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::info(FSInfo& info) {
+  info.totalBytes = 1024 * 1024;
+  info.usedBytes = 0;
+  info.blockSize = 8192;
+  info.pageSize = 256;
+  return true;
+}
+
+}  // namespace fs
+
+// ----------------- ESP8266WebServer -----------------
+static void parseArgs(const String& query, std::vector<std::pair<String, String>>& args) {
+  int pos = 0;
+  while (pos < (int)query.length()) {
+    int amp = query.indexOf('&', pos);
+    if (amp < 0) amp = query.length();
+    String pair = query.substring(pos, amp);
+    int eq = pair.indexOf('=');
+    if (eq >= 0) args.push_back({pair.substring(0, eq), pair.substring(eq + 1)});
+    else if (pair.length()) args.push_back({pair, String()});
+    pos = amp + 1;
+  }
+}
+
+void ESP8266WebServer::nativeRequest(HTTPMethod method, const String& uri, const String& body,
+                                     const std::vector<std::pair<String, String>>& headers) {
+  Request req;
+  req.method = method;
+  int q = uri.indexOf('?');
+  req.uri = q >= 0 ? uri.substring(0, q) : uri;
+  if (q >= 0) parseArgs(uri.substring(q + 1), req.args);
+  if (body.length()) req.args.push_back({"plain", body});
+  req.headers = headers;
+  queue_.push_back(req);
+}
+
+void ESP8266WebServer::handleClient() {
+  if (queue_.empty()) return;
+  current_ = queue_.front();
+  queue_.pop_front();
+  requestCount++;
+  lastCode = 0;
+  lastBody.clear();
+  lastHeaders.clear();
+  pendingHeaders_.clear();
+  contentLength_ = CONTENT_LENGTH_NOT_SET;
+  client_ = WiFiClient();
+  for (auto& r : routes_) {
+    if (r.uri == current_.uri && (r.method == HTTP_ANY || r.method == current_.method)) {
+      r.fn();
+      return;
+    }
+  }
+  if (notFound_) notFound_();
+  else send(404, "text/plain", "Not found");
+}
+
+String ESP8266WebServer::arg(const String& name) const {
+  for (auto& a : current_.args) if (a.first == name) return a.second;
+  return String();
+}
+
+bool ESP8266WebServer::hasArg(const String& name) const {
+  for (auto& a : current_.args) if (a.first == name) return true;
+  return false;
+}
+
+String ESP8266WebServer::header(const String& name) const {
+  for (auto& h : current_.headers) if (h.first == name) return h.second;
+  return String();
+}
+
+void ESP8266WebServer::sendHeader(const String& name, const String& value, bool first) {
+  if (first) pendingHeaders_.insert(pendingHeaders_.begin(), {name, value});
+  else pendingHeaders_.push_back({name, value});
+}
+
+void ESP8266WebServer::send(int code, const char* type, const String& content) {
+  send(code, type, content.c_str(), content.length());
+}
+
+void ESP8266WebServer::send(int code, const char* type, const char* content, size_t len) {
+  lastCode = code;
+  lastHeaders = pendingHeaders_;
+  if (type) lastHeaders.push_back({"Content-Type", type});
+  pendingHeaders_.clear();
+  if (content && len && contentLength_ != CONTENT_LENGTH_UNKNOWN) lastBody.assign(content, len);
+  responseBytes += len;
+}
+
+void ESP8266WebServer::sendContent(const char* content, size_t len) {
+  lastBody.append(content, len);
+  responseBytes += len;
+}
@@ -0,0 +1,421 @@
+// Host harness for [env:native]: runs the real setup()/loop() against the
+// simulated bus and reports poll time, deadline misses, loop latency and web
+// handler cost.
+//
+//   .pio/build/native/program --slaves 8 --latency-us 20000 --crc-pct 2 --duration-s 120
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "NativeClock.h"
+#include "SimBus.h"
+#include "../ModBusHandler.h"
+#include "../SlaveTable.h"
+#include "../MQTTHandler.h"
+#include "../WebServerHandler.h"
+#include "../ResultPublisher.h"
+#include "../OfflineQueue.h"
+#include "../LiveData.h"
+#include "../ConfigJournal.h"
+#include "../Metrics.h"
+#include "../LoopTasks.h"
+#include "../ModbusTcpServer.h"
+#include "../RegisterCache.h"
+#include "../WriteQueue.h"
+#include "../PollScheduler.h"
+#include "../WindowAggregator.h"
+
+void setup();
+void loop();
+
+// Every heap allocation made by the program, so per-poll churn shows up in
+// the report
+static unsigned long heapAllocs = 0;
+
+void* operator new(size_t n) {
+  heapAllocs++;
+  if (void* p = malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+struct NativeOptions {
+  int slaves = 4;
+  int deadSlaves = 0;
+  uint32_t latencyUs = 20000;
+  uint32_t jitterUs = 0;
+  int crcPct = 0;
+  int timeoutPct = 0;
+  uint32_t pollMs = 1000;
+  uint32_t baud = 9600;
+  bool perSlave = false;
+  bool msgpack = false;
+  uint32_t batchCount = 1;
+  uint32_t batchMs = 1000;
+  uint32_t batchBytes = 1024;
+  uint32_t outageStartS = 0;  // broker unreachable from here...
+  uint32_t outageS = 0;       // ...for this long
+  uint32_t durationS = 60;
+  uint32_t webEveryMs = 1000;
+  int eventStreams = 0;       // /events connections held open for the whole run
+  int tcpClients = 0;         // Modbus TCP connections, each reading 2 registers...
+  uint32_t tcpEveryMs = 200;  // ...this often, from the slaves in turn...
+  uint8_t tcpFunction = 3;    // ...with FC03, or FC04 (served by the register cache)
+  uint32_t writesPerS = 0;    // MQTT writes to slave 1 registers 100-101, like a slider being dragged
+  bool fixedRate = false;     // slaves sample on a fixed grid (see PollScheduler)
+  uint32_t windowMs = 0;      // slaves publish summaries over windows this long (see WindowAggregator)
+  uint32_t idleUs = 100;      // fixed cost of one loop() pass outside our code (Wi-Fi stack, yield)
+  double cpuScale = 1.0;      // host CPU time -> device CPU time
+  uint32_t seed = 1;
+};
+
+// Running min/mean/max plus a log2 histogram for percentiles
+struct NativeStat {
+  uint64_t count = 0, sum = 0, min = UINT64_MAX, max = 0;
+  uint64_t buckets[64] = {0};
+
+  void add(uint64_t v) {
+    count++;
+    sum += v;
+    if (v < min) min = v;
+    if (v > max) max = v;
+    int b = 0;
+    while (b < 63 && (1ULL << (b + 1)) <= v) b++;
+    buckets[b]++;
+  }
+  uint64_t percentile(double p) const {
+    uint64_t target = (uint64_t)(count * p), seen = 0;
+    for (int b = 0; b < 64; b++) {
+      seen += buckets[b];
+      if (seen > target) return 1ULL << (b + 1);
+    }
+    return max;
+  }
+  void print(const char* name, const char* unit) const {
+    if (!count) {
+      printf("%-22s n=0\n", name);
+      return;
+    }
+    printf("%-22s n=%-8llu min=%-8llu mean=%-8llu p99<%-8llu max=%llu %s\n", name,
+           (unsigned long long)count, (unsigned long long)min, (unsigned long long)(sum / count),
+           (unsigned long long)percentile(0.99), (unsigned long long)max, unit);
+  }
+};
+
+static bool parseOptions(int argc, char** argv, NativeOptions& o) {
+  for (int i = 1; i < argc; i++) {
+    String a = argv[i];
+    const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (a == "--verbose") { nativeConsoleEcho = true; continue; }
+    if (a == "--per-slave") { o.perSlave = true; continue; }
+    if (a == "--msgpack") { o.msgpack = true; continue; }
+    if (a == "--fixed-rate") { o.fixedRate = true; continue; }
+    if (!v) return false;
+    if (a == "--slaves") o.slaves = atoi(v);
+    else if (a == "--dead") o.deadSlaves = atoi(v);
+    else if (a == "--latency-us") o.latencyUs = atol(v);
+    else if (a == "--jitter-us") o.jitterUs = atol(v);
+    else if (a == "--crc-pct") o.crcPct = atoi(v);
+    else if (a == "--timeout-pct") o.timeoutPct = atoi(v);
+    else if (a == "--poll-ms") o.pollMs = atol(v);
+    else if (a == "--baud") o.baud = atol(v);
+    else if (a == "--duration-s") o.durationS = atol(v);
+    else if (a == "--batch" && v && sscanf(v, "%u:%u:%u", &o.batchCount, &o.batchMs, &o.batchBytes) >= 1) {}
+    else if (a == "--outage-s" && v && sscanf(v, "%u:%u", &o.outageStartS, &o.outageS) == 2) {}
+    else if (a == "--web-every-ms") o.webEveryMs = atol(v);
+    else if (a == "--events") o.eventStreams = atoi(v);
+    else if (a == "--tcp-clients") o.tcpClients = atoi(v);
+    else if (a == "--tcp-every-ms") o.tcpEveryMs = atol(v);
+    else if (a == "--tcp-fc") o.tcpFunction = atoi(v);
+    else if (a == "--writes-per-s") o.writesPerS = atol(v);
+    else if (a == "--window-ms") o.windowMs = atol(v);
+    else if (a == "--idle-us") o.idleUs = atol(v);
+    else if (a == "--cpu-scale") o.cpuScale = atof(v);
+    else if (a == "--seed") o.seed = atol(v);
+    else return false;
+    i++;
+  }
+  return o.slaves > 0 && o.slaves <= 247;
+}
+
+// A Modbus TCP master on the other end of a socket
+struct NativeTcpClient {
+  std::shared_ptr<NativeSocket> socket;
+  uint16_t nextTid = 1;
+  uint64_t nextSendMicros = 0;
+  size_t parsed = 0;
+  std::vector<std::pair<uint16_t, uint64_t>> outstanding;  // transaction ID, sent at
+};
+
+struct NativeTcpTotals {
+  unsigned long sent = 0, replies = 0, exceptions = 0, busy = 0, lost = 0;
+  NativeStat latencyMs;
+};
+
+static void runTcpClient(NativeTcpClient& c, int index, const NativeOptions& o, NativeTcpTotals& t) {
+  if (nativeNowMicros >= c.nextSendMicros) {
+    uint16_t tid = c.nextTid++;
+    uint8_t unit = (tid + index) % o.slaves + 1;
+    uint8_t frame[12] = {(uint8_t)(tid >> 8), (uint8_t)tid, 0, 0, 0, 6, unit, o.tcpFunction, 0, 0, 0, 2};
+    c.socket->rx.append((const char*)frame, sizeof(frame));
+    c.outstanding.push_back({tid, nativeNowMicros});
+    c.nextSendMicros = nativeNowMicros + (uint64_t)o.tcpEveryMs * 1000;
+    t.sent++;
+  }
+  const std::string& tx = c.socket->tx;
+  while (tx.size() - c.parsed >= 9) {
+    const uint8_t* f = (const uint8_t*)tx.data() + c.parsed;
+    size_t length = 6 + ((f[4] << 8) | f[5]);
+    if (tx.size() - c.parsed < length) break;
+    uint16_t tid = (f[0] << 8) | f[1];
+    auto it = c.outstanding.begin();
+    while (it != c.outstanding.end() && it->first != tid) it++;
+    if (it != c.outstanding.end()) {
+      t.latencyMs.add((nativeNowMicros - it->second) / 1000);
+      c.outstanding.erase(it);
+    }
+    if (f[7] & 0x80) {
+      t.exceptions++;
+      if (f[8] == MODBUS_EX_SERVER_BUSY) t.busy++;
+    } else {
+      t.replies++;
+    }
+    c.parsed += length;
+  }
+}
+
+static uint64_t hostNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One loop() pass; returns host nanoseconds spent inside it
+static uint64_t runLoopPass(const NativeOptions& o) {
+  uint64_t t0 = hostNanos();
+  loop();
+  uint64_t ns = hostNanos() - t0;
+  nativeClockAdvance(o.idleUs + (uint64_t)(ns * o.cpuScale / 1000));
+  return ns;
+}
+
+#ifndef PIO_UNIT_TESTING  // test/ brings its own main()
+int main(int argc, char** argv) {
+  NativeOptions o;
+  if (!parseOptions(argc, argv, o)) {
+    fprintf(stderr, "usage: %s [--slaves N] [--dead N] [--latency-us U] [--jitter-us U] [--crc-pct P]\n"
+                    "          [--timeout-pct P] [--poll-ms M] [--baud B] [--duration-s S] [--web-every-ms M] [--idle-us U]\n"
+                    "          [--cpu-scale X] [--seed N] [--per-slave] [--msgpack] [--batch N[:MS[:BYTES]]]\n"
+                    "          [--outage-s START:LEN] [--events N] [--tcp-clients N] [--tcp-every-ms M] [--tcp-fc 3|4]\n"
+                    "          [--writes-per-s N] [--fixed-rate] [--window-ms M] [--verbose]\n",
+            argv[0]);
+    return 2;
+  }
+
+  // Start from an empty flash image so the configuration of an earlier run is ignored
+  LittleFS.begin();
+  LittleFS.remove(LEGACY_CONFIG_PATH);
+  LittleFS.remove(JOURNAL_PATH);
+  LittleFS.remove(JOURNAL_TMP_PATH);
+  queueClear();
+
+  simBusReset(o.seed);
+  for (int i = 0; i < o.slaves; i++) {
+    SimSlave* s = simBusAddSlave(i + 1);
+    s->latencyMicros = o.latencyUs;
+    s->jitterMicros = o.jitterUs;
+    s->crcErrorPercent = o.crcPct;
+    s->timeoutPercent = o.timeoutPct;
+    s->online = i >= o.deadSlaves;
+  }
+
+  setup();
+
+  // Configure the gateway the same way an operator would, through HTTP
+  if (o.perSlave || o.msgpack || o.batchCount > 1) {
+    String body = String("{\"perSlave\":") + (o.perSlave ? "true" : "false") + ",\"prefix\":\"sim\",\"format\":\"" +
+                  (o.msgpack ? "msgpack" : "json") + "\",\"batchCount\":" + String((unsigned long)o.batchCount) +
+                  ",\"batchMs\":" + String((unsigned long)o.batchMs) + ",\"batchBytes\":" +
+                  String((unsigned long)o.batchBytes) + "}";
+    server.nativeRequest(HTTP_POST, "/publish", body);
+    runLoopPass(o);
+    if (server.lastCode != 200) {
+      fprintf(stderr, "publish settings rejected: %s\n", server.lastBody.c_str());
+      return 2;
+    }
+  }
+  server.nativeRequest(HTTP_POST, "/bus", "{\"baud\":" + String((unsigned long)o.baud) + "}");
+  runLoopPass(o);
+  if (server.lastCode != 200) {
+    fprintf(stderr, "bus settings rejected: %s\n", server.lastBody.c_str());
+    return 2;
+  }
+  for (int i = 0; i < o.slaves; i++) {
+    String body = "{\"id\":" + String(i + 1) + ",\"startReg\":0,\"numRegs\":2,\"pollMs\":" +
+                  String((unsigned long)o.pollMs) + ",\"name\":\"sim" + String(i + 1) + "\"" +
+                  (o.fixedRate ? ",\"fixedRate\":true" : "") +
+                  (o.windowMs ? ",\"windowMs\":" + String((unsigned long)o.windowMs) : String("")) + "}";
+    server.nativeRequest(HTTP_POST, "/addSlave", body);
+    runLoopPass(o);
+  }
+  for (int i = 0; i < o.eventStreams; i++) {
+    server.nativeRequest(HTTP_GET, "/events");
+    runLoopPass(o);
+  }
+
+  std::vector<NativeTcpClient> tcpClients(o.tcpClients);
+  for (auto& c : tcpClients) c.socket = modbusTcpServer.nativeConnect();
+  NativeTcpTotals tcpTotals;
+
+  NativeStat pollMs, loopNs, loopStallUs, webNs;
+  unsigned long pollAllocs = 0, pollPasses = 0;
+  uint64_t startMicros = nativeNowMicros;
+  uint64_t endMicros = startMicros + (uint64_t)o.durationS * 1000000;
+  uint64_t nextWebMicros = startMicros;
+  uint64_t nextWriteMicros = startMicros;
+  uint16_t sliderValue = 0;
+  uint64_t busStart = simBusStats.busyMicros;
+
+  uint64_t outageStart = startMicros + (uint64_t)o.outageStartS * 1000000;
+  uint64_t outageEnd = outageStart + (uint64_t)o.outageS * 1000000;
+  uint32_t maxQueueBytes = 0;
+  String pageEtag;  // like a browser: revalidate the cached page after the first load
+
+  while (nativeNowMicros < endMicros) {
+    mqttClient.nativeBrokerUp = !(o.outageS && nativeNowMicros >= outageStart && nativeNowMicros < outageEnd);
+    if (o.webEveryMs && nativeNowMicros >= nextWebMicros) {
+      if (pageEtag.length()) server.nativeRequest(HTTP_GET, "/", String(), {{"If-None-Match", pageEtag}});
+      else server.nativeRequest(HTTP_GET, "/");
+      server.nativeRequest(HTTP_GET, "/slaves");
+      server.nativeRequest(HTTP_GET, "/data");
+      nextWebMicros += (uint64_t)o.webEveryMs * 1000;
+    }
+
+    for (size_t i = 0; i < tcpClients.size(); i++) runTcpClient(tcpClients[i], i, o, tcpTotals);
+    if (o.writesPerS && nativeNowMicros >= nextWriteMicros) {
+      // The second register moves against the first, so both land in one FC16
+      char topic[MAX_TOPIC_PREFIX + 8], payload[64];
+      snprintf(topic, sizeof(topic), "%s/write", publishConfig.prefix);
+      sliderValue = (sliderValue + 1) % 1000;
+      int length = snprintf(payload, sizeof(payload), "{\"id\":1,\"register\":100,\"values\":[%u,%u]}", sliderValue,
+                            1000 - sliderValue);
+      mqttClient.nativeDeliver(topic, (const uint8_t*)payload, length);
+      nextWriteMicros += 1000000 / o.writesPerS;
+    }
+
+    QueryState before = queryState;
+    unsigned long requestsBefore = server.requestCount;
+    uint64_t virtualBefore = nativeNowMicros;
+    unsigned long allocsBefore = heapAllocs;
+    uint64_t ns = runLoopPass(o);
+
+    loopNs.add(ns);
+    loopStallUs.add(nativeNowMicros - virtualBefore);
+    if (server.requestCount != requestsBefore) {
+      webNs.add(ns);
+      for (auto& h : server.lastHeaders) if (h.first == "ETag") pageEtag = h.second;
+    }
+    if (before == Q_QUERYING && queryState == Q_IDLE) {
+      pollMs.add(millis() - queryStartTime);
+    }
+    maxQueueBytes = max(maxQueueBytes, queueBytes());
+    // Web passes allocate by design; everything else is the polling path
+    if (server.requestCount == requestsBefore) {
+      pollAllocs += heapAllocs - allocsBefore;
+      pollPasses++;
+    }
+  }
+
+  uint64_t elapsed = nativeNowMicros - startMicros;
+  server.nativeRequest(HTTP_GET, "/metrics");
+  runLoopPass(o);
+  String metrics = server.lastBody;
+  printf("== native run: %d slaves (%d dead) every %lu ms at %lu baud, %lu us latency, %d%% crc, %d%% timeout, %lu s ==\n",
+         o.slaves, o.deadSlaves, (unsigned long)o.pollMs, (unsigned long)o.baud, (unsigned long)o.latencyUs, o.crcPct, o.timeoutPct,
+         (unsigned long)o.durationS);
+  unsigned long polls = 0, misses = 0, maxLate = 0;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    const SlaveSchedule& schedule = slaveSchedule(slaves[i]);
+    polls += schedule.pollCount;
+    misses += schedule.deadlineMisses;
+    maxLate = max(maxLate, (unsigned long)schedule.maxLateMs);
+  }
+  pollMs.print("slave poll time", "ms");
+  printf("%-22s %lu polls, %lu deadline misses, max %lu ms late\n", "schedule", polls, misses, maxLate);
+  uint64_t jitterSum = 0;
+  unsigned long maxJitter = 0, jitterSamples = 0, skipped = 0;
+  for (uint8_t i = 0; i < slaveCount; i++) {
+    jitterSum += slaveJitterMicros(slaves[i]);
+    maxJitter = max(maxJitter, (unsigned long)slaveSampling(slaves[i]).maxJitterUs);
+    jitterSamples += slaveSampling(slaves[i]).jitterSamples;
+    skipped += slaveSchedule(slaves[i]).skippedPolls;
+  }
+  printf("%-22s mean %lu us, max %lu us over %lu spacings, %lu fixed-rate periods skipped\n", "sample jitter",
+         slaveCount ? (unsigned long)(jitterSum / slaveCount) : 0UL, maxJitter, jitterSamples, skipped);
+  loopNs.print("loop() host cost", "ns");
+  loopStallUs.print("loop() virtual time", "us");
+  webNs.print("web pass host cost", "ns");
+  printf("%-22s %lu requests, %lu response bytes\n", "web", server.requestCount, server.responseBytes);
+  printf("%-22s %.1f %%\n", "bus utilisation", 100.0 * (simBusStats.busyMicros - busStart) / elapsed);
+  printf("%-22s %u bytes, bus %u %% (last window), transaction p95<%lu us, loop max %lu us\n", "/metrics",
+         metrics.length(), busUtilisationPercent(), (unsigned long)histogramPercentile(transactionHist, 95),
+         (unsigned long)loopHist.maxMicros);
+  // Only delay() moves the virtual clock inside a pass, so these flag blocking calls
+  unsigned long overruns = 0, deferrals = 0;
+  for (uint8_t i = 0; i < loopTaskCount; i++) {
+    overruns += loopTasks[i].overruns;
+    deferrals += loopTasks[i].deferrals;
+  }
+  printf("%-22s %u tasks, %lu overruns, %lu deferrals\n", "loop tasks", loopTaskCount, overruns, deferrals);
+  printf("%-22s req=%lu reply=%lu crcInj=%lu toInj=%lu unanswered=%lu lostRx=%lu lostTx=%lu\n", "bus frames",
+         simBusStats.requestFrames, simBusStats.replyFrames, simBusStats.crcErrorsInjected,
+         simBusStats.timeoutsInjected, simBusStats.unansweredFrames, simBusStats.lostReplyBytes,
+         simBusStats.lostTxBytes);
+  printf("%-22s %lu publishes, %lu bytes, %lu dropped, %lu reports suppressed\n", "mqtt",
+         mqttClient.publishCount, mqttClient.publishBytes, mqttClient.droppedCount,
+         (unsigned long)reportsSuppressed);
+  if (o.eventStreams) {
+    printf("%-22s %u streams: %lu events, %lu bytes, %lu dropped as slow\n", "events", eventClientCount(),
+           (unsigned long)eventStats.events, (unsigned long)eventStats.bytes, (unsigned long)eventStats.slowClients);
+  }
+  if (o.tcpClients) {
+    for (auto& c : tcpClients) tcpTotals.lost += c.outstanding.size();
+    printf("%-22s %d clients: %lu sent, %lu replies, %lu exceptions (%lu busy), %lu unanswered at the end\n",
+           "modbus tcp", o.tcpClients, tcpTotals.sent, tcpTotals.replies, tcpTotals.exceptions, tcpTotals.busy,
+           tcpTotals.lost);
+    tcpTotals.latencyMs.print("modbus tcp latency", "ms");
+    printf("%-22s %lu answered from cache, %lu hits, %lu misses, %lu refresh reads (%lu failed)\n", "register cache",
+           (unsigned long)modbusTcpStats.cached, (unsigned long)cacheStats.hits, (unsigned long)cacheStats.misses,
+           (unsigned long)cacheStats.fetches, (unsigned long)cacheStats.failures);
+  }
+  if (o.writesPerS) {
+    printf("%-22s %lu requests: %lu ok, %lu superseded, %lu mismatch, %lu unverified, %lu failed; %lu bus writes "
+           "carrying %lu values, latency p50<%lu p95<%lu max %lu us\n",
+           "writes", (unsigned long)writeStats.requests, (unsigned long)writeStats.outcomes[WRITE_OK],
+           (unsigned long)writeStats.outcomes[WRITE_SUPERSEDED], (unsigned long)writeStats.outcomes[WRITE_MISMATCH],
+           (unsigned long)writeStats.outcomes[WRITE_UNVERIFIED], (unsigned long)writeStats.outcomes[WRITE_FAILED],
+           (unsigned long)writeStats.transactions, (unsigned long)writeStats.values,
+           (unsigned long)histogramPercentile(writeHist, 50), (unsigned long)histogramPercentile(writeHist, 95),
+           (unsigned long)writeHist.maxMicros);
+  }
+  if (o.windowMs) {
+    printf("%-22s %lu polls folded into %lu summaries, %lu queued, %lu dropped\n", "summary windows",
+           (unsigned long)windowStats.samples, (unsigned long)windowStats.published, (unsigned long)windowStats.queued,
+           (unsigned long)windowStats.dropped);
+  }
+  if (o.outageS) {
+    printf("%-22s %lu s outage: %lu queued, %lu replayed, %lu left, %lu dropped, peak %lu bytes\n", "offline queue",
+           (unsigned long)o.outageS, (unsigned long)queueStats.queued, (unsigned long)queueStats.replayed,
+           (unsigned long)(queueStats.queued - queueStats.replayed), (unsigned long)queueStats.dropped,
+           (unsigned long)maxQueueBytes);
+    printf("%-22s %lu page appends, %lu bytes\n", "queue flash", (unsigned long)queueStats.flashWrites,
+           (unsigned long)queueStats.flashBytes);
+  }
+  printf("%-22s %lu allocations in %lu non-web loop() passes (%.2f per poll)\n", "heap", pollAllocs, pollPasses,
+         pollMs.count ? (double)pollAllocs / pollMs.count : 0.0);
+  printf("%-22s %lu bytes written to Serial (bus), %lu to Serial1 (log)\n", "console", Serial.bytesWritten,
+         Serial1.bytesWritten);
+  return 0;
+}
+#endif
@@ -0,0 +1,269 @@
+#include "SimBus.h"
+#include "NativeClock.h"
+#include <map>
+#include <string.h>
+#include <utility>
+
+SimBusStats simBusStats;
+
+static std::map<uint8_t, SimSlave> simSlaves;
+static uint32_t simCharMicros = 1042;   // 10-bit character at 9600 baud
+static uint32_t simT35Micros = 3646;
+static bool simTransmitting = false;
+static uint64_t simLineFreeAt = 0;      // end of the last frame on the wire
+static uint64_t simTxEndAt = 0;         // when the master's last byte leaves the UART
+static uint32_t simRandState = 1;
+
+// Reply bytes with the virtual time they finish arriving at the master. A
+// fixed ring (no allocation) so the harness's heap count is the gateway's own.
+struct SimRxQueue {
+  std::pair<uint64_t, uint8_t> items[1024];
+  size_t head = 0, count = 0;
+
+  bool empty() const { return count == 0; }
+  size_t size() const { return count; }
+  const std::pair<uint64_t, uint8_t>& at(size_t i) const { return items[(head + i) % 1024]; }
+  const std::pair<uint64_t, uint8_t>& front() const { return at(0); }
+  void pop_front() { head = (head + 1) % 1024; count--; }
+  void push_back(const std::pair<uint64_t, uint8_t>& v) {
+    if (count < 1024) items[(head + count++) % 1024] = v;
+  }
+  void clear() { head = count = 0; }
+};
+static SimRxQueue simRx;
+
+static uint32_t simRandom() {
+  simRandState = simRandState * 1103515245u + 12345u;
+  return (simRandState >> 16) & 0x7FFF;
+}
+
+static uint16_t simCrc(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+  }
+  return crc;
+}
+
+void simBusReset(uint32_t seed) {
+  simSlaves.clear();
+  simRx.clear();
+  simBusStats = SimBusStats();
+  simRandState = seed ? seed : 1;
+  simLineFreeAt = 0;
+  simTxEndAt = 0;
+}
+
+SimSlave* simBusAddSlave(uint8_t id) {
+  SimSlave& s = simSlaves[id];
+  s.id = id;
+  return &s;
+}
+
+SimSlave* simBusSlave(uint8_t id) {
+  auto it = simSlaves.find(id);
+  return it == simSlaves.end() ? nullptr : &it->second;
+}
+
+// Default register pattern: a slowly drifting temperature/humidity pair
+// followed by values that encode slave and address
+uint16_t simBusRegister(uint8_t id, uint16_t addr) {
+  SimSlave* s = simBusSlave(id);
+  if (s) {
+    auto it = s->registers.find(addr);
+    if (it != s->registers.end()) return it->second;
+  }
+  uint32_t seconds = (uint32_t)(nativeNowMicros / 1000000);
+  if (addr == 0) return 200 + id + (seconds / 10) % 50;   // 20.0 °C upward
+  if (addr == 1) return 500 + (seconds / 30) % 100;       // 50.0 %RH upward
+  return (uint16_t)(id * 1000 + addr);
+}
+
+void simBusBegin(uint32_t baud, uint8_t config) {
+  // Bit 5 of the ESP8266 config byte selects two stop bits, bit 1 parity
+  uint8_t bits = 1 + 8 + ((config & 0x02) ? 1 : 0) + ((config & 0x20) ? 2 : 1);
+  simCharMicros = (bits * 1000000UL + baud - 1) / baud;
+  simT35Micros = baud > 19200 ? 1750 : (simCharMicros * 7) / 2;
+  simRx.clear();
+}
+
+void simBusSetTransmit(bool transmit) {
+  if (simTransmitting && !transmit) {
+    // RE is tied to DE: anything that arrived before release never reached RX
+    while (!simRx.empty() && simRx.front().first <= nativeNowMicros) {
+      simRx.pop_front();
+      simBusStats.lostReplyBytes++;
+    }
+  }
+  simTransmitting = transmit;
+}
+
+static void simQueueReply(SimSlave& slave, uint8_t* reply, size_t len, uint64_t requestEnd) {
+  uint16_t crc = simCrc(reply, len);
+  reply[len++] = crc & 0xFF;
+  reply[len++] = crc >> 8;
+  if (slave.crcErrorPercent && simRandom() % 100 < slave.crcErrorPercent) {
+    reply[len - 1] ^= 0x5A;
+    simBusStats.crcErrorsInjected++;
+  }
+
+  uint64_t start = requestEnd + simT35Micros + slave.latencyMicros;
+  if (slave.jitterMicros) start += simRandom() % (slave.jitterMicros + 1);
+  if (start < simLineFreeAt) start = simLineFreeAt;
+  for (size_t i = 0; i < len; i++) {
+    simRx.push_back({start + (i + 1) * simCharMicros, reply[i]});
+  }
+  simLineFreeAt = start + len * simCharMicros;
+  simBusStats.busyMicros += len * simCharMicros;
+  simBusStats.replyFrames++;
+  slave.replies++;
+}
+
+static void simException(SimSlave& slave, uint8_t* reply, uint8_t code, uint64_t requestEnd) {
+  reply[1] |= 0x80;
+  reply[2] = code;
+  simQueueReply(slave, reply, 3, requestEnd);
+}
+
+static void simHandleRequest(const uint8_t* req, size_t len, uint64_t requestEnd) {
+  simBusStats.requestFrames++;
+  if (len < 4 || simCrc(req, len) != 0) {
+    simBusStats.malformedFrames++;
+    return;
+  }
+  SimSlave* slave = simBusSlave(req[0]);
+  if (!slave || !slave->online) {
+    simBusStats.unansweredFrames++;
+    return;
+  }
+  slave->requests++;
+  if (slave->timeoutPercent && simRandom() % 100 < slave->timeoutPercent) {
+    simBusStats.timeoutsInjected++;
+    return;
+  }
+
+  uint8_t reply[260];
+  uint8_t fc = req[1];
+  reply[0] = slave->id;
+  reply[1] = fc;
+
+  if ((fc == 0x03 || fc == 0x04) && len == 8) {
+    uint16_t start = (req[2] << 8) | req[3];
+    uint16_t count = (req[4] << 8) | req[5];
+    if (count == 0 || count > 125) {
+      simException(*slave, reply, 0x03, requestEnd);
+      return;
+    }
+    if ((uint32_t)start + count > slave->registerLimit) {
+      simException(*slave, reply, 0x02, requestEnd);
+      return;
+    }
+    reply[2] = count * 2;
+    for (uint16_t i = 0; i < count; i++) {
+      uint16_t v = simBusRegister(slave->id, start + i);
+      reply[3 + i * 2] = v >> 8;
+      reply[4 + i * 2] = v & 0xFF;
+    }
+    simQueueReply(*slave, reply, 3 + count * 2, requestEnd);
+    return;
+  }
+
+  if (fc == 0x01 && len == 8) {
+    uint16_t start = (req[2] << 8) | req[3];
+    uint16_t count = (req[4] << 8) | req[5];
+    if (count == 0 || count > 2000) {
+      simException(*slave, reply, 0x03, requestEnd);
+      return;
+    }
+    if ((uint32_t)start + count > slave->registerLimit) {
+      simException(*slave, reply, 0x02, requestEnd);
+      return;
+    }
+    reply[2] = (count + 7) / 8;
+    memset(reply + 3, 0, reply[2]);
+    for (uint16_t i = 0; i < count; i++) {
+      auto it = slave->coils.find(start + i);
+      if (it != slave->coils.end() && it->second) reply[3 + i / 8] |= 1 << (i % 8);
+    }
+    simQueueReply(*slave, reply, 3 + reply[2], requestEnd);
+    return;
+  }
+
+  // Writes: single coil/register (length 8) or multiple (9 + byte count)
+  if (fc == 0x05 || fc == 0x06 || fc == 0x0F || fc == 0x10) {
+    bool single = fc == 0x05 || fc == 0x06;
+    if (len < 8 || (!single && (len < 9 || len != 9 + (size_t)req[6]))) {
+      simException(*slave, reply, 0x03, requestEnd);
+      return;
+    }
+    uint16_t start = (req[2] << 8) | req[3];
+    uint16_t count = single ? 1 : (req[4] << 8) | req[5];
+    if (fc == 0x05 && req[4] != 0x00 && req[4] != 0xFF) {
+      simException(*slave, reply, 0x03, requestEnd);
+      return;
+    }
+    if (count == 0 || (fc == 0x0F && req[6] != (count + 7) / 8) || (fc == 0x10 && req[6] != count * 2)) {
+      simException(*slave, reply, 0x03, requestEnd);
+      return;
+    }
+    if ((uint32_t)start + count > slave->registerLimit) {
+      simException(*slave, reply, 0x02, requestEnd);
+      return;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+      if (fc == 0x05) {
+        slave->coils[start] = req[4] == 0xFF;
+      } else if (fc == 0x0F) {
+        slave->coils[start + i] = (req[7 + i / 8] >> (i % 8)) & 1;
+      } else {
+        uint16_t v = fc == 0x06 ? (req[4] << 8) | req[5] : (req[7 + i * 2] << 8) | req[8 + i * 2];
+        slave->registers[start + i] = v > slave->writeClamp ? slave->writeClamp : v;
+      }
+    }
+    slave->writes++;
+    memcpy(reply + 2, req + 2, 4);  // echo of address and value or quantity
+    simQueueReply(*slave, reply, 6, requestEnd);
+    return;
+  }
+
+  simException(*slave, reply, 0x01, requestEnd);
+}
+
+size_t simBusWrite(const uint8_t* data, size_t len) {
+  if (!simTransmitting) {
+    simBusStats.lostTxBytes += len;
+    return len;
+  }
+  uint64_t start = nativeNowMicros > simLineFreeAt ? nativeNowMicros : simLineFreeAt;
+  uint64_t end = start + len * simCharMicros;
+  simLineFreeAt = end;
+  simTxEndAt = end;
+  simBusStats.busyMicros += len * simCharMicros;
+  simHandleRequest(data, len, end);
+  return len;
+}
+
+// Characters still waiting behind the one in the shift register
+int simBusTxQueued() {
+  if (simTxEndAt <= nativeNowMicros) return 0;
+  uint64_t left = (simTxEndAt - nativeNowMicros + simCharMicros - 1) / simCharMicros;
+  return (int)(left - 1);
+}
+
+int simBusAvailable() {
+  if (simTransmitting) return 0;
+  int n = 0;
+  for (size_t i = 0; i < simRx.size(); i++) {
+    if (simRx.at(i).first > nativeNowMicros) break;
+    n++;
+  }
+  return n;
+}
+
+int simBusRead() {
+  if (simTransmitting || simRx.empty() || simRx.front().first > nativeNowMicros) return -1;
+  uint8_t b = simRx.front().second;
+  simRx.pop_front();
+  return b;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+
+// Simulated RS485 segment with any number of Modbus RTU slaves. Bytes travel
+// at the configured baud rate on the virtual clock; each slave can add
+// turnaround latency, corrupt its CRC or stay silent.
+
+struct SimSlave {
+  uint8_t id = 0;
+  bool online = true;
+  uint32_t latencyMicros = 5000;     // turnaround after the request's t3.5
+  uint32_t jitterMicros = 0;         // extra random latency, 0..jitter
+  uint8_t crcErrorPercent = 0;       // replies sent with a corrupted CRC
+  uint8_t timeoutPercent = 0;        // requests silently ignored
+  uint16_t registerLimit = 10000;    // first illegal address (exception 02)
+  std::map<uint16_t, uint16_t> registers;  // overrides the default pattern; FC06/FC16 write here
+  std::map<uint16_t, bool> coils;          // FC05/FC15 write here, FC01 reads (default off)
+  uint16_t writeClamp = 0xFFFF;      // written register values above this are stored as this
+
+  unsigned long requests = 0;
+  unsigned long replies = 0;
+  unsigned long writes = 0;          // write requests carried out
+};
+
+struct SimBusStats {
+  unsigned long requestFrames = 0;
+  unsigned long replyFrames = 0;
+  unsigned long crcErrorsInjected = 0;
+  unsigned long timeoutsInjected = 0;
+  unsigned long unansweredFrames = 0;   // no such slave / offline
+  unsigned long malformedFrames = 0;    // bad CRC or truncated request
+  unsigned long lostReplyBytes = 0;     // arrived while DE was still high
+  unsigned long lostTxBytes = 0;        // written while DE was low
+  uint64_t busyMicros = 0;              // time the line carried a frame
+};
+
+extern SimBusStats simBusStats;
+
+void simBusReset(uint32_t seed);
+SimSlave* simBusAddSlave(uint8_t id);
+SimSlave* simBusSlave(uint8_t id);
+uint16_t simBusRegister(uint8_t id, uint16_t addr);
+
+// Master side, used by HalNative.cpp
+void simBusBegin(uint32_t baud, uint8_t config);
+void simBusSetTransmit(bool transmit);
+size_t simBusWrite(const uint8_t* data, size_t len);
+int simBusTxQueued();
+int simBusAvailable();
+int simBusRead();
@@ -0,0 +1,358 @@
+// Benchmark suite for [env:bench]: the real polling, encoding, web and config
+// code against the simulated bus. Results go to stdout as one JSON document,
+// progress to stderr.
+//
+//   pio run -e bench && .pio/build/bench/program > bench.json
+//   python tools/bench_compare.py baseline.json bench.json
+//
+// Poll results run on the virtual clock only (every loop() pass advances it
+// by a fixed 100 us), so they are deterministic for a given seed and compare
+// across machines. CPU results are host nanoseconds (median of --repeat runs)
+// and only compare on the same machine.
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../NativeClock.h"
+#include "../SimBus.h"
+#include "../../ModBusHandler.h"
+#include "../../MQTTHandler.h"
+#include "../../WebServerHandler.h"
+#include "../../SlaveTable.h"
+#include "../../ResultEncoder.h"
+#include "../../ConfigJournal.h"
+#include "../../WebUi.h"
+
+void setup();
+void loop();
+
+#define BENCH_SCHEMA_VERSION 1
+#define BENCH_LOOP_PASS_US 100   // virtual time per loop() pass
+#define BENCH_WARMUP_S 2
+
+struct BenchOptions {
+  std::vector<int> slaveCounts = {1, 8, 32, 128, 247};
+  uint32_t latencyUs = 20000;
+  uint32_t jitterUs = 0;
+  int crcPct = 0;
+  int timeoutPct = 0;
+  int deadSlaves = 0;
+  uint32_t baud = 9600;
+  uint32_t durationS = 20;   // virtual seconds per poll scenario
+  int repeats = 5;
+  uint32_t seed = 1;
+  std::string only;          // run just this group: poll, encode, web or config
+};
+
+static std::vector<std::string> results;
+
+static uint64_t hostNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& o) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string a = argv[i];
+    const char* v = argv[i + 1];
+    if (a == "--slaves") {
+      o.slaveCounts.clear();
+      for (const char* p = v; *p; p++) {
+        o.slaveCounts.push_back(atoi(p));
+        while (p[1] && *p != ',') p++;
+      }
+    }
+    else if (a == "--latency-us") o.latencyUs = atol(v);
+    else if (a == "--jitter-us") o.jitterUs = atol(v);
+    else if (a == "--crc-pct") o.crcPct = atoi(v);
+    else if (a == "--timeout-pct") o.timeoutPct = atoi(v);
+    else if (a == "--dead") o.deadSlaves = atoi(v);
+    else if (a == "--baud") o.baud = atol(v);
+    else if (a == "--duration-s") o.durationS = atol(v);
+    else if (a == "--repeat") o.repeats = atoi(v);
+    else if (a == "--seed") o.seed = atol(v);
+    else if (a == "--only") o.only = v;
+    else return false;
+  }
+  if (argc % 2 == 0) return false;
+  for (int n : o.slaveCounts) {
+    if (n < 1 || n > MAX_SLAVES) return false;
+  }
+  return !o.slaveCounts.empty() && o.repeats > 0 && o.durationS > 0;
+}
+
+// ----------------- Helpers -----------------
+
+static void addResult(const char* name, const std::string& params, const std::string& metrics) {
+  results.push_back(std::string("{\"name\":\"") + name + "\",\"params\":{" + params + "},\"metrics\":{" + metrics + "}}");
+}
+
+static std::string field(const char* key, double value, const char* format = "%.3f") {
+  char text[64];
+  int n = snprintf(text, sizeof(text), "\"%s\":", key);
+  snprintf(text + n, sizeof(text) - n, format, value);
+  return text;
+}
+
+static std::string join(std::initializer_list<std::string> parts) {
+  std::string out;
+  for (const std::string& p : parts) out += (out.empty() ? "" : ",") + p;
+  return out;
+}
+
+// Median host time of one call, over repeats x iterations
+template <typename F>
+static double nsPerOp(const BenchOptions& o, uint32_t iterations, F&& body) {
+  std::vector<double> runs;
+  for (int r = 0; r < o.repeats; r++) {
+    uint64_t t0 = hostNanos();
+    for (uint32_t i = 0; i < iterations; i++) body();
+    runs.push_back((double)(hostNanos() - t0) / iterations);
+  }
+  std::sort(runs.begin(), runs.end());
+  return runs[runs.size() / 2];
+}
+
+static void request(HTTPMethod method, const char* uri, const String& body = String(),
+                    const std::vector<std::pair<String, String>>& headers = {}) {
+  server.nativeRequest(method, uri, body, headers);
+  server.handleClient();
+}
+
+// N simulated devices and the matching slave table, configured like an operator would
+static void configureSlaves(const BenchOptions& o, int count, bool simulate) {
+  clearSlaves();
+  if (simulate) simBusReset(o.seed);
+  for (int i = 0; i < count; i++) {
+    if (simulate) {
+      SimSlave* s = simBusAddSlave(i + 1);
+      s->latencyMicros = o.latencyUs;
+      s->jitterMicros = o.jitterUs;
+      s->crcErrorPercent = o.crcPct;
+      s->timeoutPercent = o.timeoutPct;
+      s->online = i >= o.deadSlaves;
+    }
+    String body = "{\"id\":" + String(i + 1) + ",\"name\":\"bench" + String(i + 1) +
+                  "\",\"startReg\":0,\"numRegs\":2,\"deadband\":2}";
+    request(HTTP_POST, "/addSlave", body);
+  }
+}
+
+static void runFor(uint64_t micros) {
+  uint64_t end = nativeNowMicros + micros;
+  while (nativeNowMicros < end) {
+    loop();
+    nativeClockAdvance(BENCH_LOOP_PASS_US);
+  }
+}
+
+// ----------------- Polling -----------------
+
+// Saturated bus: every slave is always due, so the scheduler never idles and
+// polls/s is the bus capacity at these settings
+static void benchPolling(const BenchOptions& o) {
+  for (int count : o.slaveCounts) {
+    fprintf(stderr, "poll: %d slaves\n", count);
+    configureSlaves(o, count, true);
+    for (uint8_t i = 0; i < slaveCount; i++) slaves[i].pollMs = 1;
+    runFor((uint64_t)BENCH_WARMUP_S * 1000000);
+
+    uint32_t pollsBefore = 0;
+    for (uint8_t i = 0; i < slaveCount; i++) pollsBefore += slaveSchedule(slaves[i]).pollCount;
+    uint64_t start = nativeNowMicros;
+    uint64_t heldBefore = rtuBusyMicros();
+    uint64_t wireBefore = simBusStats.busyMicros;
+    unsigned long repliesBefore = simBusStats.replyFrames;
+    unsigned long requestsBefore = simBusStats.requestFrames;
+    std::vector<uint32_t> pollTimes;
+
+    uint64_t end = start + (uint64_t)o.durationS * 1000000;
+    while (nativeNowMicros < end) {
+      QueryState before = queryState;
+      loop();
+      nativeClockAdvance(BENCH_LOOP_PASS_US);
+      if (before == Q_QUERYING && queryState == Q_IDLE) pollTimes.push_back(millis() - queryStartTime);
+    }
+
+    double seconds = (nativeNowMicros - start) / 1e6;
+    uint32_t polls = 0;
+    for (uint8_t i = 0; i < slaveCount; i++) polls += slaveSchedule(slaves[i]).pollCount;
+    polls -= pollsBefore;
+    std::sort(pollTimes.begin(), pollTimes.end());
+    uint32_t p50 = pollTimes.empty() ? 0 : pollTimes[pollTimes.size() / 2];
+    uint32_t p95 = pollTimes.empty() ? 0 : pollTimes[pollTimes.size() * 95 / 100];
+    unsigned long requests = simBusStats.requestFrames - requestsBefore;
+    unsigned long replies = simBusStats.replyFrames - repliesBefore;
+
+    std::string params = join({field("slaves", count, "%.0f"), field("latencyUs", o.latencyUs, "%.0f"),
+                               field("jitterUs", o.jitterUs, "%.0f"), field("crcPct", o.crcPct, "%.0f"),
+                               field("timeoutPct", o.timeoutPct, "%.0f"), field("dead", o.deadSlaves, "%.0f"),
+                               field("baud", o.baud, "%.0f")});
+    addResult("poll", params,
+              join({field("pollsPerSec", polls / seconds), field("cyclesPerSec", polls / seconds / count),
+                    field("busHeldPct", 100.0 * (rtuBusyMicros() - heldBefore) / (seconds * 1e6), "%.1f"),
+                    field("busWirePct", 100.0 * (simBusStats.busyMicros - wireBefore) / (seconds * 1e6), "%.1f"),
+                    field("replyPct", requests ? 100.0 * replies / requests : 0, "%.1f"),
+                    field("pollP50Ms", p50, "%.0f"), field("pollP95Ms", p95, "%.0f")}));
+  }
+}
+
+// ----------------- Encoding -----------------
+
+// One finished poll into a payload: what every poll costs before it's published
+static void benchEncoding(const BenchOptions& o) {
+  fprintf(stderr, "encode\n");
+  configureSlaves(o, 1, false);
+  // A second slave with a 16-field register map over 32 registers
+  String fields = "[";
+  for (int f = 0; f < 16; f++) {
+    if (f) fields += ",";
+    fields += "{\"name\":\"v" + String(f) + "\",\"reg\":" + String(f * 2) + ",\"type\":\"" +
+              (f % 2 ? "f32" : "u32") + "\",\"scale\":0.01}";
+  }
+  request(HTTP_POST, "/addSlave", "{\"id\":2,\"name\":\"meter\",\"startReg\":0,\"numRegs\":32,\"fields\":" + fields + "]}");
+  if (slaveCount != 2) {
+    fprintf(stderr, "encode: register-mapped slave rejected: %s\n", server.lastBody.c_str());
+    return;
+  }
+
+  uint16_t image[MAX_REGS_PER_SLAVE];
+  for (int i = 0; i < MAX_REGS_PER_SLAVE; i++) image[i] = 1000 + i * 37;
+  const uint32_t iterations = 20000;
+
+  struct Case { const char* map; const ModbusSlave* slave; };
+  Case cases[] = {{"default", &slaves[0]}, {"fields16", &slaves[1]}};
+  for (const Case& c : cases) {
+    const ModbusSlave& slave = *c.slave;
+    size_t bytes = 0;
+    for (uint8_t format = PAYLOAD_JSON; format <= PAYLOAD_MSGPACK; format++) {
+      double ns = nsPerOp(o, iterations, [&]() { bytes = encodeSlaveResult(slave, RTU_SUCCESS, image, format, RESULT_AGE_LIVE); });
+      addResult("encode_result", join({std::string("\"map\":\"") + c.map + "\"",
+                                       std::string("\"format\":\"") + (format ? "msgpack" : "json") + "\""}),
+                join({field("nsPerOp", ns, "%.0f"), field("bytes", bytes, "%.0f")}));
+    }
+    double ns = nsPerOp(o, iterations, [&]() { bytes = encodeSlaveReport(slave, RTU_SUCCESS, image, ~0ULL, PAYLOAD_JSON, RESULT_AGE_LIVE); });
+    addResult("encode_report", std::string("\"map\":\"") + c.map + "\",\"format\":\"json\"",
+              join({field("nsPerOp", ns, "%.0f"), field("bytes", bytes, "%.0f")}));
+  }
+
+  // A batch of 20 polls of the default slave
+  for (uint8_t format = PAYLOAD_JSON; format <= PAYLOAD_MSGPACK; format++) {
+    size_t bytes = 0;
+    double ns = nsPerOp(o, iterations / 20, [&]() {
+      beginResultBatch(format);
+      for (int i = 0; i < 20; i++) addBatchResult(slaves[0], RTU_SUCCESS, image, i * 50, RESULT_ARENA_SIZE);
+      bytes = finishResultBatch();
+    });
+    addResult("encode_batch", std::string("\"polls\":20,\"format\":\"") + (format ? "msgpack" : "json") + "\"",
+              join({field("nsPerOp", ns, "%.0f"), field("bytes", bytes, "%.0f")}));
+  }
+}
+
+// ----------------- Web -----------------
+
+static void benchRequest(const BenchOptions& o, int count, const char* name, const char* uri,
+                         const std::vector<std::pair<String, String>>& headers = {}) {
+  size_t bytes = 0;
+  int code = 0;
+  double ns = nsPerOp(o, 200, [&]() {
+    request(HTTP_GET, uri, String(), headers);
+    bytes = server.lastBody.size();
+    code = server.lastCode;
+  });
+  addResult(name, join({field("slaves", count, "%.0f")}),
+            join({field("nsPerOp", ns, "%.0f"), field("bytes", bytes, "%.0f"), field("status", code, "%.0f")}));
+}
+
+// Response generation of the main endpoints (host stand-in for the socket included)
+static void benchWeb(const BenchOptions& o) {
+  for (int count : o.slaveCounts) {
+    fprintf(stderr, "web: %d slaves\n", count);
+    configureSlaves(o, count, true);
+    runFor(2000000);  // every slave has a reading for /data
+    benchRequest(o, count, "web_root", "/");
+    benchRequest(o, count, "web_root_304", "/", {{"If-None-Match", WEB_UI_ETAG}});
+    benchRequest(o, count, "web_slaves", "/slaves");
+    benchRequest(o, count, "web_data", "/data");
+    benchRequest(o, count, "web_schedule", "/schedule");
+    benchRequest(o, count, "web_metrics", "/metrics");
+    benchRequest(o, count, "web_config", "/config");
+  }
+}
+
+// ----------------- Configuration -----------------
+
+static void benchConfig(const BenchOptions& o) {
+  int count = *std::max_element(o.slaveCounts.begin(), o.slaveCounts.end());
+  fprintf(stderr, "config: %d slaves\n", count);
+  configureSlaves(o, count, false);
+  std::string params = join({field("slaves", count, "%.0f")});
+
+  double ns = nsPerOp(o, 20, []() {
+    LittleFS.remove(JOURNAL_PATH);
+    journalSave();
+  });
+  uint32_t snapshotBytes = journalStats.bytes;
+  addResult("config_save_full", params, join({field("nsPerOp", ns, "%.0f"), field("bytes", snapshotBytes, "%.0f")}));
+
+  ns = nsPerOp(o, 20, []() { journalLoad(); });
+  addResult("config_load", params, join({field("nsPerOp", ns, "%.0f"), field("bytes", snapshotBytes, "%.0f")}));
+
+  // One edited slave per save, compactions included as they come
+  uint32_t appendedBefore = journalStats.appendedBytes, appendsBefore = journalStats.appends;
+  uint32_t edits = 0;
+  ns = nsPerOp(o, 20, [&]() {
+    slaves[edits % slaveCount].pollMs = 1000 + edits;
+    edits++;
+    journalSave();
+  });
+  uint32_t appends = journalStats.appends - appendsBefore;
+  addResult("config_save_delta", params,
+            join({field("nsPerOp", ns, "%.0f"),
+                  field("bytes", appends ? (double)(journalStats.appendedBytes - appendedBefore) / appends : 0, "%.0f")}));
+
+  // The JSON path, for comparison: export and import the same configuration
+  request(HTTP_GET, "/config");
+  String document = server.lastBody.c_str();
+  ns = nsPerOp(o, 20, [&]() { request(HTTP_POST, "/config", document); });
+  addResult("config_import_json", params,
+            join({field("nsPerOp", ns, "%.0f"), field("bytes", document.length(), "%.0f")}));
+}
+
+// ----------------- Main -----------------
+
+int main(int argc, char** argv) {
+  BenchOptions o;
+  if (!parseOptions(argc, argv, o)) {
+    fprintf(stderr, "usage: %s [--slaves 1,8,32,128,247] [--latency-us U] [--jitter-us U] [--crc-pct P]\n"
+                    "          [--timeout-pct P] [--dead N] [--baud B] [--duration-s S] [--repeat N] [--seed N]\n"
+                    "          [--only poll|encode|web|config]\n", argv[0]);
+    return 2;
+  }
+
+  // Empty flash image, so nothing from an earlier run is loaded
+  LittleFS.begin();
+  LittleFS.remove(LEGACY_CONFIG_PATH);
+  LittleFS.remove(JOURNAL_PATH);
+  LittleFS.remove(JOURNAL_TMP_PATH);
+  simBusReset(o.seed);
+  setup();
+  request(HTTP_POST, "/bus", "{\"baud\":" + String((unsigned long)o.baud) + "}");
+  if (server.lastCode != 200) {
+    fprintf(stderr, "bus settings rejected: %s\n", server.lastBody.c_str());
+    return 2;
+  }
+
+  if (o.only.empty() || o.only == "poll") benchPolling(o);
+  if (o.only.empty() || o.only == "encode") benchEncoding(o);
+  if (o.only.empty() || o.only == "web") benchWeb(o);
+  if (o.only.empty() || o.only == "config") benchConfig(o);
+
+  printf("{\"schemaVersion\":%d,\"seed\":%lu,\"repeats\":%d,\"durationS\":%lu,\"results\":[\n", BENCH_SCHEMA_VERSION,
+         (unsigned long)o.seed, o.repeats, (unsigned long)o.durationS);
+  for (size_t i = 0; i < results.size(); i++) printf("  %s%s\n", results[i].c_str(), i + 1 < results.size() ? "," : "");
+  printf("]}\n");
+  return 0;
+}
@@ -0,0 +1,198 @@
+#pragma once
+// Host stand-in for the subset of the Arduino core used by this firmware.
+// Only built in [env:native]; the device build uses the real core.
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x00
+#define OUTPUT 0x01
+
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define PGM_P const char*
+#define F(s) (s)
+#define FPSTR(p) (p)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+// Same bit layout as the ESP8266 core so saved configs stay portable
+#define SERIAL_8N1 0x1c
+#define SERIAL_8E1 0x1e
+#define SERIAL_8O1 0x1f
+#define SERIAL_8N2 0x3c
+#define SERIAL_8E2 0x3e
+#define SERIAL_8O2 0x3f
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+long random(long max);
+long random(long min, long max);
+
+class String {
+ public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v, unsigned char base = DEC) : s_(fmtSigned(v, base)) {}
+  String(unsigned int v, unsigned char base = DEC) : s_(fmtUnsigned(v, base)) {}
+  String(long v, unsigned char base = DEC) : s_(fmtSigned(v, base)) {}
+  String(unsigned long v, unsigned char base = DEC) : s_(fmtUnsigned(v, base)) {}
+  String(unsigned char v, unsigned char base = DEC) : s_(fmtUnsigned(v, base)) {}
+  String(float v, unsigned char decimals = 2) : s_(fmtFloat(v, decimals)) {}
+  String(double v, unsigned char decimals = 2) : s_(fmtFloat(v, decimals)) {}
+
+  const char* c_str() const { return s_.c_str(); }
+  unsigned int length() const { return s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  bool reserve(unsigned int n) { s_.reserve(n); return true; }
+  char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+  int indexOf(char c, unsigned int from = 0) const { size_t p = s_.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+  int indexOf(const String& s, unsigned int from = 0) const { size_t p = s_.find(s.s_, from); return p == std::string::npos ? -1 : (int)p; }
+  String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const { return from < to && from < s_.size() ? String(s_.substr(from, to - from)) : String(); }
+  bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String& p) const { return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0; }
+  bool equals(const String& o) const { return s_ == o.s_; }
+  void trim() { size_t a = s_.find_first_not_of(" \t\r\n"); size_t b = s_.find_last_not_of(" \t\r\n"); s_ = a == std::string::npos ? "" : s_.substr(a, b - a + 1); }
+  void toLowerCase() { for (auto& c : s_) c = tolower(c); }
+  bool concat(const char* s) { s_ += s; return true; }
+  bool concat(const char* s, unsigned int n) { s_.append(s, n); return true; }
+  bool concat(char c) { s_ += c; return true; }
+  bool concat(const String& s) { s_ += s.s_; return true; }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o) { s_ += o; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String& a, const char* b) { return String(a.s_ + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s_); }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const { return s_ == o; }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* o) const { return s_ != o; }
+  bool operator<(const String& o) const { return s_ < o.s_; }
+
+ private:
+  static std::string fmtUnsigned(unsigned long v, unsigned char base) {
+    char buf[40];
+    snprintf(buf, sizeof buf, base == HEX ? "%lx" : "%lu", v);
+    return buf;
+  }
+  static std::string fmtSigned(long v, unsigned char base) {
+    if (base == HEX) return fmtUnsigned((unsigned long)v, base);
+    char buf[40];
+    snprintf(buf, sizeof buf, "%ld", v);
+    return buf;
+  }
+  static std::string fmtFloat(double v, unsigned char decimals) {
+    char buf[64];
+    snprintf(buf, sizeof buf, "%.*f", decimals, v);
+    return buf;
+  }
+  std::string s_;
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t w = 0;
+    while (n--) w += write(*buf++);
+    return w;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t write(const char* s, size_t n) { return write((const uint8_t*)s, n); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = DEC) { return print(String((long)v, base)); }
+  size_t print(unsigned int v, int base = DEC) { return print(String((unsigned long)v, base)); }
+  size_t print(long v, int base = DEC) { return print(String(v, base)); }
+  size_t print(unsigned long v, int base = DEC) { return print(String(v, base)); }
+  size_t print(unsigned char v, int base = DEC) { return print(String((unsigned long)v, base)); }
+  size_t print(double v, int decimals = 2) { return print(String(v, decimals)); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(const T& v, int base) { size_t n = print(v, base); return n + println(); }
+  size_t println() { return write("\r\n"); }
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() { return -1; }
+  size_t readBytes(uint8_t* buf, size_t n) {
+    size_t r = 0;
+    int c;
+    while (r < n && (c = read()) >= 0) buf[r++] = (uint8_t)c;
+    return r;
+  }
+  size_t readBytes(char* buf, size_t n) { return readBytes((uint8_t*)buf, n); }
+  void setTimeout(unsigned long ms) { timeout_ = ms; }
+
+ protected:
+  unsigned long timeout_ = 1000;
+};
+
+// Console port. On the device Serial is also the RS485 UART, so the host
+// version counts every byte written to it to make stray logging visible.
+class HardwareSerial : public Stream {
+ public:
+  explicit HardwareSerial(int port) : port_(port) {}
+  void begin(unsigned long baud, uint8_t config = SERIAL_8N1) { baud_ = baud; config_ = config; }
+  void end() {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int availableForWrite() override { return 128; }
+  void flush() override {}
+  size_t setRxBufferSize(size_t n) { return n; }
+  unsigned long baudRate() const { return baud_; }
+  operator bool() const { return true; }
+
+  unsigned long bytesWritten = 0;
+
+ private:
+  int port_;
+  unsigned long baud_ = 0;
+  uint8_t config_ = SERIAL_8N1;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+// Host knob: echo console output to stdout (off by default so runs stay quiet)
+extern bool nativeConsoleEcho;
@@ -0,0 +1,10 @@
+#pragma once
+// Host stand-in: OTA is a no-op off the device.
+
+class ArduinoOTAClass {
+ public:
+  void begin() {}
+  void handle() {}
+};
+
+extern ArduinoOTAClass ArduinoOTA;
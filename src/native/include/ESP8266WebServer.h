@@ -0,0 +1,72 @@
+#pragma once
+// Host stand-in for ESP8266WebServer. The harness queues requests with
+// nativeRequest(); handleClient() dispatches one per call like the real one.
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <utility>
+#include "WiFiClient.h"
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+class ESP8266WebServer {
+ public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit ESP8266WebServer(int port = 80) : port_(port) {}
+  void begin() {}
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn) { routes_.push_back({uri, method, fn}); }
+  void on(const String& uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+  void onNotFound(THandlerFunction fn) { notFound_ = fn; }
+  void collectHeaders(const char* headerKeys[], size_t count) {}
+  void handleClient();
+
+  String uri() const { return current_.uri; }
+  HTTPMethod method() const { return current_.method; }
+  String arg(const String& name) const;
+  bool hasArg(const String& name) const;
+  String header(const String& name) const;
+  bool hasHeader(const String& name) const { return header(name).length() > 0; }
+  WiFiClient& client() { return client_; }
+
+  void send(int code, const char* type = nullptr, const String& content = String());
+  void send(int code, const String& type, const String& content) { send(code, type.c_str(), content); }
+  void send(int code, const char* type, const char* content, size_t len);
+  void send_P(int code, PGM_P type, PGM_P content, size_t len) { send(code, type, content, len); }
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void setContentLength(size_t len) { contentLength_ = len; }
+  void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+  void sendContent(const char* content, size_t len);
+  void sendContent_P(PGM_P content, size_t len) { sendContent(content, len); }
+
+  // Harness side
+  struct Request {
+    HTTPMethod method;
+    String uri;
+    std::vector<std::pair<String, String>> args;
+    std::vector<std::pair<String, String>> headers;
+  };
+  void nativeRequest(HTTPMethod method, const String& uri, const String& body = String(),
+                     const std::vector<std::pair<String, String>>& headers = {});
+  bool nativePending() const { return !queue_.empty(); }
+  int lastCode = 0;
+  std::string lastBody;
+  std::vector<std::pair<String, String>> lastHeaders;
+  unsigned long responseBytes = 0;
+  unsigned long requestCount = 0;
+
+ private:
+  struct Route { String uri; HTTPMethod method; THandlerFunction fn; };
+  int port_;
+  std::vector<Route> routes_;
+  THandlerFunction notFound_;
+  std::deque<Request> queue_;
+  Request current_;
+  std::vector<std::pair<String, String>> pendingHeaders_;
+  size_t contentLength_ = CONTENT_LENGTH_NOT_SET;
+  WiFiClient client_;
+};
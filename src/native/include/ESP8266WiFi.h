@@ -0,0 +1,43 @@
+#pragma once
+// Host stand-in for the ESP8266 Wi-Fi API: always "connected" unless the
+// harness says otherwise.
+#include <Arduino.h>
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } WiFiMode_t;
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4, WL_DISCONNECTED = 6 } wl_status_t;
+
+class ESP8266WiFiClass {
+ public:
+  bool mode(WiFiMode_t m) { mode_ = m; return true; }
+  wl_status_t begin(const char*, const char*) { beginCalls++; return status(); }
+  void persistent(bool) {}
+  bool setAutoReconnect(bool) { return true; }
+  bool softAP(const char*, const char*) { return true; }
+  wl_status_t status() const { return nativeLinkUp ? WL_CONNECTED : WL_DISCONNECTED; }
+  IPAddress localIP() const { return nativeLinkUp ? IPAddress(127, 0, 0, 1) : IPAddress(); }
+  IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+  int32_t RSSI() const { return -55; }
+
+  bool nativeLinkUp = true;
+  unsigned long beginCalls = 0;
+
+ private:
+  WiFiMode_t mode_ = WIFI_OFF;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+// Heap figures are reported as fixed values on the host
+class EspClass {
+ public:
+  uint32_t getFreeHeap() const { return 40000; }
+  uint32_t getMaxFreeBlockSize() const { return 32000; }
+  uint8_t getHeapFragmentation() const { return 0; }
+  uint32_t getCycleCount() const { return micros() * 80; }
+  uint32_t getChipId() const { return 0x00C0FFEE; }
+  void restart() {}
+};
+
+extern EspClass ESP;
@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FSInfo {
+  size_t totalBytes;
+  size_t usedBytes;
+  size_t blockSize;
+  size_t pageSize;
+};
+
+class File : public Stream {
+ public:
+  File() {}
+  File(FILE* f, const String& name) : f_(f, fclose), name_(name) {}
+  size_t write(uint8_t c) override { return f_ ? fwrite(&c, 1, 1, f_.get()) : 0; }
+  size_t write(const uint8_t* buf, size_t n) override { return f_ ? fwrite(buf, 1, n, f_.get()) : 0; }
+  using Print::write;
+  int available() override { return f_ ? (int)(size() - position()) : 0; }
+  int read() override { return f_ ? fgetc(f_.get()) : -1; }
+  int read(uint8_t* buf, size_t n) { return f_ ? (int)fread(buf, 1, n, f_.get()) : -1; }
+  int peek() override { if (!f_) return -1; int c = fgetc(f_.get()); if (c >= 0) ungetc(c, f_.get()); return c; }
+  void flush() override { if (f_) fflush(f_.get()); }
+  bool seek(uint32_t pos, SeekMode mode = SeekSet) { return f_ && fseek(f_.get(), pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0; }
+  size_t position() const { return f_ ? ftell(f_.get()) : 0; }
+  size_t size() const;
+  void close() { f_.reset(); }
+  const char* name() const { return name_.c_str(); }
+  operator bool() const { return (bool)f_; }
+
+ private:
+  std::shared_ptr<FILE> f_;
+  String name_;
+};
+
+class FS {
+ public:
+  bool begin();
+  void end() {}
+  File open(const char* path, const char* mode);
+  File open(const String& path, const char* mode) { return open(path.c_str(), mode); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+  bool info(FSInfo& info);
+
+  // Harness side: host directory that stands in for the flash partition
+  String nativeRoot = "native_fs";
+  unsigned long bytesWritten = 0;
+
+ private:
+  std::string hostPath(const char* path) const;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::FSInfo;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
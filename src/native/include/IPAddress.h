@@ -0,0 +1,29 @@
+#pragma once
+// Host stand-in for the core IPAddress: IPv4 only, stored in network order
+// like the device's so uint32_t conversions match.
+#include <Arduino.h>
+
+class IPAddress {
+ public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0)
+      : addr_((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+  IPAddress(uint32_t addr) : addr_(addr) {}
+  bool fromString(const char* text) {
+    unsigned a, b, c, d;
+    char tail;
+    if (sscanf(text, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4 || a > 255 || b > 255 || c > 255 || d > 255) return false;
+    *this = IPAddress(a, b, c, d);
+    return true;
+  }
+  bool isSet() const { return addr_ != 0; }
+  uint8_t operator[](int i) const { return addr_ >> (8 * i); }
+  operator uint32_t() const { return addr_; }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof buf, "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+  }
+ private:
+  uint32_t addr_;
+};
+inline size_t operator<<(Print& p, const IPAddress& ip) { return p.print(ip.toString()); }
@@ -0,0 +1,6 @@
+#pragma once
+// Host stand-in for LittleFS, backed by a directory on the build machine.
+#include <Arduino.h>
+#include <FS.h>
+
+extern fs::FS LittleFS;
@@ -0,0 +1,60 @@
+#pragma once
+// Host stand-in for PubSubClient. Publishes are counted and the last payload
+// kept so the harness can inspect it; the broker is "up" unless told otherwise.
+// connect() drives its socket call for call as PubSubClient 2.8 does (the
+// version platformio.ini pins), so the CONNACK replay in MqttSocket runs
+// against the same sequence on the host.
+#include <Arduino.h>
+#include <functional>
+#include "WiFiClient.h"
+
+#define MQTT_MAX_PACKET_SIZE 256
+#define MQTT_KEEPALIVE 15
+#define MQTT_CONNECTED 0
+#define MQTT_CONNECTION_TIMEOUT -4
+
+class PubSubClient : public Print {
+ public:
+  typedef std::function<void(char*, uint8_t*, unsigned int)> Callback;
+
+  explicit PubSubClient(WiFiClient& client) : client_(&client) {}
+  PubSubClient& setServer(const char*, uint16_t) { return *this; }
+  PubSubClient& setCallback(Callback cb) { callback_ = cb; return *this; }
+  bool setBufferSize(uint16_t size) { bufferSize_ = size; return true; }
+  uint16_t getBufferSize() const { return bufferSize_; }
+
+  bool connect(const char* id);
+  bool connected() { if (!nativeBrokerUp) connected_ = false; return connected_; }
+  void disconnect() { connected_ = false; }
+  int state() const { return connected_ ? MQTT_CONNECTED : MQTT_CONNECTION_TIMEOUT; }
+  bool loop() { return connected(); }
+  bool subscribe(const char*) { return connected_; }
+  bool unsubscribe(const char*) { return connected_; }
+
+  bool publish(const char* topic, const char* payload, bool retained = false) {
+    return publish(topic, (const uint8_t*)payload, strlen(payload), retained);
+  }
+  bool publish(const char* topic, const uint8_t* payload, unsigned int len, bool retained = false);
+  bool beginPublish(const char* topic, unsigned int len, bool retained);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  int endPublish();
+
+  // Harness side
+  void nativeDeliver(const char* topic, const uint8_t* payload, unsigned int len);
+  bool nativeBrokerUp = true;
+  unsigned long publishCount = 0;
+  unsigned long publishBytes = 0;
+  unsigned long droppedCount = 0;
+  unsigned long blockingWaits = 0;   // connect() found no CONNACK and would have spun for it
+  std::string lastTopic;
+  std::string lastPayload;
+
+ private:
+  WiFiClient* client_;
+  bool connected_ = false;
+  uint16_t bufferSize_ = MQTT_MAX_PACKET_SIZE;
+  unsigned int streamExpected_ = 0;
+  Callback callback_;
+};
@@ -0,0 +1,69 @@
+#pragma once
+// Host stand-in for a TCP client. As on the device, copies are handles to the
+// same connection. Written bytes are counted, and kept for the harness on
+// sockets it opened through WiFiServer::nativeConnect(); an MQTT CONNECT
+// written to it is answered with an accepting CONNACK.
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include "IPAddress.h"
+
+struct NativeSocket {
+  bool connected = true;
+  bool fresh = false;        // nothing written since connect()
+  bool keepTx = false;
+  std::string rx;            // harness -> program
+  std::string tx;            // program -> harness, with keepTx
+  unsigned long bytesWritten = 0;
+};
+
+class WiFiClient : public Stream {
+ public:
+  WiFiClient() : s_(std::make_shared<NativeSocket>()) {}
+  explicit WiFiClient(std::shared_ptr<NativeSocket> socket) : s_(socket) {}
+  virtual ~WiFiClient() {}
+  int connect(IPAddress, uint16_t) { return connect(); }
+  int connect(const char*, uint16_t) { return connect(); }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    if (n && s_->fresh && buf[0] == 0x10) s_->rx.append("\x20\x02\x00\x00", 4);
+    s_->fresh = false;
+    if (s_->keepTx) s_->tx.append((const char*)buf, n);
+    s_->bytesWritten += n;
+    return n;
+  }
+  using Print::write;
+  int available() override { return s_->rx.size(); }
+  int read() override {
+    if (s_->rx.empty()) return -1;
+    uint8_t c = s_->rx[0];
+    s_->rx.erase(0, 1);
+    return c;
+  }
+  int read(uint8_t* buf, size_t n) {
+    n = std::min(n, s_->rx.size());
+    memcpy(buf, s_->rx.data(), n);
+    s_->rx.erase(0, n);
+    return n;
+  }
+  int peek() override { return s_->rx.empty() ? -1 : (uint8_t)s_->rx[0]; }
+  int availableForWrite() override { return 1460; }
+  uint8_t connected() { return s_->connected || !s_->rx.empty(); }
+  void stop() {
+    s_->connected = false;
+    s_->rx.clear();
+  }
+  void setNoDelay(bool) {}
+  operator bool() { return s_->connected; }
+
+  // Harness side
+  std::shared_ptr<NativeSocket> nativeSocket() const { return s_; }
+
+ private:
+  int connect() {
+    s_ = std::make_shared<NativeSocket>();
+    s_->fresh = true;
+    return 1;
+  }
+  std::shared_ptr<NativeSocket> s_;
+};
@@ -0,0 +1,37 @@
+#pragma once
+// Host stand-in for a listening TCP socket. The harness opens connections
+// with nativeConnect() and talks through the NativeSocket it gets back.
+#include <Arduino.h>
+#include <deque>
+#include "WiFiClient.h"
+
+class WiFiServer {
+ public:
+  explicit WiFiServer(uint16_t port) : port_(port) {}
+  void begin() {}
+  void setNoDelay(bool) {}
+  bool hasClient() const { return !pending_.empty(); }
+  WiFiClient accept() {
+    if (pending_.empty()) return closed();
+    WiFiClient client(pending_.front());
+    pending_.pop_front();
+    return client;
+  }
+
+  // Harness side
+  std::shared_ptr<NativeSocket> nativeConnect() {
+    auto socket = std::make_shared<NativeSocket>();
+    socket->keepTx = true;
+    pending_.push_back(socket);
+    return socket;
+  }
+
+ private:
+  static WiFiClient closed() {
+    auto socket = std::make_shared<NativeSocket>();
+    socket->connected = false;
+    return WiFiClient(socket);
+  }
+  uint16_t port_;
+  std::deque<std::shared_ptr<NativeSocket>> pending_;
+};
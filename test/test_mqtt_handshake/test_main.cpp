@@ -0,0 +1,74 @@
+// Host tests for the non-blocking MQTT reconnect; run with `pio test -e native`.
+// The stand-in PubSubClient drives its socket as PubSubClient 2.8 does, so
+// these cover the CONNACK replay that MqttSocket feeds into connect().
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "native/NativeClock.h"
+#include "MQTTHandler.h"
+#include "WebServerHandler.h"
+#include "ConfigJournal.h"
+#include "OfflineQueue.h"
+
+void setup();
+void loop();
+
+// One CONNECT, as MQTTHandler builds it
+#define CONNECT_BYTES (14 + strlen(MQTT_CLIENT_ID))
+
+// Run loop() in 1 ms steps until the client's state is `up`
+static bool runUntil(bool up, uint32_t maxMs) {
+  for (uint32_t ms = 0; ms < maxMs; ms++) {
+    if (mqttClient.connected() == up) return true;
+    loop();
+    nativeClockAdvance(1000);
+  }
+  return mqttClient.connected() == up;
+}
+
+void test_connects_with_replayed_connack() {
+  TEST_ASSERT_TRUE(runUntil(true, 1000));
+  TEST_ASSERT_EQUAL_UINT32(0, mqttClient.blockingWaits);
+  // PubSubClient's own CONNECT was swallowed: only ours reached the broker
+  TEST_ASSERT_EQUAL_UINT32(CONNECT_BYTES, espClient.nativeSocket()->bytesWritten);
+  TEST_ASSERT_EQUAL_INT(0, espClient.available());
+}
+
+void test_reconnects_on_a_new_socket() {
+  TEST_ASSERT_TRUE(runUntil(true, 1000));
+  mqttClient.nativeBrokerUp = false;
+  TEST_ASSERT_TRUE(runUntil(false, 1000));
+  mqttClient.nativeBrokerUp = true;
+  TEST_ASSERT_TRUE(runUntil(true, MQTT_RETRY_MAX_MS + 1000));
+  TEST_ASSERT_EQUAL_UINT32(0, mqttClient.blockingWaits);
+  TEST_ASSERT_EQUAL_UINT32(CONNECT_BYTES, espClient.nativeSocket()->bytesWritten);
+}
+
+// Without Wi-Fi nothing is attempted, and loop() keeps its pace
+void test_no_attempt_without_wifi() {
+  mqttClient.nativeBrokerUp = false;
+  TEST_ASSERT_TRUE(runUntil(false, 1000));
+  WiFi.nativeLinkUp = false;
+  mqttClient.nativeBrokerUp = true;
+  TEST_ASSERT_FALSE(runUntil(true, 2000));
+  WiFi.nativeLinkUp = true;
+  TEST_ASSERT_TRUE(runUntil(true, MQTT_RETRY_MAX_MS + 1000));
+  TEST_ASSERT_EQUAL_UINT32(0, mqttClient.blockingWaits);
+}
+
+int main(int argc, char** argv) {
+  // Start from an empty flash image, as NativeMain does
+  LittleFS.begin();
+  LittleFS.remove(LEGACY_CONFIG_PATH);
+  LittleFS.remove(JOURNAL_PATH);
+  LittleFS.remove(JOURNAL_TMP_PATH);
+  queueClear();
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_connects_with_replayed_connack);
+  RUN_TEST(test_reconnects_on_a_new_socket);
+  RUN_TEST(test_no_attempt_without_wifi);
+  return UNITY_END();
+}
@@ -0,0 +1,106 @@
+// Host tests for the slave configuration path; run with `pio test -e native`.
+// They drive the real setup()/loop() through the stand-in web server, the
+// same way the NativeMain harness configures the gateway.
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "native/NativeClock.h"
+#include "ModBusHandler.h"
+#include "WebServerHandler.h"
+#include "ConfigJournal.h"
+#include "OfflineQueue.h"
+#include "ReadPlanner.h"
+#include "SlaveTable.h"
+
+void setup();
+void loop();
+
+// Queue one request and run loop() until the web task has answered it
+static int post(const char* uri, const String& body) {
+  server.nativeRequest(HTTP_POST, uri, body);
+  for (int i = 0; i < 100 && server.nativePending(); i++) {
+    loop();
+    nativeClockAdvance(1000);
+  }
+  return server.lastCode;
+}
+
+static void expectRejected(const char* body) {
+  uint8_t before = slaveCount;
+  TEST_ASSERT_EQUAL_INT_MESSAGE(400, post("/addSlave", body), body);
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(before, slaveCount, body);
+}
+
+void test_rejects_wrapping_numRegs() {
+  // 65500 + 100 wraps a 16-bit sum to 64
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":65500,\"ranges\":[[0,100]],\"pollMs\":500}");
+  // 70000 truncates to 4464 when stored in 16 bits
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":70000,\"pollMs\":500}");
+}
+
+void test_rejects_wrapping_ranges() {
+  // 2 + 65535 + 3 wraps to 4
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":2,\"ranges\":[[0,65535],[0,3]],\"pollMs\":500}");
+}
+
+void test_rejects_bad_ranges() {
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":0,\"pollMs\":500}");
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":126,\"pollMs\":500}");
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":65530,\"numRegs\":10,\"pollMs\":500}");
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":-1,\"numRegs\":2,\"pollMs\":500}");
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":2,\"ranges\":[[100,0]],\"pollMs\":500}");
+  expectRejected("{\"id\":1,\"name\":\"x\",\"startReg\":0,\"numRegs\":40,\"ranges\":[[100,25]],\"pollMs\":500}");
+}
+
+void test_accepts_full_image() {
+  uint8_t before = slaveCount;
+  TEST_ASSERT_EQUAL_INT(200, post("/addSlave", "{\"id\":2,\"name\":\"full\",\"startReg\":0,\"numRegs\":2,"
+                                               "\"ranges\":[[100,62]],\"pollMs\":500}"));
+  TEST_ASSERT_EQUAL_UINT8(before + 1, slaveCount);
+}
+
+// A slave that never went through validation still can't overrun its image
+void test_copy_stays_in_image() {
+  ModbusSlave slave;
+  slave.startReg = 0;
+  slave.numRegs = MODBUS_MAX_READ_REGS;
+  slave.extraRangeCount = 0;
+  TEST_ASSERT_FALSE(slaveRangesValid(slave));
+
+  uint16_t image[MAX_REGS_PER_SLAVE + 1];
+  image[MAX_REGS_PER_SLAVE] = 0xBEEF;
+  ReadBlock block = {0, MODBUS_MAX_READ_REGS};
+  copyBlockToImage(slave, block, image);
+  TEST_ASSERT_EQUAL_HEX16(0xBEEF, image[MAX_REGS_PER_SLAVE]);
+}
+
+// Runtime state sits beside the table and has to follow a swap-remove
+void test_delete_moves_runtime_state() {
+  TEST_ASSERT_EQUAL_INT(200, post("/addSlave", "{\"id\":10,\"name\":\"a\",\"startReg\":0,\"numRegs\":2}"));
+  TEST_ASSERT_EQUAL_INT(200, post("/addSlave", "{\"id\":11,\"name\":\"b\",\"startReg\":0,\"numRegs\":2}"));
+  slaveSchedule(*findSlaveById(11)).pollCount = 1234;
+  slaveLastReading(*findSlaveById(11)).time = 5678;
+  TEST_ASSERT_TRUE(removeSlave(10));
+  TEST_ASSERT_EQUAL_UINT32(1234, slaveSchedule(*findSlaveById(11)).pollCount);
+  TEST_ASSERT_EQUAL_UINT32(5678, slaveLastReading(*findSlaveById(11)).time);
+  TEST_ASSERT_EQUAL_UINT32(0, slaveSchedule(slaves[slaveCount]).pollCount);
+}
+
+int main(int argc, char** argv) {
+  // Start from an empty flash image, as NativeMain does
+  LittleFS.begin();
+  LittleFS.remove(LEGACY_CONFIG_PATH);
+  LittleFS.remove(JOURNAL_PATH);
+  LittleFS.remove(JOURNAL_TMP_PATH);
+  queueClear();
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_rejects_wrapping_numRegs);
+  RUN_TEST(test_rejects_wrapping_ranges);
+  RUN_TEST(test_rejects_bad_ranges);
+  RUN_TEST(test_accepts_full_image);
+  RUN_TEST(test_copy_stays_in_image);
+  RUN_TEST(test_delete_moves_runtime_state);
+  return UNITY_END();
+}
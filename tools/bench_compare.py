@@ -0,0 +1,57 @@
+# Compares two result files of the benchmark suite ([env:bench]) and exits
+# non-zero if any metric got worse by more than the threshold:
+#   python tools/bench_compare.py baseline.json bench.json [--threshold 10]
+# Poll metrics come from the virtual clock and are exact; nsPerOp is host
+# time, so compare runs from the same machine only.
+import argparse
+import json
+import sys
+
+HIGHER_IS_BETTER = {"pollsPerSec", "cyclesPerSec", "busWirePct", "replyPct"}
+INFORMATIONAL = {"busHeldPct", "status"}
+
+
+def load(path):
+    with open(path) as f:
+        doc = json.load(f)
+    results = {}
+    for r in doc["results"]:
+        key = r["name"] + " " + " ".join("%s=%s" % kv for kv in sorted(r["params"].items()))
+        results[key] = r["metrics"]
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed change in percent")
+    args = parser.parse_args()
+
+    old, new = load(args.baseline), load(args.candidate)
+    regressions = 0
+    for key in sorted(old.keys() & new.keys()):
+        for metric, before in old[key].items():
+            after = new[key].get(metric)
+            if after is None or metric in INFORMATIONAL:
+                continue
+            if before == 0:
+                change = 0.0 if after == 0 else 100.0
+            else:
+                change = 100.0 * (after - before) / abs(before)
+            worse = -change if metric in HIGHER_IS_BETTER else change
+            flag = ""
+            if worse > args.threshold:
+                flag = "  REGRESSION"
+                regressions += 1
+            elif worse < -args.threshold:
+                flag = "  improved"
+            print("%-48s %-14s %14g -> %-14g %+7.1f%%%s" % (key, metric, before, after, change, flag))
+    for key in sorted(old.keys() - new.keys()):
+        print("%-48s missing from %s" % (key, args.candidate))
+    print("%d regression(s) over %.0f%%" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
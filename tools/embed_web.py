@@ -0,0 +1,51 @@
+# Gzips web/index.html into src/WebUi.h as a PROGMEM array, with an ETag
+# derived from the compressed bytes. Runs before every PlatformIO build
+# (extra_scripts = pre:tools/embed_web.py) and only rewrites the header when
+# the page changed; can also be run by hand: python tools/embed_web.py
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(ROOT, "web", "index.html")
+TARGET = os.path.join(ROOT, "src", "WebUi.h")
+
+
+def render(page):
+    # mtime=0 keeps the output (and the ETag) identical across builds
+    blob = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(blob).hexdigest()[:16]
+    lines = [
+        "#pragma once",
+        "// Generated from web/index.html by tools/embed_web.py - do not edit.",
+        "#include <Arduino.h>",
+        "",
+        '#define WEB_UI_ETAG "\\"%s\\""' % etag,
+        "#define WEB_UI_GZ_LEN %d  // %d bytes uncompressed" % (len(blob), len(page)),
+        "",
+        "static const uint8_t WEB_UI_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(blob), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    with open(SOURCE, "rb") as f:
+        header = render(f.read())
+    if os.path.exists(TARGET):
+        with open(TARGET) as f:
+            if f.read() == header:
+                return
+    with open(TARGET, "w") as f:
+        f.write(header)
+    print("embed_web: regenerated src/WebUi.h")
+
+
+main()